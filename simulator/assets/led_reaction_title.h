@@ -0,0 +1,69 @@
+// Generated by host/rle_convert.cpp from assets/src/led_reaction_title.png - do not edit.
+// 203x51, 4 colours, 862 bytes (raw RGB565: 20706 bytes)
+#ifndef ASSET_LED_REACTION_TITLE_H_
+#define ASSET_LED_REACTION_TITLE_H_
+
+#include "../rle_image.h"
+
+static const uint16_t ledReactionTitlePalette[] PROGMEM = { 0xFFFF, 0x0000, 0x7800, 0xC618 };
+
+static const uint8_t ledReactionTitleData[] PROGMEM = {
+  0x06, 0x1F, 0xAA, 0x01, 0x0E, 0x11, 0x2F, 0xAA, 0x01, 0x11, 0x0B, 0x10, 0x2F, 0xAE, 0x01, 0x10,
+  0x09, 0x10, 0x2F, 0xB0, 0x01, 0x10, 0x07, 0x10, 0x2F, 0xB2, 0x01, 0x10, 0x05, 0x10, 0x2F, 0xB4,
+  0x01, 0x10, 0x04, 0x10, 0x2F, 0xB4, 0x01, 0x10, 0x30, 0x02, 0x10, 0x2F, 0xB6, 0x01, 0x10, 0x30,
+  0x01, 0x10, 0x2F, 0xB6, 0x01, 0x10, 0x31, 0x00, 0x10, 0x2F, 0xB6, 0x01, 0x10, 0x31, 0x00, 0x10,
+  0x2F, 0xB6, 0x01, 0x10, 0x32, 0x10, 0x2F, 0xB6, 0x01, 0x10, 0x32, 0x10, 0x2F, 0xB6, 0x01, 0x10,
+  0x32, 0x10, 0x2F, 0xB6, 0x01, 0x10, 0x32, 0x10, 0x2F, 0xB6, 0x01, 0x10, 0x32, 0x10, 0x2F, 0xB6,
+  0x01, 0x10, 0x32, 0x10, 0x2F, 0xB6, 0x01, 0x10, 0x32, 0x10, 0x2F, 0x0B, 0x01, 0x2F, 0x0E, 0x01,
+  0x2D, 0x07, 0x2F, 0x1C, 0x01, 0x29, 0x01, 0x2F, 0x29, 0x10, 0x32, 0x10, 0x2F, 0x0B, 0x01, 0x10,
+  0x2F, 0x0D, 0x01, 0x10, 0x2C, 0x07, 0x10, 0x2F, 0x1B, 0x01, 0x10, 0x28, 0x01, 0x10, 0x2F, 0x28,
+  0x10, 0x32, 0x10, 0x2F, 0x0B, 0x01, 0x10, 0x2F, 0x0D, 0x01, 0x10, 0x2C, 0x01, 0x15, 0x01, 0x2F,
+  0x1A, 0x01, 0x10, 0x29, 0x11, 0x2F, 0x28, 0x10, 0x32, 0x10, 0x2F, 0x0B, 0x01, 0x10, 0x2F, 0x0D,
+  0x01, 0x10, 0x2C, 0x01, 0x10, 0x24, 0x01, 0x10, 0x2F, 0x19, 0x01, 0x10, 0x2F, 0x34, 0x10, 0x32,
+  0x10, 0x2F, 0x0B, 0x01, 0x10, 0x2A, 0x05, 0x25, 0x03, 0x21, 0x01, 0x10, 0x2C, 0x01, 0x10, 0x24,
+  0x01, 0x10, 0x22, 0x05, 0x25, 0x03, 0x27, 0x05, 0x23, 0x09, 0x23, 0x03, 0x27, 0x05, 0x23, 0x01,
+  0x21, 0x03, 0x2F, 0x0F, 0x10, 0x32, 0x10, 0x2F, 0x0B, 0x01, 0x10, 0x2A, 0x05, 0x10, 0x24, 0x03,
+  0x10, 0x20, 0x01, 0x10, 0x2C, 0x01, 0x10, 0x24, 0x01, 0x10, 0x22, 0x05, 0x10, 0x24, 0x03, 0x10,
+  0x26, 0x05, 0x10, 0x22, 0x09, 0x10, 0x22, 0x03, 0x10, 0x26, 0x05, 0x10, 0x22, 0x01, 0x10, 0x20,
+  0x03, 0x10, 0x2F, 0x0E, 0x10, 0x32, 0x10, 0x2F, 0x0B, 0x01, 0x10, 0x28, 0x01, 0x20, 0x14, 0x01,
+  0x21, 0x01, 0x20, 0x12, 0x03, 0x10, 0x2C, 0x07, 0x20, 0x11, 0x20, 0x01, 0x20, 0x14, 0x01, 0x24,
+  0x12, 0x01, 0x23, 0x01, 0x20, 0x14, 0x01, 0x22, 0x12, 0x01, 0x14, 0x23, 0x10, 0x01, 0x10, 0x24,
+  0x01, 0x20, 0x14, 0x01, 0x21, 0x03, 0x20, 0x12, 0x01, 0x2F, 0x0D, 0x10, 0x32, 0x10, 0x2F, 0x0B,
+  0x01, 0x10, 0x28, 0x01, 0x10, 0x24, 0x01, 0x10, 0x20, 0x01, 0x10, 0x22, 0x03, 0x10, 0x2C, 0x07,
+  0x10, 0x22, 0x01, 0x10, 0x24, 0x01, 0x10, 0x26, 0x01, 0x10, 0x22, 0x01, 0x10, 0x24, 0x01, 0x10,
+  0x24, 0x01, 0x10, 0x28, 0x01, 0x10, 0x24, 0x01, 0x10, 0x24, 0x01, 0x10, 0x20, 0x03, 0x10, 0x22,
+  0x01, 0x10, 0x2F, 0x0C, 0x10, 0x32, 0x10, 0x2F, 0x0B, 0x01, 0x10, 0x28, 0x09, 0x10, 0x20, 0x01,
+  0x10, 0x23, 0x10, 0x01, 0x10, 0x2C, 0x01, 0x11, 0x01, 0x12, 0x22, 0x09, 0x10, 0x22, 0x05, 0x10,
+  0x22, 0x01, 0x10, 0x25, 0x11, 0x24, 0x01, 0x10, 0x28, 0x01, 0x10, 0x24, 0x01, 0x10, 0x24, 0x01,
+  0x10, 0x20, 0x01, 0x12, 0x22, 0x01, 0x10, 0x2F, 0x0C, 0x10, 0x32, 0x10, 0x2F, 0x0B, 0x01, 0x10,
+  0x28, 0x09, 0x10, 0x20, 0x01, 0x10, 0x24, 0x01, 0x10, 0x2C, 0x01, 0x10, 0x20, 0x01, 0x10, 0x24,
+  0x09, 0x10, 0x22, 0x05, 0x10, 0x22, 0x01, 0x10, 0x2C, 0x01, 0x10, 0x28, 0x01, 0x10, 0x24, 0x01,
+  0x10, 0x24, 0x01, 0x10, 0x20, 0x01, 0x10, 0x24, 0x01, 0x10, 0x2F, 0x0C, 0x10, 0x32, 0x10, 0x2F,
+  0x0B, 0x01, 0x10, 0x28, 0x01, 0x18, 0x20, 0x01, 0x10, 0x22, 0x03, 0x10, 0x2C, 0x01, 0x10, 0x21,
+  0x10, 0x01, 0x23, 0x01, 0x18, 0x20, 0x01, 0x20, 0x12, 0x01, 0x10, 0x22, 0x01, 0x10, 0x24, 0x01,
+  0x25, 0x01, 0x10, 0x20, 0x01, 0x25, 0x01, 0x10, 0x24, 0x01, 0x10, 0x24, 0x01, 0x10, 0x20, 0x01,
+  0x10, 0x24, 0x01, 0x10, 0x2F, 0x0C, 0x10, 0x32, 0x10, 0x2F, 0x0B, 0x01, 0x10, 0x28, 0x01, 0x10,
+  0x28, 0x01, 0x10, 0x22, 0x03, 0x10, 0x2C, 0x01, 0x10, 0x22, 0x01, 0x10, 0x22, 0x01, 0x10, 0x28,
+  0x01, 0x10, 0x22, 0x01, 0x10, 0x22, 0x01, 0x10, 0x24, 0x01, 0x10, 0x24, 0x01, 0x10, 0x20, 0x01,
+  0x10, 0x24, 0x01, 0x10, 0x24, 0x01, 0x10, 0x24, 0x01, 0x10, 0x20, 0x01, 0x10, 0x24, 0x01, 0x10,
+  0x2F, 0x0C, 0x10, 0x32, 0x10, 0x2F, 0x0B, 0x09, 0x22, 0x10, 0x05, 0x24, 0x10, 0x03, 0x20, 0x10,
+  0x01, 0x10, 0x2C, 0x01, 0x10, 0x23, 0x10, 0x01, 0x22, 0x10, 0x05, 0x24, 0x10, 0x07, 0x22, 0x10,
+  0x05, 0x20, 0x11, 0x25, 0x10, 0x01, 0x20, 0x11, 0x22, 0x05, 0x24, 0x10, 0x05, 0x20, 0x11, 0x20,
+  0x01, 0x10, 0x24, 0x01, 0x10, 0x2F, 0x0C, 0x10, 0x32, 0x10, 0x2F, 0x0B, 0x09, 0x10, 0x22, 0x05,
+  0x10, 0x24, 0x03, 0x10, 0x20, 0x01, 0x10, 0x2C, 0x01, 0x10, 0x24, 0x01, 0x10, 0x22, 0x05, 0x10,
+  0x24, 0x07, 0x10, 0x22, 0x05, 0x10, 0x28, 0x01, 0x10, 0x24, 0x05, 0x10, 0x24, 0x05, 0x10, 0x22,
+  0x01, 0x10, 0x24, 0x01, 0x10, 0x2F, 0x0C, 0x10, 0x32, 0x10, 0x2F, 0x0C, 0x19, 0x23, 0x15, 0x25,
+  0x13, 0x21, 0x11, 0x2D, 0x11, 0x25, 0x11, 0x23, 0x15, 0x25, 0x17, 0x23, 0x15, 0x29, 0x11, 0x25,
+  0x15, 0x25, 0x15, 0x23, 0x11, 0x25, 0x11, 0x2F, 0x0C, 0x10, 0x32, 0x10, 0x2F, 0xB6, 0x01, 0x10,
+  0x32, 0x10, 0x2F, 0xB6, 0x01, 0x10, 0x32, 0x10, 0x2F, 0xB6, 0x01, 0x10, 0x32, 0x10, 0x2F, 0xB6,
+  0x01, 0x10, 0x32, 0x10, 0x2F, 0xB6, 0x01, 0x10, 0x32, 0x10, 0x2F, 0xB6, 0x01, 0x10, 0x32, 0x10,
+  0x2F, 0xB6, 0x01, 0x10, 0x32, 0x10, 0x2F, 0xB6, 0x01, 0x10, 0x32, 0x10, 0x2F, 0xB6, 0x01, 0x10,
+  0x32, 0x00, 0x10, 0x2F, 0xB4, 0x01, 0x10, 0x33, 0x00, 0x10, 0x2F, 0xB4, 0x01, 0x10, 0x33, 0x01,
+  0x10, 0x2F, 0xB2, 0x01, 0x10, 0x34, 0x02, 0x10, 0x2F, 0xB0, 0x01, 0x10, 0x34, 0x04, 0x10, 0x2F,
+  0xAE, 0x01, 0x10, 0x35, 0x05, 0x11, 0x2F, 0xAA, 0x01, 0x11, 0x35, 0x07, 0x30, 0x1F, 0xAA, 0x01,
+  0x36, 0x09, 0x3F, 0xB0, 0x01, 0x0B, 0x3F, 0xAE, 0x01, 0x0E, 0x3F, 0xAA, 0x01, 0x06,
+};
+
+static const RleImage ledReactionTitleImage = { 203, 51, 4, ledReactionTitlePalette, ledReactionTitleData, sizeof(ledReactionTitleData) };
+
+#endif  // ASSET_LED_REACTION_TITLE_H_
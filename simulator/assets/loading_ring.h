@@ -0,0 +1,44 @@
+// Generated by host/rle_convert.cpp from assets/src/loading_ring.png - do not edit.
+// 81x81, 9 colours, 450 bytes (raw RGB565: 13122 bytes)
+#ifndef ASSET_LOADING_RING_H_
+#define ASSET_LOADING_RING_H_
+
+#include "../rle_image.h"
+
+static const uint16_t loadingRingPalette[] PROGMEM = { 0xFFFF, 0x0841, 0xDEFB, 0xBDF7, 0x2945, 0xA514, 0x4228, 0x8410, 0x632C };
+
+static const uint8_t loadingRingData[] PROGMEM = {
+  0x0F, 0x12, 0x10, 0x04, 0x26, 0x0F, 0x30, 0x14, 0x04, 0x2A, 0x0F, 0x28, 0x18, 0x04, 0x2E, 0x0F,
+  0x22, 0x1A, 0x04, 0x2F, 0x01, 0x0F, 0x1E, 0x1C, 0x04, 0x2F, 0x03, 0x0F, 0x1A, 0x1F, 0x00, 0x03,
+  0x2F, 0x05, 0x0F, 0x16, 0x1F, 0x02, 0x03, 0x2F, 0x07, 0x0F, 0x13, 0x1F, 0x03, 0x03, 0x2F, 0x08,
+  0x0F, 0x11, 0x1F, 0x04, 0x03, 0x2F, 0x09, 0x0F, 0x0E, 0x1F, 0x05, 0x0A, 0x2F, 0x02, 0x0F, 0x0E,
+  0x1F, 0x02, 0x0F, 0x03, 0x2C, 0x0F, 0x0E, 0x1F, 0x00, 0x0F, 0x09, 0x28, 0x0F, 0x0F, 0x1D, 0x0F,
+  0x0D, 0x26, 0x05, 0x31, 0x0F, 0x08, 0x1A, 0x0F, 0x11, 0x23, 0x05, 0x33, 0x0F, 0x08, 0x18, 0x0F,
+  0x13, 0x21, 0x05, 0x35, 0x0F, 0x08, 0x15, 0x0F, 0x1C, 0x36, 0x0F, 0x01, 0x40, 0x06, 0x13, 0x0F,
+  0x1C, 0x38, 0x0E, 0x42, 0x06, 0x11, 0x0F, 0x1C, 0x3A, 0x0C, 0x44, 0x0F, 0x24, 0x3B, 0x0B, 0x46,
+  0x0F, 0x23, 0x3A, 0x0A, 0x48, 0x0F, 0x23, 0x3A, 0x09, 0x49, 0x0F, 0x23, 0x39, 0x08, 0x4A, 0x0F,
+  0x23, 0x3A, 0x07, 0x49, 0x0F, 0x25, 0x39, 0x06, 0x49, 0x0F, 0x27, 0x39, 0x05, 0x49, 0x0F, 0x27,
+  0x39, 0x04, 0x49, 0x0F, 0x29, 0x39, 0x03, 0x49, 0x0F, 0x29, 0x39, 0x03, 0x48, 0x0F, 0x2B, 0x38,
+  0x03, 0x48, 0x0F, 0x2B, 0x38, 0x02, 0x49, 0x0F, 0x2B, 0x39, 0x01, 0x48, 0x0F, 0x2D, 0x38, 0x01,
+  0x48, 0x0F, 0x2D, 0x38, 0x01, 0x48, 0x0F, 0x2D, 0x38, 0x00, 0x49, 0x0F, 0x2D, 0x39, 0x48, 0x0F,
+  0x2F, 0x33, 0x04, 0x48, 0x0F, 0x38, 0x48, 0x0F, 0x38, 0x48, 0x0F, 0x38, 0x48, 0x0F, 0x38, 0x48,
+  0x0F, 0x2F, 0x58, 0x0F, 0x38, 0x58, 0x0F, 0x38, 0x58, 0x0F, 0x38, 0x58, 0x0F, 0x38, 0x58, 0x04,
+  0x63, 0x0F, 0x2F, 0x58, 0x69, 0x0F, 0x2D, 0x59, 0x00, 0x68, 0x0F, 0x2D, 0x58, 0x01, 0x68, 0x0F,
+  0x2D, 0x58, 0x01, 0x68, 0x0F, 0x2D, 0x58, 0x01, 0x69, 0x0F, 0x2B, 0x59, 0x02, 0x68, 0x0F, 0x2B,
+  0x58, 0x03, 0x68, 0x0F, 0x2B, 0x58, 0x03, 0x69, 0x0F, 0x29, 0x59, 0x03, 0x69, 0x0F, 0x29, 0x59,
+  0x04, 0x69, 0x0F, 0x27, 0x59, 0x05, 0x69, 0x0F, 0x27, 0x59, 0x06, 0x69, 0x0F, 0x25, 0x59, 0x07,
+  0x6A, 0x0F, 0x23, 0x5A, 0x08, 0x69, 0x0F, 0x23, 0x59, 0x09, 0x6A, 0x0F, 0x23, 0x58, 0x0A, 0x6A,
+  0x0F, 0x23, 0x56, 0x0B, 0x6B, 0x0F, 0x24, 0x54, 0x0C, 0x6A, 0x0F, 0x1C, 0x71, 0x06, 0x52, 0x0E,
+  0x68, 0x0F, 0x1C, 0x73, 0x06, 0x50, 0x0F, 0x01, 0x66, 0x0F, 0x1C, 0x75, 0x0F, 0x08, 0x65, 0x05,
+  0x81, 0x0F, 0x13, 0x78, 0x0F, 0x08, 0x63, 0x05, 0x83, 0x0F, 0x11, 0x7A, 0x0F, 0x08, 0x61, 0x05,
+  0x86, 0x0F, 0x0D, 0x7D, 0x0F, 0x0F, 0x88, 0x0F, 0x09, 0x7F, 0x00, 0x0F, 0x0E, 0x8C, 0x0F, 0x03,
+  0x7F, 0x02, 0x0F, 0x0E, 0x8F, 0x02, 0x0A, 0x7F, 0x05, 0x0F, 0x0E, 0x8F, 0x09, 0x03, 0x7F, 0x04,
+  0x0F, 0x11, 0x8F, 0x08, 0x03, 0x7F, 0x03, 0x0F, 0x13, 0x8F, 0x07, 0x03, 0x7F, 0x02, 0x0F, 0x16,
+  0x8F, 0x05, 0x03, 0x7F, 0x00, 0x0F, 0x1A, 0x8F, 0x03, 0x04, 0x7C, 0x0F, 0x1E, 0x8F, 0x01, 0x04,
+  0x7A, 0x0F, 0x22, 0x8E, 0x04, 0x78, 0x0F, 0x28, 0x8A, 0x04, 0x74, 0x0F, 0x30, 0x86, 0x04, 0x70,
+  0x0F, 0x12,
+};
+
+static const RleImage loadingRingImage = { 81, 81, 9, loadingRingPalette, loadingRingData, sizeof(loadingRingData) };
+
+#endif  // ASSET_LOADING_RING_H_
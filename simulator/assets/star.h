@@ -0,0 +1,21 @@
+// Generated by host/rle_convert.cpp from assets/src/star.png - do not edit.
+// 20x20, 4 colours, 81 bytes (raw RGB565: 800 bytes)
+#ifndef ASSET_STAR_H_
+#define ASSET_STAR_H_
+
+#include "../rle_image.h"
+
+static const uint16_t starPalette[] PROGMEM = { 0xFFFF, 0xCB60, 0xFE40, 0xFF91 };
+
+static const uint8_t starData[] PROGMEM = {
+  0x0F, 0x21, 0x11, 0x0F, 0x02, 0x21, 0x0F, 0x02, 0x21, 0x0F, 0x01, 0x10, 0x21, 0x10, 0x0F, 0x00,
+  0x30, 0x22, 0x0D, 0x11, 0x30, 0x22, 0x11, 0x06, 0x11, 0x22, 0x34, 0x25, 0x11, 0x02, 0x11, 0x22,
+  0x32, 0x25, 0x11, 0x04, 0x11, 0x21, 0x30, 0x20, 0x30, 0x24, 0x11, 0x07, 0x11, 0x25, 0x11, 0x0A,
+  0x27, 0x0A, 0x10, 0x27, 0x10, 0x09, 0x10, 0x22, 0x11, 0x22, 0x10, 0x09, 0x10, 0x21, 0x13, 0x21,
+  0x10, 0x09, 0x20, 0x11, 0x03, 0x11, 0x20, 0x08, 0x12, 0x05, 0x12, 0x07, 0x10, 0x09, 0x10, 0x0F,
+  0x08,
+};
+
+static const RleImage starImage = { 20, 20, 4, starPalette, starData, sizeof(starData) };
+
+#endif  // ASSET_STAR_H_
@@ -0,0 +1,160 @@
+#ifndef BOUNCE_CAPTURE_H_
+#define BOUNCE_CAPTURE_H_
+
+// Contact bounce measurement for the game buttons.
+//
+// While capture is on, ButtonInput hands every raw edge it takes from its
+// ring to feed(). Edges of one button less than BOUNCE_GAP_US apart belong
+// to the same burst, the bounce of a single press or release. A burst's
+// bounce time is the span from its first edge to its last; a clean
+// transition is a one-edge burst with bounce time 0. Bounce times go into
+// a log2 histogram per button, and the raw edges stay in a ring so the
+// last few bursts can be printed edge by edge.
+//
+// suggest() turns the worst bounce seen into a debounce window, with
+// BOUNCE_MARGIN_PCT of headroom, clamped to the BUTTON_DEBOUNCE_MIN_US and
+// BUTTON_DEBOUNCE_MAX_US limits. An integrator with a window at least as
+// long as the longest burst can't be fooled by it: it needs that much net
+// closed time. A button with fewer than BOUNCE_MIN_BURSTS bursts keeps its
+// current window.
+
+#include <Arduino.h>
+
+#define BOUNCE_BUTTONS 4
+#define BOUNCE_GAP_US 20000   // Quieter than this between edges ends a burst
+#define BOUNCE_BUCKETS 10     // 0, then below 125 us << (i - 1), then the rest
+#define BOUNCE_BUCKET1_US 125
+#define BOUNCE_RAW_LEN 128    // Raw edges kept for printing
+#define BOUNCE_MIN_BURSTS 20  // Presses plus releases before a button is tuned
+#define BOUNCE_MARGIN_PCT 150
+#define BUTTON_DEBOUNCE_MIN_US 2000
+#define BUTTON_DEBOUNCE_MAX_US 30000
+
+class BounceCapture {
+public:
+  void reset() {
+    memset(_buttons, 0, sizeof(_buttons));
+    _rawCount = 0;
+  }
+
+  void feed(uint8_t button, uint32_t tUs, uint8_t level) {
+    if (button >= BOUNCE_BUTTONS)
+      return;
+    _raw[_rawCount++ % BOUNCE_RAW_LEN] = Raw{ tUs, button, level };
+    Button &b = _buttons[button];
+    if (b.edges && tUs - b.lastUs < BOUNCE_GAP_US) {
+      b.edges++;
+    } else {
+      close(b);
+      b.firstUs = tUs;
+      b.edges = 1;
+    }
+    b.lastUs = tUs;
+  }
+
+  // Close bursts that have gone quiet; call before reading results.
+  void settle(uint32_t nowUs) {
+    for (uint8_t i = 0; i < BOUNCE_BUTTONS; i++) {
+      Button &b = _buttons[i];
+      if (b.edges && nowUs - b.lastUs >= BOUNCE_GAP_US) {
+        close(b);
+        b.edges = 0;
+      }
+    }
+  }
+
+  uint32_t bursts(uint8_t button) const {
+    return button < BOUNCE_BUTTONS ? _buttons[button].bursts : 0;
+  }
+
+  // Debounce window for `button` from what was captured, or `current` if
+  // there isn't enough to go on
+  uint32_t suggest(uint8_t button, uint32_t current) const {
+    if (button >= BOUNCE_BUTTONS || _buttons[button].bursts < BOUNCE_MIN_BURSTS)
+      return current;
+    uint32_t us = _buttons[button].maxUs * BOUNCE_MARGIN_PCT / 100;
+    if (us < BUTTON_DEBOUNCE_MIN_US)
+      return BUTTON_DEBOUNCE_MIN_US;
+    return us > BUTTON_DEBOUNCE_MAX_US ? BUTTON_DEBOUNCE_MAX_US : us;
+  }
+
+  void dump(Print &out, uint8_t count) const {
+    out.println("--- Button bounce ---");
+    out.printf("%-6s %6s %8s %8s  bursts per bounce time, upper bounds in us:\n", "button", "bursts", "mean us",
+               "max us");
+    out.printf("%-6s %6s %8s %8s      0", "", "", "", "");
+    for (uint8_t i = 1; i < BOUNCE_BUCKETS - 1; i++)
+      out.printf(" %6lu", (unsigned long)BOUNCE_BUCKET1_US << (i - 1));
+    out.println("   more");
+    for (uint8_t k = 0; k < count && k < BOUNCE_BUTTONS; k++) {
+      const Button &b = _buttons[k];
+      out.printf("%-6u %6lu %8lu %8lu ", k, (unsigned long)b.bursts,
+                 (unsigned long)(b.bursts ? b.sumUs / b.bursts : 0), (unsigned long)b.maxUs);
+      for (uint8_t i = 0; i < BOUNCE_BUCKETS; i++)
+        out.printf(" %6lu", (unsigned long)b.hist[i]);
+      out.println();
+    }
+
+    // Raw edges, one burst per line: button, first level, then each edge's
+    // offset from the burst start
+    uint32_t n = _rawCount < BOUNCE_RAW_LEN ? _rawCount : BOUNCE_RAW_LEN;
+    out.printf("last %lu raw edges:\n", (unsigned long)n);
+    uint32_t startUs = 0;
+    int16_t lineButton = -1;
+    uint32_t lastUs[BOUNCE_BUTTONS] = {};
+    for (uint32_t i = _rawCount - n; i < _rawCount; i++) {
+      const Raw &r = _raw[i % BOUNCE_RAW_LEN];
+      bool sameBurst = r.button == lineButton && r.tUs - lastUs[r.button] < BOUNCE_GAP_US;
+      if (!sameBurst) {
+        if (lineButton >= 0)
+          out.println();
+        out.printf("  %u %s:", r.button, r.level ? "up  " : "down");
+        startUs = r.tUs;
+        lineButton = r.button;
+      }
+      out.printf(" %lu", (unsigned long)(r.tUs - startUs));
+      lastUs[r.button] = r.tUs;
+    }
+    if (lineButton >= 0)
+      out.println();
+  }
+
+private:
+  struct Raw {
+    uint32_t tUs;
+    uint8_t button;
+    uint8_t level;
+  };
+
+  struct Button {
+    uint32_t firstUs, lastUs;  // Burst in progress
+    uint32_t edges;
+    uint32_t bursts;
+    uint32_t maxUs;
+    uint64_t sumUs;
+    uint32_t hist[BOUNCE_BUCKETS];
+  };
+
+  static void close(Button &b) {
+    if (!b.edges)
+      return;
+    uint32_t us = b.lastUs - b.firstUs;
+    b.bursts++;
+    b.sumUs += us;
+    if (us > b.maxUs)
+      b.maxUs = us;
+    uint8_t i = 0;
+    if (us > 0) {
+      i = 1;
+      while (i < BOUNCE_BUCKETS - 1 && us >= ((uint32_t)BOUNCE_BUCKET1_US << (i - 1)))
+        i++;
+    }
+    b.hist[i]++;
+  }
+
+  Button _buttons[BOUNCE_BUTTONS] = {};
+  Raw _raw[BOUNCE_RAW_LEN];
+  uint32_t _rawCount = 0;
+};
+
+#endif  // BOUNCE_CAPTURE_H_
@@ -0,0 +1,224 @@
+#ifndef BUTTON_INPUT_H_
+#define BUTTON_INPUT_H_
+
+// Interrupt-timestamped push buttons with integrator debounce.
+//
+// Each button pin has a CHANGE interrupt. The ISR does as little as
+// possible: it reads the new level, stamps it with esp_timer_get_time() and
+// pushes it into a lock-free SPSC ring. Debouncing happens in loop() when
+// read() drains the ring.
+//
+// Each button integrates how long its contact has been closed minus how
+// long it has been open, clamped to [0, debounce]. It counts as pressed
+// once the integral reaches the debounce time and released once it is
+// back to zero. Bounce only nudges the integral, so it can't produce
+// extra presses. No lockout follows a press either, so quick repeated
+// presses all register. The event keeps the time of the first edge that
+// started the integral moving, so a press keeps the microsecond it
+// happened at, however long loop() was busy before it got to it.
+//
+// The integral is brought up to date on every edge and again on every
+// read(), so a contact that settles without further edges is still seen.
+//
+// The window is per button. setCapture() hands every raw edge to a
+// BounceCapture as well, which measures each button's bounce and suggests
+// the shortest window that rides it out.
+
+#include <Arduino.h>
+#include "bounce_capture.h"
+#include "esp_timer.h"
+#include "spsc_ring.h"
+
+#define BUTTON_MAX 4
+#define BUTTON_DEBOUNCE_US 10000  // Net closed (or open) time to change state
+#define BUTTON_QUEUE_LEN 64  // Edges; a bouncy press is a dozen or so
+
+struct ButtonEvent {
+  uint32_t tUs;  // First edge of the transition
+  uint8_t button;
+  bool down;
+};
+
+class ButtonInput {
+public:
+  // Buttons are active low with the internal pull-up; index i is pins[i].
+  void begin(const uint8_t *pins, uint8_t count) {
+    _count = count < BUTTON_MAX ? count : BUTTON_MAX;
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    for (uint8_t i = 0; i < _count; i++) {
+      Button &b = _buttons[i];
+      b.pin = pins[i];
+      pinMode(b.pin, INPUT_PULLUP);
+      b.closed = digitalRead(b.pin) == LOW;
+      b.down = b.closed;
+      b.integral = b.down ? b.debounceUs : 0;
+      b.levelUs = now;
+      _contexts[i] = Context{ this, i };
+      attachInterruptArg(digitalPinToInterrupt(b.pin), onEdge, &_contexts[i], CHANGE);
+    }
+  }
+
+  // Time the contact must settle for before a press or release counts.
+  void setDebounce(uint8_t button, uint32_t us) {
+    if (button < BUTTON_MAX)
+      _buttons[button].debounceUs = us;
+  }
+  uint32_t debounce(uint8_t button) const {
+    return button < BUTTON_MAX ? _buttons[button].debounceUs : 0;
+  }
+
+  // Also pass raw edges to `capture` (nullptr stops).
+  void setCapture(BounceCapture *capture) {
+    _capture = capture;
+  }
+
+  // Next debounced press or release, in the order they settled.
+  bool read(ButtonEvent &event) {
+    for (;;) {
+      if (!_haveEdge && !_edges.pop(_edge))
+        break;
+      _haveEdge = true;
+      // Every button held its level up to this edge; report anything that
+      // settled before it first.
+      if (integrateAll(_edge.tUs, event))
+        return true;
+      apply(_edge);
+      _haveEdge = false;
+    }
+    return integrateAll((uint32_t)esp_timer_get_time(), event);
+  }
+
+  bool isDown(uint8_t button) const {
+    return button < _count && _buttons[button].down;
+  }
+
+  // Before a light sleep: free the pins to be armed as wake sources
+  void sleep() {
+    for (uint8_t i = 0; i < _count; i++)
+      detachInterrupt(digitalPinToInterrupt(_buttons[i].pin));
+  }
+
+  // After it: edges during the sleep went unseen, so each pin's level now
+  // counts as an edge, stamped now. They are all pushed before any ISR is
+  // attached, so the ring still has a single producer at a time.
+  void wake() {
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    for (uint8_t i = 0; i < _count; i++)
+      _edges.push(Edge{ now, i, (uint8_t)digitalRead(_buttons[i].pin) });
+    for (uint8_t i = 0; i < _count; i++)
+      attachInterruptArg(digitalPinToInterrupt(_buttons[i].pin), onEdge, &_contexts[i], CHANGE);
+  }
+
+  // Edges that didn't change the debounced state, and edges lost because
+  // the ring was full
+  uint32_t bounces() const {
+    return _bounces;
+  }
+  uint32_t overflows() const {
+    return _edges.overflows();
+  }
+
+private:
+  struct Edge {
+    uint32_t tUs;
+    uint8_t button;
+    uint8_t level;
+  };
+
+  struct Context {
+    ButtonInput *self;
+    uint8_t button;
+  };
+
+  struct Button {
+    uint8_t pin = 0;
+    bool closed = false;  // Raw contact level as of levelUs
+    bool down = false;    // Debounced state
+    uint32_t debounceUs = BUTTON_DEBOUNCE_US;
+    uint32_t integral = 0;
+    uint32_t levelUs = 0;  // Integrated up to here
+    uint32_t moveUs = 0;   // First edge of the transition under way
+    uint32_t restUs = 0;   // When the integral last got back to its resting end
+    bool moving = false;   // moveUs is valid
+  };
+
+  static void IRAM_ATTR onEdge(void *arg) {
+    Context *c = (Context *)arg;
+    ButtonInput *self = c->self;
+    self->_edges.push(Edge{ (uint32_t)esp_timer_get_time(), c->button, (uint8_t)digitalRead(self->_buttons[c->button].pin) });
+  }
+
+  bool integrateAll(uint32_t tUs, ButtonEvent &event) {
+    for (uint8_t i = 0; i < _count; i++) {
+      if (integrate(i, tUs, event))
+        return true;
+    }
+    return false;
+  }
+
+  // Integrate button `i` up to `tUs` at its current contact level. Returns
+  // true with `event` filled if that changed the debounced state.
+  bool integrate(uint8_t i, uint32_t tUs, ButtonEvent &event) {
+    Button &b = _buttons[i];
+    int32_t dt = (int32_t)(tUs - b.levelUs);
+    if (dt <= 0)
+      return false;
+    uint32_t fromUs = b.levelUs;
+    b.levelUs = tUs;
+    if (b.closed) {
+      if (b.integral + dt >= b.debounceUs) {
+        if (b.integral < b.debounceUs)
+          b.restUs = fromUs + (b.debounceUs - b.integral);
+        b.integral = b.debounceUs;
+      } else {
+        b.integral += dt;
+      }
+    } else {
+      if (b.integral <= (uint32_t)dt) {
+        if (b.integral > 0)
+          b.restUs = fromUs + b.integral;
+        b.integral = 0;
+      } else {
+        b.integral -= dt;
+      }
+    }
+    bool down = b.down ? b.integral > 0 : b.integral >= b.debounceUs;
+    if (down == b.down)
+      return false;
+    b.down = down;
+    b.moving = false;
+    event = ButtonEvent{ b.moveUs, i, down };
+    return true;
+  }
+
+  // Take a new contact level. An edge away from the debounced state starts
+  // a transition and stamps it, unless it is bounce within one that is
+  // already under way: the integral hasn't settled back, or only just has.
+  void apply(const Edge &edge) {
+    if (_capture)
+      _capture->feed(edge.button, edge.tUs, edge.level);
+    Button &b = _buttons[edge.button];
+    bool closed = edge.level == LOW;
+    if (closed == b.closed)
+      return;
+    b.closed = closed;
+    bool atRest = b.down ? b.integral >= b.debounceUs : b.integral == 0;
+    if (closed != b.down && atRest && (!b.moving || edge.tUs - b.restUs >= b.debounceUs)) {
+      b.moveUs = edge.tUs;
+      b.moving = true;
+    } else {
+      _bounces++;
+    }
+  }
+
+  SpscRing<Edge, BUTTON_QUEUE_LEN> _edges;
+  uint8_t _count = 0;
+  Button _buttons[BUTTON_MAX];
+  Context _contexts[BUTTON_MAX] = {};
+  Edge _edge;  // Popped but not applied yet
+  bool _haveEdge = false;
+  uint32_t _bounces = 0;
+  BounceCapture *_capture = nullptr;
+};
+
+#endif  // BUTTON_INPUT_H_
@@ -0,0 +1,228 @@
+#ifndef CHECKPOINT_H_
+#define CHECKPOINT_H_
+
+// Crash-safe checkpoints of the game in progress.
+//
+// A reset mid-game (the stall watchdog's, a panic, a brown-out, a pulled
+// plug) used to lose the session. Each step of a game now save()s a
+// compact Checkpoint: the game, its difficulty, the step and tries so far,
+// its sequence or secret, and whose game it is. It is kept twice:
+//
+//   RTC memory   every save, by the loop task: a 32-byte copy and its
+//                checksum. Survives any reset short of losing power.
+//   NVS          by the "ckpt" task on the protocol core, at most one
+//                write per CHECKPOINT_NVS_MIN_MS: the newest checkpoint
+//                saved meanwhile, and only if it differs from the one
+//                stored. Survives losing power.
+//
+// The RTC copy doubles as the mailbox: the task reads it back and takes
+// a checksum mismatch as save() caught halfway, so the loop task's part
+// is the same few microseconds whatever the game or the flash is doing.
+// save() times itself against CHECKPOINT_BUDGET_US and counts overruns.
+//
+// NVS keeps one 32-byte blob. Each write appends a few 32-byte entries to
+// its log-structured pages, which spreads the erases over the partition,
+// and the coalescing keeps a fast game from writing any faster than that.
+// A flash write stalls the app core's cache too, so the task keeps its
+// longest write for dump().
+//
+// load() at boot returns the newer valid record, by sequence number.
+// clear() once a game is over or abandoned saves an empty one over both.
+//
+// Without a background task (host builds) save() writes NVS itself.
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <stddef.h>
+#include <string.h>
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define CHECKPOINT_DATA 12
+#define CHECKPOINT_NONE 0xff  // `game` of an empty checkpoint
+#define CHECKPOINT_MAGIC 0x4b43  // "CK"
+#define CHECKPOINT_NVS_NAMESPACE "resume"
+#define CHECKPOINT_NVS_KEY "game"
+#define CHECKPOINT_NVS_MIN_MS 2000  // Between NVS writes
+#define CHECKPOINT_BUDGET_US 50     // Per save() on the loop task
+#define CHECKPOINT_TASK_STACK 3072
+#define CHECKPOINT_TASK_PRIORITY 1
+#define CHECKPOINT_TASK_CORE 0  // Protocol core, with the net worker
+
+struct Checkpoint {
+  uint8_t game;                   // The app's game id, or CHECKPOINT_NONE
+  uint8_t level;                  // Difficulty picked
+  uint8_t step;                   // Steps done
+  uint8_t tries;                  // Wrong tries so far
+  uint8_t player;                 // Index in the roster
+  uint8_t length;                 // Bytes of `data` in use
+  uint16_t playerHash;            // The player's name, in case the roster changed
+  uint32_t playedMs;              // Time played, for a timed game
+  uint8_t data[CHECKPOINT_DATA];  // Sequence or secret
+};
+
+struct CheckpointRecord {
+  uint16_t magic;
+  uint16_t seq;  // The newer of two valid records wins
+  Checkpoint cp;
+  uint32_t checksum;
+};
+static_assert(sizeof(CheckpointRecord) == 32, "A checkpoint is one 32-byte NVS blob");
+
+// 16-bit FNV-1a, for Checkpoint::playerHash
+inline uint16_t checkpointHash(const char *s) {
+  uint32_t h = 2166136261u;
+  while (*s)
+    h = (h ^ (uint8_t)*s++) * 16777619u;
+  return (uint16_t)(h ^ (h >> 16));
+}
+
+class CheckpointStore {
+public:
+  // `rtc` should be RTC_NOINIT_ATTR
+  void begin(CheckpointRecord &rtc) {
+    _rtc = &rtc;
+    _prefs.begin(CHECKPOINT_NVS_NAMESPACE, false);
+    CheckpointRecord stored;
+    if (_prefs.getBytes(CHECKPOINT_NVS_KEY, &stored, sizeof(stored)) == sizeof(stored) && valid(stored))
+      _written = stored;
+    _seq = _written.seq;
+    if (valid(*_rtc) && newer(_rtc->seq, _seq))
+      _seq = _rtc->seq;
+    Checkpoint left;
+    _active = load(left);
+    xTaskCreatePinnedToCore(taskEntry, "ckpt", CHECKPOINT_TASK_STACK, this, CHECKPOINT_TASK_PRIORITY, &_task,
+                            CHECKPOINT_TASK_CORE);
+  }
+
+  // The game the last run left unfinished. False if there is none.
+  bool load(Checkpoint &cp) const {
+    const CheckpointRecord *best = valid(_written) ? &_written : nullptr;
+    if (valid(*_rtc) && (!best || newer(_rtc->seq, best->seq)))
+      best = _rtc;
+    if (!best || best->cp.game == CHECKPOINT_NONE)
+      return false;
+    cp = best->cp;
+    return true;
+  }
+
+  // Loop task: the running game reached a step
+  void save(const Checkpoint &cp) {
+    if (!_rtc)
+      return;
+    uint32_t start = (uint32_t)esp_timer_get_time();
+    CheckpointRecord r;
+    r.magic = CHECKPOINT_MAGIC;
+    r.seq = ++_seq;
+    r.cp = cp;
+    r.checksum = checksum(r);
+    *_rtc = r;
+    _active = cp.game != CHECKPOINT_NONE;
+    if (_task)
+      xTaskNotifyGive(_task);
+    uint32_t us = (uint32_t)esp_timer_get_time() - start;
+    _saves++;
+    _saveSumUs += us;
+    if (us > _saveMaxUs)
+      _saveMaxUs = us;
+    if (us > CHECKPOINT_BUDGET_US)
+      _overBudget++;
+    if (!_task)
+      write(r);
+  }
+
+  // Loop task: nothing left to resume
+  void clear() {
+    if (!_active)
+      return;
+    Checkpoint none = {};
+    none.game = CHECKPOINT_NONE;
+    save(none);
+  }
+
+  void dump(Print &out) const {
+    out.println("--- Checkpoints ---");
+    out.printf("saves: %lu, mean %lu us, max %lu us, %lu over the %d us budget\n", (unsigned long)_saves,
+               (unsigned long)(_saves ? _saveSumUs / _saves : 0), (unsigned long)_saveMaxUs,
+               (unsigned long)_overBudget, CHECKPOINT_BUDGET_US);
+    out.printf("nvs: %lu writes of %u bytes, %lu unchanged, longest %lu us, %lu torn reads retried\n",
+               (unsigned long)_writes, (unsigned)sizeof(CheckpointRecord), (unsigned long)_unchanged,
+               (unsigned long)_writeMaxUs, (unsigned long)_torn);
+    Checkpoint cp;
+    if (load(cp))
+      out.printf("kept: game %u, level %u, step %u, %u tries, player %u\n", cp.game, cp.level, cp.step, cp.tries,
+                 cp.player);
+    else
+      out.println("kept: none");
+  }
+
+private:
+  static void taskEntry(void *arg) {
+    static_cast<CheckpointStore *>(arg)->task();
+  }
+
+  void task() {
+    for (;;) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      CheckpointRecord r;
+      for (;;) {
+        memcpy(&r, _rtc, sizeof(r));
+        if (valid(r))
+          break;
+        _torn++;  // save() was halfway through; it has notified again
+        vTaskDelay(1);
+      }
+      write(r);
+      vTaskDelay(pdMS_TO_TICKS(CHECKPOINT_NVS_MIN_MS));  // Saves meanwhile come down to the newest
+    }
+  }
+
+  void write(const CheckpointRecord &r) {
+    if (valid(_written) && !memcmp(&r.cp, &_written.cp, sizeof(r.cp))) {
+      _unchanged++;
+      return;
+    }
+    uint32_t start = (uint32_t)esp_timer_get_time();
+    _prefs.putBytes(CHECKPOINT_NVS_KEY, &r, sizeof(r));
+    uint32_t us = (uint32_t)esp_timer_get_time() - start;
+    _written = r;
+    _writes++;
+    if (us > _writeMaxUs)
+      _writeMaxUs = us;
+  }
+
+  static bool newer(uint16_t a, uint16_t b) {
+    return (int16_t)(a - b) > 0;
+  }
+
+  static uint32_t checksum(const CheckpointRecord &r) {
+    const uint8_t *bytes = (const uint8_t *)&r;
+    uint32_t h = 2166136261u;  // FNV-1a over everything before the checksum
+    for (size_t i = 0; i < offsetof(CheckpointRecord, checksum); i++)
+      h = (h ^ bytes[i]) * 16777619u;
+    return h;
+  }
+
+  static bool valid(const CheckpointRecord &r) {
+    return r.magic == CHECKPOINT_MAGIC && r.cp.length <= CHECKPOINT_DATA && r.checksum == checksum(r);
+  }
+
+  CheckpointRecord *_rtc = nullptr;
+  CheckpointRecord _written = {};  // What NVS holds
+  Preferences _prefs;
+  TaskHandle_t _task = nullptr;
+  uint16_t _seq = 0;
+  bool _active = false;
+  uint32_t _saves = 0;
+  uint64_t _saveSumUs = 0;
+  uint32_t _saveMaxUs = 0;
+  uint32_t _overBudget = 0;
+  // Written by the task
+  uint32_t _writes = 0;
+  uint32_t _unchanged = 0;
+  uint32_t _writeMaxUs = 0;
+  uint32_t _torn = 0;
+};
+
+#endif  // CHECKPOINT_H_
@@ -0,0 +1,312 @@
+#ifndef DISPLAY_SERVER_H_
+#define DISPLAY_SERVER_H_
+
+// Display server: the one task that draws on the TFT.
+//
+// Game logic doesn't call the display. It posts draw commands, a renderer
+// function and a few bytes of arguments, and the "display" task, which owns
+// the panel and its SPI bus, runs them in order:
+//
+//   screen()  a full repaint. Everything queued before it is superseded;
+//             commands the task hasn't drawn yet are dropped unseen.
+//             Returns an id for shownUs().
+//   draw()    a partial update on top of the current screen.
+//   call()    anything else that only the display task may touch (the
+//             render stats), in order with the drawing and never dropped.
+//
+// Renderers only draw. Whatever a game does around a screen (timeouts, LED
+// effects) the handler that posts it starts, so none of it depends on the
+// frame being drawn rather than superseded. A handler that needs to know
+// when its screen actually reached the panel asks shownUs().
+//
+// Arguments are copied into the command (text up to three characters, for
+// guesses and input lines); `str` must point at something that outlives
+// the command, such as a string literal.
+//
+// commit(), called once per loop() pass, hands the pass's commands to the
+// task as one batch and returns its id. The task shares the app core with
+// loop() at the same priority, so the commit doesn't preempt the loop: the
+// two take turns at each tick, and a pass that blocks or sleeps leaves the
+// core to the drawing. What a pass asked for is drawn once, after the
+// logic is done with it, and a pass that changed screen twice draws only
+// the last one. shown(batch) reports once a batch is on the panel, with
+// when its first command started drawing and its last one finished, for
+// the latency measurements.
+//
+// Renderers run between the handlers rather than inside them. They read
+// their DrawArgs, constants and what stopped changing at setup()
+// (playerNames), nothing a handler writes: state a screen needs is passed
+// in its arguments, as the roster's window is. The one thing they write
+// for the loop, the touch map, is built for a reader in another task.
+//
+// A full queue is back-pressure: post() commits early and waits for room,
+// and stalls() counts it. The LED task sits above this one, so a stimulus
+// frame is never held behind a screen fill.
+//
+// Without a background task (host builds) commands are drawn as they are
+// posted, so the screenshots see every frame.
+
+#include <Arduino.h>
+#include <atomic>
+#include <string.h>
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "spsc_ring.h"
+
+#define DISPLAY_QUEUE_LEN 16
+#define DISPLAY_TASK_STACK 4096
+#define DISPLAY_TASK_PRIORITY 1  // Same as loop(): shares the core without preempting it
+#define DISPLAY_TASK_CORE 1      // App core, with loop()
+#define DISPLAY_SHOWN_SLOTS 4    // Recent batches whose drawing times shown() keeps
+
+struct DrawArgs {
+  int16_t a = 0, b = 0, c = 0;
+  const char *str = nullptr;
+  char text[4] = {};
+
+  DrawArgs() = default;
+  explicit DrawArgs(int16_t a, int16_t b = 0, int16_t c = 0) : a(a), b(b), c(c) {}
+
+  DrawArgs &copy(const char *s) {
+    size_t n = strnlen(s, sizeof(text) - 1);
+    memcpy(text, s, n);
+    text[n] = '\0';
+    return *this;
+  }
+};
+
+class DisplayServer {
+public:
+  typedef void (*RenderFn)();
+  typedef void (*RenderArgsFn)(const DrawArgs &args);
+
+  void begin() {
+    xTaskCreatePinnedToCore(taskEntry, "display", DISPLAY_TASK_STACK, this, DISPLAY_TASK_PRIORITY, &_task,
+                            DISPLAY_TASK_CORE);
+  }
+
+  uint32_t screen(RenderFn render) {
+    uint32_t id = ++_screenSeq;
+    post(Command{ render, nullptr, {}, id, 0, CMD_SCREEN });
+    return id;
+  }
+
+  uint32_t screen(RenderArgsFn render, const DrawArgs &args) {
+    uint32_t id = ++_screenSeq;
+    post(Command{ nullptr, render, args, id, 0, CMD_SCREEN });
+    return id;
+  }
+
+  void draw(RenderFn render) {
+    post(Command{ render, nullptr, {}, _screenSeq.load(std::memory_order_relaxed), 0, CMD_DRAW });
+  }
+
+  void draw(RenderArgsFn render, const DrawArgs &args) {
+    post(Command{ nullptr, render, args, _screenSeq.load(std::memory_order_relaxed), 0, CMD_DRAW });
+  }
+
+  void call(RenderFn fn) {
+    post(Command{ fn, nullptr, {}, _screenSeq.load(std::memory_order_relaxed), 0, CMD_CALL });
+  }
+
+  // esp_timer time screen `id` finished drawing, or 0 if it hasn't: not
+  // yet, superseded, or a later screen has been drawn since
+  uint32_t shownUs(uint32_t id) const {
+    uint32_t seq = _shownSeq.load(std::memory_order_acquire);
+    uint32_t us = _shownUs.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (seq != id || _shownSeq.load(std::memory_order_relaxed) != seq)
+      return 0;
+    return us ? us : 1;
+  }
+
+  // Hand everything posted since the last commit to the task. Returns the
+  // batch's id for shown(), or 0 if nothing was posted.
+  uint32_t commit() {
+    if (!_batchPosts)
+      return 0;
+    _batchPosts = 0;
+    uint32_t batch = _committed.load(std::memory_order_relaxed) + 1;
+    _committed.store(batch, std::memory_order_release);
+    if (_task)
+      xTaskNotifyGive(_task);
+    else
+      finishBatch();
+    return batch;
+  }
+
+  // True once `batch` has been drawn: everything in it either reached the
+  // panel or was superseded. `firstUs` is when its first command started
+  // drawing and `lastUs` when its last one finished, both 0 if nothing in
+  // it was drawn or the batch is too old to remember.
+  bool shown(uint32_t batch, uint32_t &firstUs, uint32_t &lastUs) const {
+    if (!batch || (int32_t)(_doneBatch.load(std::memory_order_acquire) - batch) < 0)
+      return false;
+    const Shown &slot = _shown[batch % DISPLAY_SHOWN_SLOTS];
+    uint32_t id = slot.batch.load(std::memory_order_acquire);
+    firstUs = slot.firstUs.load(std::memory_order_relaxed);
+    lastUs = slot.lastUs.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (id != batch || slot.batch.load(std::memory_order_relaxed) != id)
+      firstUs = lastUs = 0;
+    return true;
+  }
+
+  // Nothing queued and nothing being drawn
+  bool idle() const {
+    return !_queue.size() && !_drawing;
+  }
+
+  uint32_t stalls() const {
+    return _stalls;
+  }
+
+  void dump(Print &out) const {
+    out.println("--- Display ---");
+    out.printf("display: %lu commands, %lu drawn, %lu superseded before drawing\n", (unsigned long)_posted,
+               (unsigned long)_drawn, (unsigned long)_coalesced);
+    out.printf("display: %lu us drawing, longest command %lu us\n", (unsigned long)_drawUs,
+               (unsigned long)_drawMaxUs);
+    out.printf("display: queue peak %lu of %d, %lu stalls on a full queue\n", (unsigned long)_queue.peak(),
+               DISPLAY_QUEUE_LEN, (unsigned long)_stalls);
+  }
+
+private:
+  enum CommandKind : uint8_t { CMD_SCREEN, CMD_DRAW, CMD_CALL };
+
+  struct Command {
+    RenderFn render;
+    RenderArgsFn renderArgs;
+    DrawArgs args;
+    uint32_t seq;    // The screen this command belongs to
+    uint32_t batch;  // The commit that hands it over
+    CommandKind kind;
+  };
+
+  // A finished batch's drawing times, written like a seqlock so shown()
+  // never pairs one batch's id with another's times
+  struct Shown {
+    std::atomic<uint32_t> batch{ 0 };
+    std::atomic<uint32_t> firstUs{ 0 };
+    std::atomic<uint32_t> lastUs{ 0 };
+  };
+
+  static void taskEntry(void *arg) {
+    static_cast<DisplayServer *>(arg)->task();
+  }
+
+  void task() {
+    for (;;) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      _drawing = true;
+      for (;;) {
+        // Read before the queue, so an empty queue means all of a batch
+        // committed by then has been taken
+        uint32_t committed = _committed.load(std::memory_order_acquire);
+        Command command;
+        if (!_queue.pop(command)) {
+          if (_batchOpen && (int32_t)(committed - _batch) >= 0)
+            finishBatch();
+          break;
+        }
+        accept(command);
+      }
+      _drawing = false;
+    }
+  }
+
+  void post(Command command) {
+    _posted++;
+    _batchPosts++;
+    command.batch = _committed.load(std::memory_order_relaxed) + 1;
+    if (!_task) {
+      accept(command);
+      return;
+    }
+    while (!_queue.push(command)) {
+      _stalls++;
+      xTaskNotifyGive(_task);  // Drain what this pass has queued so far
+      if (_queue.size() == DISPLAY_QUEUE_LEN)
+        vTaskDelay(1);
+    }
+  }
+
+  // Task side: run one command, keeping track of the batch it is in
+  void accept(const Command &command) {
+    if (_batchOpen && command.batch != _batch)
+      finishBatch();
+    if (!_batchOpen) {
+      _batchOpen = true;
+      _batch = command.batch;
+      _batchFirstUs = _batchLastUs = 0;
+    }
+    if (command.kind != CMD_CALL && (int32_t)(command.seq - _screenSeq.load(std::memory_order_acquire)) < 0) {
+      _coalesced++;  // A later screen() paints over it
+      return;
+    }
+    run(command);
+  }
+
+  void finishBatch() {
+    Shown &slot = _shown[_batch % DISPLAY_SHOWN_SLOTS];
+    slot.batch.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.firstUs.store(_batchFirstUs, std::memory_order_relaxed);
+    slot.lastUs.store(_batchLastUs, std::memory_order_relaxed);
+    slot.batch.store(_batch, std::memory_order_release);
+    _doneBatch.store(_batch, std::memory_order_release);
+    _batchOpen = false;
+  }
+
+  void run(const Command &command) {
+    uint32_t start = (uint32_t)esp_timer_get_time();
+    if (command.render)
+      command.render();
+    else
+      command.renderArgs(command.args);
+    if (command.kind == CMD_CALL)
+      return;
+    uint32_t end = (uint32_t)esp_timer_get_time();
+    if (command.kind == CMD_SCREEN) {
+      // Written like a seqlock, so shownUs() never pairs one screen's id
+      // with another's time
+      _shownSeq.store(0, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      _shownUs.store(end, std::memory_order_relaxed);
+      _shownSeq.store(command.seq, std::memory_order_release);
+    }
+    if (!_batchFirstUs)
+      _batchFirstUs = start ? start : 1;
+    _batchLastUs = end ? end : 1;
+    uint32_t us = end - start;
+    _drawn++;
+    _drawUs += us;
+    if (us > _drawMaxUs)
+      _drawMaxUs = us;
+  }
+
+  TaskHandle_t _task = nullptr;
+  SpscRing<Command, DISPLAY_QUEUE_LEN> _queue;
+  std::atomic<uint32_t> _screenSeq{ 0 };
+  std::atomic<uint32_t> _shownSeq{ 0 };  // Last screen drawn, and when
+  std::atomic<uint32_t> _shownUs{ 0 };
+  std::atomic<uint32_t> _committed{ 0 };  // Last batch handed over
+  std::atomic<uint32_t> _doneBatch{ 0 };  // Last batch drawn
+  Shown _shown[DISPLAY_SHOWN_SLOTS];
+  std::atomic<bool> _drawing{ false };
+  uint32_t _batchPosts = 0;  // Loop side: posts since the last commit
+  // Task side: the batch being drawn
+  bool _batchOpen = false;
+  uint32_t _batch = 0;
+  uint32_t _batchFirstUs = 0;
+  uint32_t _batchLastUs = 0;
+  uint32_t _posted = 0;
+  uint32_t _drawn = 0;
+  uint32_t _coalesced = 0;
+  uint32_t _stalls = 0;
+  uint64_t _drawUs = 0;
+  uint32_t _drawMaxUs = 0;
+};
+
+#endif  // DISPLAY_SERVER_H_
@@ -0,0 +1,71 @@
+#ifndef GAME_ARENA_H_
+#define GAME_ARENA_H_
+
+// The running game's state, in one block of RAM shared by every game.
+//
+// Each game keeps its sequence, step, tries and score in its own struct
+// instead of in globals. The arena holds the running game's struct in a
+// std::variant over all of them, so together they take the size of the
+// largest plus a tag, and starting a game constructs a fresh struct: the
+// member initialisers are the reset, and nothing leaks from one session
+// into the next.
+//
+//   start<G>(args)  end whatever game is running and construct a G
+//   end()           destroy it; the menus call this on entry
+//   get<G>()        the running G, or nullptr
+//   as<G>()         the running G, for a handler of one of G's states.
+//                   Those states are only reached through the event that
+//                   starts G, so finding anything else is a bug: it
+//                   asserts rather than read or quietly start a game.
+//
+// Each game struct names itself with a static `name` for dump().
+//
+// References into a game (a script's pointer to its sequence) last until
+// it ends. A game's states stop whatever holds them in onExit, which the
+// state machine runs before the next state's onEnter can end the game.
+
+#include <Arduino.h>
+#include <assert.h>
+#include <utility>
+#include <variant>
+
+template <typename... Games>
+class GameArena {
+public:
+  template <typename G, typename... Args>
+  G &start(Args &&...args) {
+    _starts++;
+    return _game.template emplace<G>(std::forward<Args>(args)...);
+  }
+
+  void end() {
+    _game.template emplace<std::monostate>();
+  }
+
+  template <typename G>
+  G *get() {
+    return std::get_if<G>(&_game);
+  }
+
+  template <typename G>
+  G &as() {
+    G *game = get<G>();
+    assert(game && "A game's state was entered without starting the game");
+    return *game;
+  }
+
+  void dump(Print &out) const {
+    static const char *const names[] = { "none", Games::name... };
+    out.println("--- Game arena ---");
+    out.printf("arena: %u bytes; the games on their own would take %u\n", (unsigned)sizeof(_game),
+               (unsigned)(sizeof(Games) + ...));
+    (out.printf("  %-24s %5u bytes\n", Games::name, (unsigned)sizeof(Games)), ...);
+    out.printf("running: %s; %lu games started\n", names[_game.index()], (unsigned long)_starts);
+  }
+
+private:
+  std::variant<std::monostate, Games...> _game;
+  uint32_t _starts = 0;
+};
+
+#endif  // GAME_ARENA_H_
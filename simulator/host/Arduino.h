@@ -0,0 +1,334 @@
+// Minimal Arduino core shim so simulator/main.cpp builds on Linux.
+// Time is virtual: delay() and the emulated SPI bus advance the clock
+// instead of sleeping, so a whole game flow renders in milliseconds.
+#ifndef HOST_ARDUINO_H_
+#define HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+
+#ifndef HOST_BUILD
+#define HOST_BUILD 1
+#endif
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define CHANGE 0x03
+#define FALLING 0x02
+#define RISING 0x01
+#define DEC 10
+#define HEX 16
+#define IRAM_ATTR
+#define RTC_NOINIT_ATTR
+#define RTC_DATA_ATTR
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+using std::max;
+using std::min;
+
+// --- Virtual clock -------------------------------------------------------
+inline uint64_t &hostClockUs() {
+  static uint64_t clock = 0;
+  return clock;
+}
+// Set by the esp_timer shim: runs timers due up to `endUs`, moving the clock
+// to each one's deadline before calling it
+inline void (*&hostTimerHook())(uint64_t endUs) {
+  static void (*hook)(uint64_t) = nullptr;
+  return hook;
+}
+inline void hostAdvanceUs(uint64_t us) {
+  uint64_t end = hostClockUs() + us;
+  if (hostTimerHook())
+    hostTimerHook()(end);
+  hostClockUs() = end;
+}
+inline unsigned long millis() {
+  return (unsigned long)(hostClockUs() / 1000);
+}
+inline unsigned long micros() {
+  return (unsigned long)hostClockUs();
+}
+inline void delay(unsigned long ms) {
+  hostAdvanceUs((uint64_t)ms * 1000);
+}
+inline void delayMicroseconds(unsigned int us) {
+  hostAdvanceUs(us);
+}
+inline void yield() {}
+
+// --- GPIO -------------------------------------------------------------------
+inline int *hostPinLevels() {
+  static int levels[40] = {
+    HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH,
+    HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH,
+    HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH,
+    HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH
+  };
+  return levels;
+}
+inline void pinMode(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t pin) {
+  return pin < 40 ? hostPinLevels()[pin] : LOW;
+}
+inline void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin < 40)
+    hostPinLevels()[pin] = val;
+}
+inline uint16_t analogRead(uint8_t) {
+  return 0;
+}
+
+inline int digitalPinToInterrupt(uint8_t pin) {
+  return pin;
+}
+// Pin interrupts fire when host code changes a level with hostSetPin();
+// nothing else drives the pins, so drivers that wait for hardware stay idle.
+struct HostPinIsr {
+  void (*fn)(void *);
+  void *arg;
+  int mode;
+};
+inline HostPinIsr *hostPinIsrs() {
+  static HostPinIsr isrs[40] = {};
+  return isrs;
+}
+inline void attachInterruptArg(uint8_t pin, void (*fn)(void *), void *arg, int mode) {
+  if (pin < 40)
+    hostPinIsrs()[pin] = HostPinIsr{ fn, arg, mode };
+}
+inline void attachInterrupt(uint8_t pin, void (*fn)(), int mode) {
+  attachInterruptArg(pin, [](void *f) { ((void (*)())f)(); }, (void *)fn, mode);
+}
+inline void detachInterrupt(uint8_t pin) {
+  if (pin < 40)
+    hostPinIsrs()[pin] = HostPinIsr{};
+}
+// Host-only: drive an input pin as the outside world would.
+inline void hostSetPin(uint8_t pin, int level) {
+  if (pin >= 40 || hostPinLevels()[pin] == level)
+    return;
+  hostPinLevels()[pin] = level;
+  const HostPinIsr &isr = hostPinIsrs()[pin];
+  if (isr.fn && (isr.mode == CHANGE || (isr.mode == FALLING && level == LOW) || (isr.mode == RISING && level == HIGH)))
+    isr.fn(isr.arg);
+}
+
+// --- CPU clock ----------------------------------------------------------------
+// Remembered, not emulated: the virtual clock runs at one speed.
+inline uint32_t &hostCpuMhz() {
+  static uint32_t mhz = 240;
+  return mhz;
+}
+inline bool setCpuFrequencyMhz(uint32_t mhz) {
+  hostCpuMhz() = mhz;
+  return true;
+}
+inline uint32_t getCpuFrequencyMhz() {
+  return hostCpuMhz();
+}
+
+// --- Random -----------------------------------------------------------------
+inline void randomSeed(unsigned long seed) {
+  srand((unsigned)seed);
+}
+inline long random(long howbig) {
+  return howbig <= 0 ? 0 : rand() % howbig;
+}
+inline long random(long howsmall, long howbig) {
+  return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+// --- String -----------------------------------------------------------------
+class String {
+public:
+  String(const char *s = "") : s_(s ? s : "") {}
+  String(const std::string &s) : s_(s) {}
+  explicit String(char c) : s_(1, c) {}
+  explicit String(int v) : s_(std::to_string(v)) {}
+  explicit String(unsigned int v) : s_(std::to_string(v)) {}
+  explicit String(long v) : s_(std::to_string(v)) {}
+  explicit String(unsigned long v) : s_(std::to_string(v)) {}
+  explicit String(double v, unsigned char decimals = 2) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+    s_ = buf;
+  }
+
+  const char *c_str() const {
+    return s_.c_str();
+  }
+  unsigned int length() const {
+    return (unsigned int)s_.size();
+  }
+  int lastIndexOf(char c) const {
+    size_t pos = s_.rfind(c);
+    return pos == std::string::npos ? -1 : (int)pos;
+  }
+  int indexOf(char c) const {
+    size_t pos = s_.find(c);
+    return pos == std::string::npos ? -1 : (int)pos;
+  }
+  String substring(unsigned int from) const {
+    return from >= s_.size() ? String() : String(s_.substr(from));
+  }
+  String substring(unsigned int from, unsigned int to) const {
+    return from >= s_.size() ? String() : String(s_.substr(from, to - from));
+  }
+  char operator[](unsigned int i) const {
+    return i < s_.size() ? s_[i] : 0;
+  }
+  String &operator+=(const String &rhs) {
+    s_ += rhs.s_;
+    return *this;
+  }
+  String &operator+=(const char *rhs) {
+    s_ += rhs;
+    return *this;
+  }
+  String &operator+=(char c) {
+    s_ += c;
+    return *this;
+  }
+  bool operator==(const String &rhs) const {
+    return s_ == rhs.s_;
+  }
+  bool operator!=(const String &rhs) const {
+    return s_ != rhs.s_;
+  }
+  friend String operator+(const String &lhs, const String &rhs) {
+    return String(lhs.s_ + rhs.s_);
+  }
+
+private:
+  std::string s_;
+};
+
+// --- Print / Serial ---------------------------------------------------------
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+
+  size_t write(const char *s) {
+    size_t n = 0;
+    while (*s)
+      n += write((uint8_t)*s++);
+    return n;
+  }
+  size_t print(const char *s) {
+    return write(s);
+  }
+  size_t print(const String &s) {
+    return write(s.c_str());
+  }
+  size_t print(char c) {
+    return write((uint8_t)c);
+  }
+  size_t print(unsigned char v, int base = DEC) {
+    return print((unsigned long)v, base);
+  }
+  size_t print(int v, int base = DEC) {
+    return print((long)v, base);
+  }
+  size_t print(unsigned int v, int base = DEC) {
+    return print((unsigned long)v, base);
+  }
+  size_t print(long v, int base = DEC) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), base == HEX ? "%lx" : "%ld", v);
+    return write(buf);
+  }
+  size_t print(unsigned long v, int base = DEC) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), base == HEX ? "%lx" : "%lu", v);
+    return write(buf);
+  }
+  size_t print(unsigned long long v, int base = DEC) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), base == HEX ? "%llx" : "%llu", v);
+    return write(buf);
+  }
+  size_t print(double v, int digits = 2) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.*f", digits, v);
+    return write(buf);
+  }
+  size_t println() {
+    return write((uint8_t)'\n');
+  }
+  template <typename T>
+  size_t println(const T &v) {
+    size_t n = print(v);
+    return n + println();
+  }
+  template <typename T>
+  size_t println(const T &v, int fmt) {
+    size_t n = print(v, fmt);
+    return n + println();
+  }
+  size_t printf(const char *fmt, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    return write(buf);
+  }
+};
+
+class HostSerial : public Print {
+public:
+  void begin(unsigned long) {}
+  using Print::write;
+  size_t write(uint8_t c) override {
+    if (!muted)
+      fputc(c, stderr);
+    return 1;
+  }
+  int available() {
+    return (int)(input.size() - inputPos);
+  }
+  int read() {
+    return inputPos < input.size() ? (unsigned char)input[inputPos++] : -1;
+  }
+  void flush() {
+    fflush(stderr);
+  }
+  // Host-only: queue bytes as if typed into the serial monitor.
+  void feed(const char *s) {
+    input += s;
+  }
+  bool muted = false;
+
+private:
+  std::string input;
+  size_t inputPos = 0;
+};
+
+inline HostSerial Serial;
+
+// --- time.h extras the ESP32 core provides ----------------------------------
+#include <time.h>
+inline void configTime(long, int, const char *, const char * = nullptr, const char * = nullptr) {}
+inline bool getLocalTime(struct tm *info, uint32_t = 5000) {
+  time_t t = 1700000000 + (time_t)(hostClockUs() / 1000000);
+  gmtime_r(&t, info);
+  return true;
+}
+
+// The ESP32 core pulls its peripheral HALs in through Arduino.h.
+#include "esp32-hal-rmt.h"
+
+#endif  // HOST_ARDUINO_H_
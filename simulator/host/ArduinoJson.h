@@ -0,0 +1,300 @@
+// ArduinoJson shim covering the subset the firmware uses: building
+// documents with operator[] / assignment and serialising them. Parsing is
+// not emulated because the HTTP shim never returns a body.
+#ifndef HOST_ARDUINOJSON_H_
+#define HOST_ARDUINOJSON_H_
+
+#include "Arduino.h"
+#include <memory>
+#include <utility>
+#include <vector>
+
+struct JsonNode {
+  enum Type { Null, Bool, Int, Float, Str, Object, Array } type = Null;
+  bool b = false;
+  long long i = 0;
+  double f = 0;
+  std::string s;
+  std::vector<std::pair<std::string, std::unique_ptr<JsonNode>>> members;
+  std::vector<std::unique_ptr<JsonNode>> items;
+
+  JsonNode *member(const char *key, bool create) {
+    for (auto &m : members)
+      if (m.first == key)
+        return m.second.get();
+    if (!create)
+      return nullptr;
+    if (type != Object) {
+      type = Object;
+      members.clear();
+    }
+    members.emplace_back(key, std::make_unique<JsonNode>());
+    return members.back().second.get();
+  }
+};
+
+class JsonObject;
+class JsonArray;
+
+class JsonVariant {
+public:
+  JsonVariant(JsonNode *node = nullptr) : _node(node) {}
+
+  JsonVariant operator[](const char *key) const {
+    return JsonVariant(_node ? _node->member(key, true) : nullptr);
+  }
+  bool containsKey(const char *key) const {
+    return _node && _node->type == JsonNode::Object && _node->member(key, false);
+  }
+  explicit operator bool() const {
+    if (!_node)
+      return false;
+    switch (_node->type) {
+      case JsonNode::Null: return false;
+      case JsonNode::Bool: return _node->b;
+      case JsonNode::Int: return _node->i != 0;
+      case JsonNode::Float: return _node->f != 0;
+      default: return true;
+    }
+  }
+
+  template <typename T>
+  T as() const;
+
+  JsonObject createNestedObject(const char *key) const;
+
+  JsonVariant &operator=(long long v) {
+    if (_node) {
+      _node->type = JsonNode::Int;
+      _node->i = v;
+    }
+    return *this;
+  }
+  JsonVariant &operator=(int v) {
+    return *this = (long long)v;
+  }
+  JsonVariant &operator=(long v) {
+    return *this = (long long)v;
+  }
+  JsonVariant &operator=(unsigned int v) {
+    return *this = (long long)v;
+  }
+  JsonVariant &operator=(unsigned long v) {
+    return *this = (long long)v;
+  }
+  JsonVariant &operator=(double v) {
+    if (_node) {
+      _node->type = JsonNode::Float;
+      _node->f = v;
+    }
+    return *this;
+  }
+  JsonVariant &operator=(float v) {
+    return *this = (double)v;
+  }
+  JsonVariant &operator=(bool v) {
+    if (_node) {
+      _node->type = JsonNode::Bool;
+      _node->b = v;
+    }
+    return *this;
+  }
+  JsonVariant &operator=(const char *v) {
+    if (_node) {
+      _node->type = JsonNode::Str;
+      _node->s = v ? v : "";
+    }
+    return *this;
+  }
+  JsonVariant &operator=(const String &v) {
+    return *this = v.c_str();
+  }
+
+  JsonNode *node() const {
+    return _node;
+  }
+
+protected:
+  JsonNode *_node;
+};
+
+class JsonObject : public JsonVariant {
+public:
+  JsonObject(JsonNode *node = nullptr) : JsonVariant(node) {}
+};
+
+class JsonArray : public JsonVariant {
+public:
+  JsonArray(JsonNode *node = nullptr) : JsonVariant(node) {}
+
+  class iterator {
+  public:
+    iterator(std::vector<std::unique_ptr<JsonNode>>::iterator it) : _it(it) {}
+    JsonObject operator*() const {
+      return JsonObject(_it->get());
+    }
+    iterator &operator++() {
+      ++_it;
+      return *this;
+    }
+    bool operator!=(const iterator &o) const {
+      return _it != o._it;
+    }
+
+  private:
+    std::vector<std::unique_ptr<JsonNode>>::iterator _it;
+  };
+
+  iterator begin() const {
+    return iterator(hasItems() ? _node->items.begin() : empty().begin());
+  }
+  iterator end() const {
+    return iterator(hasItems() ? _node->items.end() : empty().end());
+  }
+
+private:
+  bool hasItems() const {
+    return _node && _node->type == JsonNode::Array;
+  }
+  static std::vector<std::unique_ptr<JsonNode>> &empty() {
+    static std::vector<std::unique_ptr<JsonNode>> none;
+    return none;
+  }
+};
+
+inline JsonObject JsonVariant::createNestedObject(const char *key) const {
+  JsonNode *node = _node ? _node->member(key, true) : nullptr;
+  if (node && node->type != JsonNode::Object) {
+    node->type = JsonNode::Object;
+    node->members.clear();
+  }
+  return JsonObject(node);
+}
+
+template <>
+inline long long JsonVariant::as<long long>() const {
+  if (!_node)
+    return 0;
+  return _node->type == JsonNode::Int ? _node->i : _node->type == JsonNode::Float ? (long long)_node->f : 0;
+}
+template <>
+inline int JsonVariant::as<int>() const {
+  return (int)as<long long>();
+}
+template <>
+inline long JsonVariant::as<long>() const {
+  return (long)as<long long>();
+}
+template <>
+inline double JsonVariant::as<double>() const {
+  if (!_node)
+    return 0;
+  return _node->type == JsonNode::Float ? _node->f : (double)as<long long>();
+}
+template <>
+inline String JsonVariant::as<String>() const {
+  return _node && _node->type == JsonNode::Str ? String(_node->s) : String("null");
+}
+template <>
+inline JsonArray JsonVariant::as<JsonArray>() const {
+  return JsonArray(_node);
+}
+template <>
+inline JsonObject JsonVariant::as<JsonObject>() const {
+  return JsonObject(_node);
+}
+
+class JsonDocument : public JsonVariant {
+public:
+  JsonDocument() : JsonVariant(nullptr), _root(std::make_unique<JsonNode>()) {
+    _node = _root.get();
+  }
+  JsonDocument(const JsonDocument &) = delete;
+  JsonDocument &operator=(const JsonDocument &) = delete;
+  void clear() {
+    _root = std::make_unique<JsonNode>();
+    _node = _root.get();
+  }
+
+private:
+  std::unique_ptr<JsonNode> _root;
+};
+
+template <size_t N>
+class StaticJsonDocument : public JsonDocument {};
+
+class DynamicJsonDocument : public JsonDocument {
+public:
+  explicit DynamicJsonDocument(size_t) {}
+};
+
+class DeserializationError {
+public:
+  enum Code { Ok, EmptyInput, InvalidInput };
+  DeserializationError(Code c = Ok) : _code(c) {}
+  explicit operator bool() const {
+    return _code != Ok;
+  }
+  const char *c_str() const {
+    return _code == Ok ? "Ok" : _code == EmptyInput ? "EmptyInput" : "InvalidInput";
+  }
+
+private:
+  Code _code;
+};
+
+inline DeserializationError deserializeJson(JsonDocument &doc, const String &input) {
+  doc.clear();
+  return input.length() == 0 ? DeserializationError::EmptyInput : DeserializationError::InvalidInput;
+}
+
+inline void hostSerializeJson(const JsonNode *n, std::string &out) {
+  char buf[32];
+  switch (n->type) {
+    case JsonNode::Null: out += "null"; break;
+    case JsonNode::Bool: out += n->b ? "true" : "false"; break;
+    case JsonNode::Int:
+      snprintf(buf, sizeof(buf), "%lld", n->i);
+      out += buf;
+      break;
+    case JsonNode::Float:
+      snprintf(buf, sizeof(buf), "%g", n->f);
+      out += buf;
+      break;
+    case JsonNode::Str:
+      out += '"';
+      out += n->s;
+      out += '"';
+      break;
+    case JsonNode::Object:
+      out += '{';
+      for (size_t i = 0; i < n->members.size(); i++) {
+        if (i)
+          out += ',';
+        out += '"';
+        out += n->members[i].first;
+        out += "\":";
+        hostSerializeJson(n->members[i].second.get(), out);
+      }
+      out += '}';
+      break;
+    case JsonNode::Array:
+      out += '[';
+      for (size_t i = 0; i < n->items.size(); i++) {
+        if (i)
+          out += ',';
+        hostSerializeJson(n->items[i].get(), out);
+      }
+      out += ']';
+      break;
+  }
+}
+
+inline size_t serializeJson(const JsonDocument &doc, String &output) {
+  std::string out;
+  hostSerializeJson(doc.node(), out);
+  output = String(out);
+  return out.size();
+}
+
+#endif  // HOST_ARDUINOJSON_H_
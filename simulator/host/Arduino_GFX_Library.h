@@ -0,0 +1,621 @@
+// Arduino_GFX-compatible shim for host builds.
+//
+// The class layout mirrors the real library closely enough that firmware
+// code (and wrappers such as InstrumentedBus in render_stats.h) compiles
+// unchanged: Arduino_ILI9341 rasterises through the same startWrite /
+// writeAddrWindow / writeRepeat calls, and Arduino_ESP32SPI emulates the
+// panel controller by decoding CASET/PASET/RAMWR into an in-memory RGB565
+// framebuffer instead of clocking a real SPI peripheral.
+#ifndef HOST_ARDUINO_GFX_LIBRARY_H_
+#define HOST_ARDUINO_GFX_LIBRARY_H_
+
+#include "Arduino.h"
+#include "glcdfont.h"
+
+#define GFX_NOT_DEFINED -1
+#define VSPI 3
+
+#define RGB565(r, g, b) ((((r)&0xF8) << 8) | (((g)&0xFC) << 3) | ((b) >> 3))
+#define BLACK RGB565(0, 0, 0)
+#define NAVY RGB565(0, 0, 123)
+#define DARKGREEN RGB565(0, 125, 0)
+#define DARKCYAN RGB565(0, 125, 123)
+#define MAROON RGB565(123, 0, 0)
+#define PURPLE RGB565(123, 0, 123)
+#define OLIVE RGB565(123, 125, 0)
+#define LIGHTGREY RGB565(198, 195, 198)
+#define DARKGREY RGB565(123, 125, 123)
+#define BLUE RGB565(0, 0, 255)
+#define GREEN RGB565(0, 255, 0)
+#define CYAN RGB565(0, 255, 255)
+#define RED RGB565(255, 0, 0)
+#define MAGENTA RGB565(255, 0, 255)
+#define YELLOW RGB565(255, 255, 0)
+#define WHITE RGB565(255, 255, 255)
+#define ORANGE RGB565(255, 165, 0)
+#define PINK RGB565(255, 130, 198)
+
+#define ILI9341_TFTWIDTH 240
+#define ILI9341_TFTHEIGHT 320
+#define ILI9341_CASET 0x2A
+#define ILI9341_PASET 0x2B
+#define ILI9341_RAMWR 0x2C
+
+// Counters kept by the emulated panel. overdraw() is pixels pushed per
+// distinct pixel touched; wastedPixels counts writes that did not change
+// the stored colour.
+struct HostPanelStats {
+  uint32_t transactions = 0;
+  uint32_t commands = 0;
+  uint64_t bytes = 0;
+  uint64_t pixelsPushed = 0;
+  uint64_t wastedPixels = 0;
+  uint32_t uniquePixels = 0;
+
+  double overdraw() const {
+    return uniquePixels ? (double)pixelsPushed / uniquePixels : 0.0;
+  }
+};
+
+class Arduino_DataBus {
+public:
+  virtual ~Arduino_DataBus() {}
+  virtual bool begin(int32_t speed = GFX_NOT_DEFINED, int8_t dataMode = GFX_NOT_DEFINED) = 0;
+  virtual void beginWrite() = 0;
+  virtual void endWrite() = 0;
+  virtual void writeCommand(uint8_t c) = 0;
+  virtual void writeCommand16(uint16_t c) = 0;
+  virtual void write(uint8_t) = 0;
+  virtual void write16(uint16_t) = 0;
+  virtual void writeC8D8(uint8_t c, uint8_t d) {
+    writeCommand(c);
+    write(d);
+  }
+  virtual void writeC8D16(uint8_t c, uint16_t d) {
+    writeCommand(c);
+    write16(d);
+  }
+  virtual void writeC8D16D16(uint8_t c, uint16_t d1, uint16_t d2) {
+    writeCommand(c);
+    write16(d1);
+    write16(d2);
+  }
+  virtual void writeRepeat(uint16_t p, uint32_t len) = 0;
+  virtual void writePixels(uint16_t *data, uint32_t len) = 0;
+  virtual void writeBytes(uint8_t *data, uint32_t len) = 0;
+  virtual void writeIndexedPixels(uint8_t *data, uint16_t *idx, uint32_t len) {
+    while (len--)
+      write16(idx[*data++]);
+  }
+};
+
+// Emulated ILI9341 controller behind an SPI bus clocked at 40 MHz.
+class Arduino_ESP32SPI : public Arduino_DataBus {
+public:
+  static const int16_t WIDTH = ILI9341_TFTWIDTH;
+  static const int16_t HEIGHT = ILI9341_TFTHEIGHT;
+
+  Arduino_ESP32SPI(int8_t dc, int8_t cs = GFX_NOT_DEFINED, int8_t sck = GFX_NOT_DEFINED,
+                   int8_t mosi = GFX_NOT_DEFINED, int8_t miso = GFX_NOT_DEFINED,
+                   uint8_t spi_num = VSPI, bool is_shared_interface = true) {
+    (void)dc, (void)cs, (void)sck, (void)mosi, (void)miso, (void)spi_num, (void)is_shared_interface;
+    resetPanel();
+  }
+
+  bool begin(int32_t speed = GFX_NOT_DEFINED, int8_t = GFX_NOT_DEFINED) override {
+    if (speed > 0)
+      _speed = speed;
+    return true;
+  }
+  void beginWrite() override {
+    _stats.transactions++;
+    hostAdvanceUs(kTransactionOverheadUs);
+  }
+  void endWrite() override {}
+  void writeCommand(uint8_t c) override {
+    _stats.commands++;
+    clock(1);
+    _cmd = c;
+    _argCount = 0;
+    if (c == ILI9341_RAMWR) {
+      _wx = _x0;
+      _wy = _y0;
+    }
+  }
+  void writeCommand16(uint16_t c) override {
+    writeCommand((uint8_t)c);
+  }
+  void write(uint8_t d) override {
+    clock(1);
+    (void)d;
+  }
+  void write16(uint16_t d) override {
+    clock(2);
+    if (_cmd == ILI9341_CASET || _cmd == ILI9341_PASET)
+      writeArg16(d);
+    else
+      pushPixel(d);
+  }
+  // Like the real driver, command+argument helpers bypass the virtual
+  // write16() so wrappers only ever see pixel data there.
+  void writeC8D16D16(uint8_t c, uint16_t d1, uint16_t d2) override {
+    writeCommand(c);
+    clock(4);
+    writeArg16(d1);
+    writeArg16(d2);
+  }
+  void writeRepeat(uint16_t p, uint32_t len) override {
+    clock(2ull * len);
+    while (len--)
+      pushPixel(p);
+  }
+  void writePixels(uint16_t *data, uint32_t len) override {
+    clock(2ull * len);
+    while (len--)
+      pushPixel(*data++);
+  }
+  void writeBytes(uint8_t *data, uint32_t len) override {
+    clock(len);
+    (void)data;
+  }
+
+  // --- Host-only inspection -------------------------------------------------
+  const uint16_t *framebuffer() const {
+    return _fb;
+  }
+  uint16_t pixel(int16_t x, int16_t y) const {
+    return _fb[y * WIDTH + x];
+  }
+  const HostPanelStats &stats() const {
+    return _stats;
+  }
+  // Start a new measurement window; the framebuffer keeps its contents.
+  void resetStats() {
+    _stats = HostPanelStats();
+    memset(_touched, 0, sizeof(_touched));
+  }
+  // Power-on state: black GRAM and cleared counters.
+  void resetPanel() {
+    for (int i = 0; i < WIDTH * HEIGHT; i++)
+      _fb[i] = BLACK;
+    resetStats();
+  }
+
+private:
+  static const uint32_t kTransactionOverheadUs = 2;
+
+  // Advance the virtual clock by the time it takes to shift out `bytes`.
+  void clock(uint64_t bytes) {
+    _stats.bytes += bytes;
+    _bitDebt += bytes * 8 * 1000000ull;
+    uint64_t us = _bitDebt / (uint64_t)_speed;
+    _bitDebt -= us * (uint64_t)_speed;
+    hostAdvanceUs(us);
+  }
+  void writeArg16(uint16_t d) {
+    if (_cmd == ILI9341_CASET)
+      (_argCount++ == 0 ? _x0 : _x1) = d;
+    else if (_cmd == ILI9341_PASET)
+      (_argCount++ == 0 ? _y0 : _y1) = d;
+  }
+  void pushPixel(uint16_t color) {
+    _stats.pixelsPushed++;
+    if (_wx < WIDTH && _wy < HEIGHT) {
+      int i = _wy * WIDTH + _wx;
+      if (_fb[i] == color)
+        _stats.wastedPixels++;
+      _fb[i] = color;
+      if (!_touched[i]) {
+        _touched[i] = 1;
+        _stats.uniquePixels++;
+      }
+    }
+    if (++_wx > _x1) {
+      _wx = _x0;
+      if (++_wy > _y1)
+        _wy = _y0;
+    }
+  }
+
+  int32_t _speed = 40000000;
+  uint64_t _bitDebt = 0;
+  uint8_t _cmd = 0;
+  uint8_t _argCount = 0;
+  uint16_t _x0 = 0, _x1 = WIDTH - 1, _y0 = 0, _y1 = HEIGHT - 1;
+  uint16_t _wx = 0, _wy = 0;
+  uint16_t _fb[WIDTH * HEIGHT];
+  uint8_t _touched[WIDTH * HEIGHT];
+  HostPanelStats _stats;
+};
+
+// Subset of Arduino_GFX: the primitives and classic-font text the firmware
+// uses, implemented with the same algorithms as the real library so pixel
+// output and bus traffic are representative.
+class Arduino_GFX : public Print {
+public:
+  Arduino_GFX(int16_t w, int16_t h) : _width(w), _height(h) {}
+
+  virtual bool begin(int32_t speed = GFX_NOT_DEFINED) = 0;
+  virtual void startWrite() = 0;
+  virtual void endWrite() = 0;
+  virtual void writePixelPreclipped(int16_t x, int16_t y, uint16_t color) = 0;
+  virtual void writeFillRectPreclipped(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) = 0;
+
+  int16_t width() const {
+    return _width;
+  }
+  int16_t height() const {
+    return _height;
+  }
+  void setRotation(uint8_t r) {
+    _rotation = r & 3;
+  }
+  void setCursor(int16_t x, int16_t y) {
+    _cursorX = x;
+    _cursorY = y;
+  }
+  int16_t getCursorX() const {
+    return _cursorX;
+  }
+  int16_t getCursorY() const {
+    return _cursorY;
+  }
+  void setTextSize(uint8_t s) {
+    _textSize = s ? s : 1;
+  }
+  void setTextColor(uint16_t c) {
+    _textColor = _textBgColor = c;
+  }
+  void setTextColor(uint16_t c, uint16_t bg) {
+    _textColor = c;
+    _textBgColor = bg;
+  }
+  void setTextWrap(bool w) {
+    _wrap = w;
+  }
+
+  void writePixel(int16_t x, int16_t y, uint16_t color) {
+    if (x >= 0 && x < _width && y >= 0 && y < _height)
+      writePixelPreclipped(x, y, color);
+  }
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if (w < 0) {
+      x += w + 1;
+      w = -w;
+    }
+    if (h < 0) {
+      y += h + 1;
+      h = -h;
+    }
+    if (x < 0) {
+      w += x;
+      x = 0;
+    }
+    if (y < 0) {
+      h += y;
+      y = 0;
+    }
+    if (x + w > _width)
+      w = _width - x;
+    if (y + h > _height)
+      h = _height - y;
+    if (w > 0 && h > 0)
+      writeFillRectPreclipped(x, y, w, h, color);
+  }
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    writeFillRect(x, y, 1, h, color);
+  }
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    writeFillRect(x, y, w, 1, color);
+  }
+  void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {
+      std::swap(x0, y0);
+      std::swap(x1, y1);
+    }
+    if (x0 > x1) {
+      std::swap(x0, x1);
+      std::swap(y0, y1);
+    }
+    int16_t dx = x1 - x0, dy = abs(y1 - y0);
+    int16_t err = dx / 2;
+    int16_t ystep = y0 < y1 ? 1 : -1;
+    for (; x0 <= x1; x0++) {
+      if (steep)
+        writePixel(y0, x0, color);
+      else
+        writePixel(x0, y0, color);
+      err -= dy;
+      if (err < 0) {
+        y0 += ystep;
+        err += dx;
+      }
+    }
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) {
+    startWrite();
+    writePixel(x, y, color);
+    endWrite();
+  }
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    startWrite();
+    writeFastVLine(x, y, h, color);
+    endWrite();
+  }
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    startWrite();
+    writeFastHLine(x, y, w, color);
+    endWrite();
+  }
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    startWrite();
+    writeFillRect(x, y, w, h, color);
+    endWrite();
+  }
+  void fillScreen(uint16_t color) {
+    fillRect(0, 0, _width, _height, color);
+  }
+  void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    startWrite();
+    if (x0 == x1)
+      writeFastVLine(x0, std::min(y0, y1), abs(y1 - y0) + 1, color);
+    else if (y0 == y1)
+      writeFastHLine(std::min(x0, x1), y0, abs(x1 - x0) + 1, color);
+    else
+      writeLine(x0, y0, x1, y1, color);
+    endWrite();
+  }
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    startWrite();
+    writeFastHLine(x, y, w, color);
+    writeFastHLine(x, y + h - 1, w, color);
+    writeFastVLine(x, y, h, color);
+    writeFastVLine(x + w - 1, y, h, color);
+    endWrite();
+  }
+
+  void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    startWrite();
+    writePixel(x0, y0 + r, color);
+    writePixel(x0, y0 - r, color);
+    writePixel(x0 + r, y0, color);
+    writePixel(x0 - r, y0, color);
+    drawCircleHelper(x0, y0, r, 0xF, color);
+    endWrite();
+  }
+  void drawCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, uint16_t color) {
+    int16_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r;
+    while (x < y) {
+      if (f >= 0) {
+        y--;
+        ddF_y += 2;
+        f += ddF_y;
+      }
+      x++;
+      ddF_x += 2;
+      f += ddF_x;
+      if (corners & 0x4) {
+        writePixel(x0 + x, y0 + y, color);
+        writePixel(x0 + y, y0 + x, color);
+      }
+      if (corners & 0x2) {
+        writePixel(x0 + x, y0 - y, color);
+        writePixel(x0 + y, y0 - x, color);
+      }
+      if (corners & 0x8) {
+        writePixel(x0 - y, y0 + x, color);
+        writePixel(x0 - x, y0 + y, color);
+      }
+      if (corners & 0x1) {
+        writePixel(x0 - y, y0 - x, color);
+        writePixel(x0 - x, y0 - y, color);
+      }
+    }
+  }
+  void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    startWrite();
+    writeFastVLine(x0, y0 - r, 2 * r + 1, color);
+    fillCircleHelper(x0, y0, r, 3, 0, color);
+    endWrite();
+  }
+  void fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, uint16_t color) {
+    int16_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r;
+    int16_t px = x, py = y;
+    delta++;
+    while (x < y) {
+      if (f >= 0) {
+        y--;
+        ddF_y += 2;
+        f += ddF_y;
+      }
+      x++;
+      ddF_x += 2;
+      f += ddF_x;
+      if (x < (y + 1)) {
+        if (corners & 1)
+          writeFastVLine(x0 + x, y0 - y, 2 * y + delta, color);
+        if (corners & 2)
+          writeFastVLine(x0 - x, y0 - y, 2 * y + delta, color);
+      }
+      if (y != py) {
+        if (corners & 1)
+          writeFastVLine(x0 + py, y0 - px, 2 * px + delta, color);
+        if (corners & 2)
+          writeFastVLine(x0 - py, y0 - px, 2 * px + delta, color);
+        py = y;
+      }
+      px = x;
+    }
+  }
+  void drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color) {
+    int16_t maxRadius = std::min(w, h) / 2;
+    if (r > maxRadius)
+      r = maxRadius;
+    startWrite();
+    writeFastHLine(x + r, y, w - 2 * r, color);
+    writeFastHLine(x + r, y + h - 1, w - 2 * r, color);
+    writeFastVLine(x, y + r, h - 2 * r, color);
+    writeFastVLine(x + w - 1, y + r, h - 2 * r, color);
+    drawCircleHelper(x + r, y + r, r, 1, color);
+    drawCircleHelper(x + w - r - 1, y + r, r, 2, color);
+    drawCircleHelper(x + w - r - 1, y + h - r - 1, r, 4, color);
+    drawCircleHelper(x + r, y + h - r - 1, r, 8, color);
+    endWrite();
+  }
+  void fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color) {
+    int16_t maxRadius = std::min(w, h) / 2;
+    if (r > maxRadius)
+      r = maxRadius;
+    startWrite();
+    writeFillRect(x + r, y, w - 2 * r, h, color);
+    fillCircleHelper(x + w - r - 1, y + r, r, 1, h - 2 * r - 1, color);
+    fillCircleHelper(x + r, y + r, r, 2, h - 2 * r - 1, color);
+    endWrite();
+  }
+  void drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color) {
+    drawLine(x0, y0, x1, y1, color);
+    drawLine(x1, y1, x2, y2, color);
+    drawLine(x2, y2, x0, y0, color);
+  }
+  void draw16bitRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h) {
+    startWrite();
+    for (int16_t j = 0; j < h; j++)
+      for (int16_t i = 0; i < w; i++)
+        writePixel(x + i, y + j, bitmap[j * w + i]);
+    endWrite();
+  }
+
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size) {
+    if (x >= _width || y >= _height || x + 6 * size - 1 < 0 || y + 8 * size - 1 < 0)
+      return;
+    const uint8_t *glyph = (c >= 0x20 && c <= 0x7E) ? hostGlcdFont[c - 0x20] : hostGlcdFont[0];
+    startWrite();
+    for (int8_t i = 0; i < 5; i++) {
+      uint8_t line = glyph[i];
+      for (int8_t j = 0; j < 8; j++, line >>= 1) {
+        if (line & 1) {
+          if (size == 1)
+            writePixel(x + i, y + j, color);
+          else
+            writeFillRect(x + i * size, y + j * size, size, size, color);
+        } else if (bg != color) {
+          if (size == 1)
+            writePixel(x + i, y + j, bg);
+          else
+            writeFillRect(x + i * size, y + j * size, size, size, bg);
+        }
+      }
+    }
+    if (bg != color) {
+      if (size == 1)
+        writeFastVLine(x + 5, y, 8, bg);
+      else
+        writeFillRect(x + 5 * size, y, size, 8 * size, bg);
+    }
+    endWrite();
+  }
+
+  using Print::write;
+  size_t write(uint8_t c) override {
+    if (c == '\n') {
+      _cursorX = 0;
+      _cursorY += _textSize * 8;
+    } else if (c != '\r') {
+      if (_wrap && (_cursorX + _textSize * 6 - 1) > _width - 1) {
+        _cursorX = 0;
+        _cursorY += _textSize * 8;
+      }
+      drawChar(_cursorX, _cursorY, c, _textColor, _textBgColor, _textSize);
+      _cursorX += _textSize * 6;
+    }
+    return 1;
+  }
+
+  void getTextBounds(const char *str, int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h) {
+    int16_t minx = _width, miny = _height, maxx = -1, maxy = -1;
+    for (; *str; str++) {
+      char c = *str;
+      if (c == '\n') {
+        x = 0;
+        y += _textSize * 8;
+        continue;
+      }
+      if (c == '\r')
+        continue;
+      if (_wrap && (x + _textSize * 6 - 1) > _width - 1) {
+        x = 0;
+        y += _textSize * 8;
+      }
+      int16_t x2 = x + _textSize * 6 - 1, y2 = y + _textSize * 8 - 1;
+      minx = std::min(minx, x);
+      miny = std::min(miny, y);
+      maxx = std::max(maxx, x2);
+      maxy = std::max(maxy, y2);
+      x += _textSize * 6;
+    }
+    *x1 = minx;
+    *y1 = miny;
+    *w = maxx >= minx ? maxx - minx + 1 : 0;
+    *h = maxy >= miny ? maxy - miny + 1 : 0;
+  }
+  void getTextBounds(const String &str, int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h) {
+    getTextBounds(str.c_str(), x, y, x1, y1, w, h);
+  }
+
+protected:
+  int16_t _width, _height;
+  uint8_t _rotation = 0;
+  int16_t _cursorX = 0, _cursorY = 0;
+  uint8_t _textSize = 1;
+  uint16_t _textColor = WHITE, _textBgColor = WHITE;
+  bool _wrap = true;
+};
+
+class Arduino_ILI9341 : public Arduino_GFX {
+public:
+  Arduino_ILI9341(Arduino_DataBus *bus, int8_t rst = GFX_NOT_DEFINED, uint8_t r = 0, bool ips = false)
+    : Arduino_GFX(ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT), _bus(bus) {
+    (void)rst, (void)ips;
+    setRotation(r);
+  }
+
+  bool begin(int32_t speed = GFX_NOT_DEFINED) override {
+    return _bus->begin(speed);
+  }
+  void startWrite() override {
+    _bus->beginWrite();
+  }
+  void endWrite() override {
+    _bus->endWrite();
+  }
+  void writeAddrWindow(int16_t x, int16_t y, uint16_t w, uint16_t h) {
+    if (x != _currentX || w != _currentW) {
+      _bus->writeC8D16D16(ILI9341_CASET, x, x + w - 1);
+      _currentX = x;
+      _currentW = w;
+    }
+    if (y != _currentY || h != _currentH) {
+      _bus->writeC8D16D16(ILI9341_PASET, y, y + h - 1);
+      _currentY = y;
+      _currentH = h;
+    }
+    _bus->writeCommand(ILI9341_RAMWR);
+  }
+  void writePixelPreclipped(int16_t x, int16_t y, uint16_t color) override {
+    writeAddrWindow(x, y, 1, 1);
+    _bus->write16(color);
+  }
+  void writeFillRectPreclipped(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override {
+    writeAddrWindow(x, y, w, h);
+    _bus->writeRepeat(color, (uint32_t)w * h);
+  }
+
+protected:
+  Arduino_DataBus *_bus;
+  int16_t _currentX = -1, _currentY = -1;
+  uint16_t _currentW = 0, _currentH = 0;
+};
+
+#endif  // HOST_ARDUINO_GFX_LIBRARY_H_
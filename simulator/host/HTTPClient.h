@@ -0,0 +1,34 @@
+// HTTPClient shim: every request fails with a connection error so host
+// runs never touch the network.
+#ifndef HOST_HTTPCLIENT_H_
+#define HOST_HTTPCLIENT_H_
+
+#include "WiFiClientSecure.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+
+class HTTPClient {
+public:
+  bool begin(const String &) {
+    return true;
+  }
+  bool begin(WiFiClientSecure &, const String &) {
+    return true;
+  }
+  void addHeader(const String &, const String &) {}
+  int GET() {
+    return HTTPC_ERROR_CONNECTION_REFUSED;
+  }
+  int POST(const String &) {
+    return HTTPC_ERROR_CONNECTION_REFUSED;
+  }
+  int PATCH(const String &) {
+    return HTTPC_ERROR_CONNECTION_REFUSED;
+  }
+  String getString() {
+    return String();
+  }
+  void end() {}
+};
+
+#endif  // HOST_HTTPCLIENT_H_
@@ -0,0 +1,74 @@
+// Keypad library shim: keys are injected by the host driver instead of
+// being scanned from a matrix. Each injected key is held closed for
+// HOST_KEY_DOWN_US of virtual time, long enough for KeypadScanner's
+// debounce, then released; the next one follows.
+#ifndef HOST_KEYPAD_H_
+#define HOST_KEYPAD_H_
+
+#include "Arduino.h"
+#include <deque>
+
+#define NO_KEY '\0'
+#define makeKeymap(x) ((char *)x)
+#define LIST_MAX 10
+#define HOST_KEY_DOWN_US 40000
+
+typedef enum { IDLE, PRESSED, HOLD, RELEASED } KeyState;
+
+struct Key {
+  char kchar = NO_KEY;
+  int kcode = -1;
+  KeyState kstate = IDLE;
+  bool stateChanged = false;
+};
+
+class Keypad {
+public:
+  Keypad(char *userKeymap, byte *row, byte *col, byte numRows, byte numCols) {
+    (void)userKeymap, (void)row, (void)col, (void)numRows, (void)numCols;
+  }
+  char getKey() {
+    if (pending.empty())
+      return NO_KEY;
+    char k = pending.front();
+    pending.pop_front();
+    return k;
+  }
+  // Reports the next injected key as PRESSED until it has been down for
+  // HOST_KEY_DOWN_US, then RELEASED, then gone.
+  bool getKeys() {
+    Key &k = key[0];
+    k.stateChanged = false;
+    if (k.kstate == PRESSED) {
+      if (micros() - downUs < HOST_KEY_DOWN_US)
+        return false;
+      k.kstate = RELEASED;
+    } else if (k.kstate == RELEASED) {
+      k = Key();
+    } else {
+      if (pending.empty())
+        return false;
+      k.kchar = pending.front();
+      k.kstate = PRESSED;
+      downUs = micros();
+      pending.pop_front();
+    }
+    k.stateChanged = true;
+    return true;
+  }
+  void setDebounceTime(unsigned int) {}
+  void setHoldTime(unsigned int) {}
+
+  // Host-only: queue a key press.
+  void press(char k) {
+    pending.push_back(k);
+  }
+
+  Key key[LIST_MAX];
+
+private:
+  std::deque<char> pending;
+  unsigned long downUs = 0;
+};
+
+#endif  // HOST_KEYPAD_H_
@@ -0,0 +1,69 @@
+// Preferences (NVS) shim for host builds: namespaces and keys live in memory
+// for the life of the process.
+#ifndef HOST_PREFERENCES_H_
+#define HOST_PREFERENCES_H_
+
+#include "Arduino.h"
+#include <map>
+#include <string>
+#include <vector>
+
+inline std::map<std::string, std::vector<uint8_t>> &hostNvs() {
+  static std::map<std::string, std::vector<uint8_t>> nvs;
+  return nvs;
+}
+
+class Preferences {
+public:
+  bool begin(const char *name, bool readOnly = false) {
+    _ns = name;
+    _readOnly = readOnly;
+    return true;
+  }
+  void end() {}
+
+  bool isKey(const char *key) {
+    return hostNvs().count(path(key)) != 0;
+  }
+  bool remove(const char *key) {
+    return !_readOnly && hostNvs().erase(path(key)) != 0;
+  }
+
+  size_t putUInt(const char *key, uint32_t value) {
+    return putBytes(key, &value, sizeof(value));
+  }
+  uint32_t getUInt(const char *key, uint32_t defaultValue = 0) {
+    uint32_t value = defaultValue;
+    getBytes(key, &value, sizeof(value));
+    return value;
+  }
+
+  size_t putBytes(const char *key, const void *value, size_t len) {
+    if (_readOnly)
+      return 0;
+    const uint8_t *p = (const uint8_t *)value;
+    hostNvs()[path(key)] = std::vector<uint8_t>(p, p + len);
+    return len;
+  }
+  size_t getBytesLength(const char *key) {
+    auto it = hostNvs().find(path(key));
+    return it == hostNvs().end() ? 0 : it->second.size();
+  }
+  size_t getBytes(const char *key, void *buf, size_t maxLen) {
+    auto it = hostNvs().find(path(key));
+    if (it == hostNvs().end() || it->second.size() > maxLen)
+      return 0;
+    memcpy(buf, it->second.data(), it->second.size());
+    return it->second.size();
+  }
+
+private:
+  std::string path(const char *key) const {
+    return _ns + "/" + key;
+  }
+
+  std::string _ns;
+  bool _readOnly = false;
+};
+
+#endif  // HOST_PREFERENCES_H_
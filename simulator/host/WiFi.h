@@ -0,0 +1,34 @@
+// WiFi shim: always reports a connection so the firmware follows its
+// online code paths; HTTPClient then fails every request.
+#ifndef HOST_WIFI_H_
+#define HOST_WIFI_H_
+
+#include "Arduino.h"
+
+#define WIFI_STA 1
+#define WL_CONNECTED 3
+#define WL_DISCONNECTED 6
+
+class IPAddress {
+public:
+  operator String() const {
+    return String("127.0.0.1");
+  }
+};
+
+class HostWiFi {
+public:
+  void disconnect(bool = false) {}
+  void mode(int) {}
+  void begin(const char *, const char * = nullptr) {}
+  int status() {
+    return WL_CONNECTED;
+  }
+  String localIP() {
+    return String("127.0.0.1");
+  }
+};
+
+inline HostWiFi WiFi;
+
+#endif  // HOST_WIFI_H_
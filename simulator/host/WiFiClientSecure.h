@@ -0,0 +1,11 @@
+#ifndef HOST_WIFICLIENTSECURE_H_
+#define HOST_WIFICLIENTSECURE_H_
+
+#include "WiFi.h"
+
+class WiFiClientSecure {
+public:
+  void setInsecure() {}
+};
+
+#endif  // HOST_WIFICLIENTSECURE_H_
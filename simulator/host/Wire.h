@@ -0,0 +1,36 @@
+// Wire shim for host builds: an empty I2C bus. Every address NACKs, so
+// drivers see "no device" and stay disabled.
+#ifndef HOST_WIRE_H_
+#define HOST_WIRE_H_
+
+#include "Arduino.h"
+
+class TwoWire {
+public:
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) {
+    (void)sda, (void)scl, (void)frequency;
+    return true;
+  }
+  void setClock(uint32_t) {}
+  void beginTransmission(uint8_t) {}
+  size_t write(uint8_t) {
+    return 1;
+  }
+  uint8_t endTransmission(bool sendStop = true) {
+    (void)sendStop;
+    return 2;  // Address NACK
+  }
+  uint8_t requestFrom(uint8_t, uint8_t) {
+    return 0;
+  }
+  int available() {
+    return 0;
+  }
+  int read() {
+    return -1;
+  }
+};
+
+inline TwoWire Wire;
+
+#endif  // HOST_WIRE_H_
@@ -0,0 +1,64 @@
+// RMT shim for host builds. A write records the symbols and keeps the
+// channel busy for as long as the real peripheral would take to clock them
+// out (on the virtual clock), so code that waits for completion or skips a
+// frame while busy behaves as on the device.
+#ifndef HOST_ESP32_HAL_RMT_H_
+#define HOST_ESP32_HAL_RMT_H_
+
+#include "Arduino.h"
+#include <vector>
+
+typedef union {
+  struct {
+    uint32_t duration0 : 15;
+    uint32_t level0 : 1;
+    uint32_t duration1 : 15;
+    uint32_t level1 : 1;
+  };
+  uint32_t val;
+} rmt_data_t;
+
+typedef enum { RMT_RX_MODE = 0, RMT_TX_MODE = 1 } rmt_ch_dir_t;
+typedef enum { RMT_MEM_NUM_BLOCKS_1 = 1, RMT_MEM_NUM_BLOCKS_2 = 2 } rmt_reserve_memsize_t;
+
+#define RMT_WAIT_FOR_EVER ((uint32_t)0x7FFFFFFF)
+
+// Host-only: the one TX channel the firmware uses.
+struct HostRmt {
+  uint32_t tickHz = 0;
+  uint64_t busyUntilUs = 0;
+  uint32_t writes = 0;
+  std::vector<rmt_data_t> last;  // Symbols of the most recent write
+};
+inline HostRmt &hostRmt() {
+  static HostRmt rmt;
+  return rmt;
+}
+
+inline bool rmtInit(int, rmt_ch_dir_t, rmt_reserve_memsize_t, uint32_t frequency_Hz) {
+  hostRmt().tickHz = frequency_Hz;
+  return frequency_Hz > 0;
+}
+inline bool rmtTransmitCompleted(int) {
+  return hostClockUs() >= hostRmt().busyUntilUs;
+}
+inline bool rmtWriteAsync(int pin, rmt_data_t *data, size_t numSymbols) {
+  HostRmt &rmt = hostRmt();
+  if (!rmt.tickHz || !rmtTransmitCompleted(pin))
+    return false;
+  uint64_t ticks = 0;
+  for (size_t i = 0; i < numSymbols; i++)
+    ticks += data[i].duration0 + data[i].duration1;
+  rmt.last.assign(data, data + numSymbols);
+  rmt.busyUntilUs = hostClockUs() + ticks * 1000000 / rmt.tickHz;
+  rmt.writes++;
+  return true;
+}
+inline bool rmtWrite(int pin, rmt_data_t *data, size_t numSymbols, uint32_t) {
+  if (!rmtWriteAsync(pin, data, numSymbols))
+    return false;
+  hostAdvanceUs(hostRmt().busyUntilUs - hostClockUs());
+  return true;
+}
+
+#endif  // HOST_ESP32_HAL_RMT_H_
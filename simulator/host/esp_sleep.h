@@ -0,0 +1,39 @@
+// esp_sleep shim for host builds. The host never sleeps: light sleep
+// returns at once, as if its timer had fired, without moving the virtual
+// clock, so state_machine_test idling on the games menu keeps its timing.
+#ifndef HOST_ESP_SLEEP_H_
+#define HOST_ESP_SLEEP_H_
+
+#include "esp_timer.h"
+
+typedef enum {
+  ESP_SLEEP_WAKEUP_UNDEFINED,
+  ESP_SLEEP_WAKEUP_ALL,
+  ESP_SLEEP_WAKEUP_EXT0,
+  ESP_SLEEP_WAKEUP_EXT1,
+  ESP_SLEEP_WAKEUP_TIMER,
+  ESP_SLEEP_WAKEUP_TOUCHPAD,
+  ESP_SLEEP_WAKEUP_ULP,
+  ESP_SLEEP_WAKEUP_GPIO,
+  ESP_SLEEP_WAKEUP_UART
+} esp_sleep_wakeup_cause_t;
+
+typedef esp_sleep_wakeup_cause_t esp_sleep_source_t;
+
+inline esp_err_t esp_sleep_enable_timer_wakeup(uint64_t) {
+  return ESP_OK;
+}
+inline esp_err_t esp_sleep_enable_gpio_wakeup() {
+  return ESP_OK;
+}
+inline esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t) {
+  return ESP_OK;
+}
+inline esp_err_t esp_light_sleep_start() {
+  return ESP_OK;
+}
+inline esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() {
+  return ESP_SLEEP_WAKEUP_TIMER;
+}
+
+#endif  // HOST_ESP_SLEEP_H_
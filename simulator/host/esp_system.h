@@ -0,0 +1,33 @@
+// esp_system shim for host builds. Nothing restarts the host: the watchdog
+// task that would call esp_restart() never runs, and every boot is a
+// power-on.
+#ifndef HOST_ESP_SYSTEM_H_
+#define HOST_ESP_SYSTEM_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef enum {
+  ESP_RST_UNKNOWN,
+  ESP_RST_POWERON,
+  ESP_RST_EXT,
+  ESP_RST_SW,
+  ESP_RST_PANIC,
+  ESP_RST_INT_WDT,
+  ESP_RST_TASK_WDT,
+  ESP_RST_WDT,
+  ESP_RST_DEEPSLEEP,
+  ESP_RST_BROWNOUT,
+  ESP_RST_SDIO
+} esp_reset_reason_t;
+
+inline esp_reset_reason_t esp_reset_reason() {
+  return ESP_RST_POWERON;
+}
+
+inline void esp_restart() {
+  fprintf(stderr, "esp_restart()\n");
+  exit(0);
+}
+
+#endif  // HOST_ESP_SYSTEM_H_
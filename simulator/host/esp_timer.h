@@ -0,0 +1,91 @@
+// esp_timer shim for host builds: time comes from the virtual clock, and
+// one-shot timers fire as hostAdvanceUs() moves the clock past them, each
+// with the clock set to its deadline. Callbacks run on the caller's stack
+// in deadline order.
+#ifndef HOST_ESP_TIMER_H_
+#define HOST_ESP_TIMER_H_
+
+#include "Arduino.h"
+#include <vector>
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_INVALID_STATE 0x103
+
+typedef void (*esp_timer_cb_t)(void *arg);
+
+typedef enum {
+  ESP_TIMER_TASK,
+  ESP_TIMER_ISR
+} esp_timer_dispatch_t;
+
+typedef struct {
+  esp_timer_cb_t callback;
+  void *arg;
+  esp_timer_dispatch_t dispatch_method;
+  const char *name;
+  bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+struct esp_timer {
+  esp_timer_cb_t callback;
+  void *arg;
+  bool armed;
+  uint64_t dueUs;
+};
+typedef struct esp_timer *esp_timer_handle_t;
+
+inline int64_t esp_timer_get_time() {
+  return (int64_t)hostClockUs();
+}
+
+inline std::vector<esp_timer_handle_t> &hostTimers() {
+  static std::vector<esp_timer_handle_t> timers;
+  return timers;
+}
+
+inline void hostRunTimers(uint64_t endUs) {
+  static bool running = false;  // A callback that advances the clock mustn't re-enter
+  if (running)
+    return;
+  running = true;
+  for (;;) {
+    esp_timer_handle_t next = nullptr;
+    for (esp_timer_handle_t t : hostTimers()) {
+      if (t->armed && t->dueUs <= endUs && (!next || t->dueUs < next->dueUs))
+        next = t;
+    }
+    if (!next)
+      break;
+    if (next->dueUs > hostClockUs())
+      hostClockUs() = next->dueUs;
+    next->armed = false;
+    next->callback(next->arg);
+  }
+  running = false;
+}
+
+inline esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out) {
+  *out = new esp_timer{ args->callback, args->arg, false, 0 };
+  hostTimers().push_back(*out);
+  hostTimerHook() = hostRunTimers;
+  return ESP_OK;
+}
+
+inline esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutUs) {
+  if (timer->armed)
+    return ESP_ERR_INVALID_STATE;
+  timer->armed = true;
+  timer->dueUs = hostClockUs() + timeoutUs;
+  return ESP_OK;
+}
+
+inline esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+  if (!timer->armed)
+    return ESP_ERR_INVALID_STATE;
+  timer->armed = false;
+  return ESP_OK;
+}
+
+#endif  // HOST_ESP_TIMER_H_
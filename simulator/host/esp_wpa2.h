@@ -0,0 +1,4 @@
+// WPA2-Enterprise is never used on the host (WOKWI_SIMULATION is defined).
+#ifndef HOST_ESP_WPA2_H_
+#define HOST_ESP_WPA2_H_
+#endif  // HOST_ESP_WPA2_H_
@@ -0,0 +1,43 @@
+// Queue shim for host builds: fixed-size FIFO of byte copies, never blocks.
+#ifndef HOST_FREERTOS_QUEUE_H_
+#define HOST_FREERTOS_QUEUE_H_
+
+#include "FreeRTOS.h"
+#include <deque>
+#include <string.h>
+#include <vector>
+
+struct HostQueue {
+  size_t itemSize;
+  size_t capacity;
+  std::deque<std::vector<uint8_t>> items;
+};
+typedef HostQueue *QueueHandle_t;
+
+inline QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+  return new HostQueue{ itemSize, length, {} };
+}
+inline BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t) {
+  if (q->items.size() >= q->capacity)
+    return pdFAIL;
+  const uint8_t *p = (const uint8_t *)item;
+  q->items.emplace_back(p, p + q->itemSize);
+  return pdPASS;
+}
+inline BaseType_t xQueueSendFromISR(QueueHandle_t q, const void *item, BaseType_t *woken) {
+  if (woken)
+    *woken = pdFALSE;
+  return xQueueSend(q, item, 0);
+}
+inline BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t) {
+  if (q->items.empty())
+    return pdFAIL;
+  memcpy(item, q->items.front().data(), q->itemSize);
+  q->items.pop_front();
+  return pdPASS;
+}
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) {
+  return q->items.size();
+}
+
+#endif  // HOST_FREERTOS_QUEUE_H_
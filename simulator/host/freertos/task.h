@@ -0,0 +1,51 @@
+// Task shim for host builds. xTaskCreatePinnedToCore() records nothing and
+// never runs the task: the host drives everything from loop(). Delays
+// advance the virtual clock like delay() does.
+#ifndef HOST_FREERTOS_TASK_H_
+#define HOST_FREERTOS_TASK_H_
+
+#include "FreeRTOS.h"
+#include "../Arduino.h"
+
+typedef void (*TaskFunction_t)(void *);
+typedef struct HostTask *TaskHandle_t;
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char *, uint32_t, void *, UBaseType_t,
+                                          TaskHandle_t *handle, BaseType_t) {
+  if (handle)
+    *handle = nullptr;
+  return pdPASS;
+}
+inline BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack, void *arg, UBaseType_t prio,
+                              TaskHandle_t *handle) {
+  return xTaskCreatePinnedToCore(fn, name, stack, arg, prio, handle, 0);
+}
+inline void vTaskDelay(TickType_t ticks) {
+  delay(ticks);
+}
+inline TickType_t xTaskGetTickCount() {
+  return (TickType_t)millis();
+}
+inline void vTaskDelayUntil(TickType_t *wake, TickType_t period) {
+  *wake += period;
+  if ((int32_t)(*wake - millis()) > 0)
+    delay(*wake - millis());
+}
+inline uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) {
+  return 0;
+}
+inline BaseType_t xTaskNotifyGive(TaskHandle_t) {
+  return pdPASS;
+}
+inline void vTaskNotifyGiveFromISR(TaskHandle_t, BaseType_t *woken) {
+  if (woken)
+    *woken = pdFALSE;
+}
+inline TaskHandle_t xTaskGetCurrentTaskHandle() {
+  return nullptr;
+}
+inline BaseType_t xPortGetCoreID() {
+  return 1;
+}
+
+#endif  // HOST_FREERTOS_TASK_H_
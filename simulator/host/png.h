@@ -0,0 +1,162 @@
+// Minimal PNG read/write for RGB565 framebuffers (host only, uses zlib).
+// writePng() produces 8-bit RGB with filter type 0 on every row. readPng()
+// also accepts what image editors usually save: 8-bit RGB or RGBA with any
+// row filter, no interlace. Alpha is composited onto white.
+#ifndef HOST_PNG_H_
+#define HOST_PNG_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+inline void pngPut32(std::vector<uint8_t> &out, uint32_t v) {
+  out.push_back(v >> 24);
+  out.push_back(v >> 16);
+  out.push_back(v >> 8);
+  out.push_back(v);
+}
+
+inline uint32_t pngGet32(const uint8_t *p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+inline void pngChunk(std::vector<uint8_t> &out, const char *type, const uint8_t *data, uint32_t len) {
+  pngPut32(out, len);
+  size_t start = out.size();
+  out.insert(out.end(), type, type + 4);
+  out.insert(out.end(), data, data + len);
+  pngPut32(out, crc32(0, &out[start], len + 4));
+}
+
+// Expand to 8 bits per channel the way the panel does (replicate high bits).
+inline void rgb565ToRgb888(uint16_t c, uint8_t *rgb) {
+  uint8_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+  rgb[0] = (r << 3) | (r >> 2);
+  rgb[1] = (g << 2) | (g >> 4);
+  rgb[2] = (b << 3) | (b >> 2);
+}
+
+inline uint16_t rgb888ToRgb565(const uint8_t *rgb) {
+  return ((rgb[0] & 0xF8) << 8) | ((rgb[1] & 0xFC) << 3) | (rgb[2] >> 3);
+}
+
+inline bool writePng(const std::string &path, const uint16_t *fb, int w, int h) {
+  std::vector<uint8_t> raw;
+  raw.reserve((size_t)h * (w * 3 + 1));
+  for (int y = 0; y < h; y++) {
+    raw.push_back(0);  // Filter: none
+    for (int x = 0; x < w; x++) {
+      uint8_t rgb[3];
+      rgb565ToRgb888(fb[y * w + x], rgb);
+      raw.insert(raw.end(), rgb, rgb + 3);
+    }
+  }
+  uLongf zlen = compressBound(raw.size());
+  std::vector<uint8_t> z(zlen);
+  if (compress2(z.data(), &zlen, raw.data(), raw.size(), Z_BEST_COMPRESSION) != Z_OK)
+    return false;
+
+  static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+  std::vector<uint8_t> out(signature, signature + 8);
+  std::vector<uint8_t> ihdr;
+  pngPut32(ihdr, w);
+  pngPut32(ihdr, h);
+  ihdr.insert(ihdr.end(), { 8, 2, 0, 0, 0 });  // 8-bit, RGB, deflate, filter 0, no interlace
+  pngChunk(out, "IHDR", ihdr.data(), ihdr.size());
+  pngChunk(out, "IDAT", z.data(), zlen);
+  pngChunk(out, "IEND", nullptr, 0);
+
+  FILE *f = fopen(path.c_str(), "wb");
+  if (!f)
+    return false;
+  bool ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+  return fclose(f) == 0 && ok;
+}
+
+inline uint8_t pngPaeth(int a, int b, int c) {
+  int p = a + b - c, pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+  if (pa <= pb && pa <= pc)
+    return a;
+  return pb <= pc ? b : c;
+}
+
+// Reads an 8-bit RGB/RGBA PNG into RGB565. Returns false for missing files
+// and for anything outside that subset (palette, 16-bit, interlaced).
+inline bool readPng(const std::string &path, std::vector<uint16_t> &fb, int &w, int &h) {
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f)
+    return false;
+  std::vector<uint8_t> in;
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+    in.insert(in.end(), buf, buf + n);
+  fclose(f);
+
+  if (in.size() < 8 || memcmp(in.data(), "\x89PNG\r\n\x1A\n", 8) != 0)
+    return false;
+  std::vector<uint8_t> z;
+  int channels = 0;
+  w = h = 0;
+  for (size_t pos = 8; pos + 12 <= in.size();) {
+    uint32_t len = pngGet32(&in[pos]);
+    const char *type = (const char *)&in[pos + 4];
+    const uint8_t *data = &in[pos + 8];
+    if (pos + 12 + len > in.size())
+      return false;
+    if (memcmp(type, "IHDR", 4) == 0) {
+      w = pngGet32(data);
+      h = pngGet32(data + 4);
+      channels = data[9] == 2 ? 3 : data[9] == 6 ? 4 : 0;
+      if (data[8] != 8 || !channels || data[12] != 0)
+        return false;
+    } else if (memcmp(type, "IDAT", 4) == 0) {
+      z.insert(z.end(), data, data + len);
+    }
+    pos += 12 + len;
+  }
+  if (w <= 0 || h <= 0)
+    return false;
+
+  size_t stride = (size_t)w * channels;
+  uLongf rawLen = (uLongf)h * (stride + 1);
+  std::vector<uint8_t> raw(rawLen);
+  if (uncompress(raw.data(), &rawLen, z.data(), z.size()) != Z_OK || rawLen != raw.size())
+    return false;
+
+  // Undo the row filters in place; each row refers to the unfiltered one above.
+  std::vector<uint8_t> prev(stride, 0);
+  fb.resize((size_t)w * h);
+  for (int y = 0; y < h; y++) {
+    uint8_t *row = &raw[(size_t)y * (stride + 1)];
+    uint8_t filter = *row++;
+    for (size_t i = 0; i < stride; i++) {
+      int a = i >= (size_t)channels ? row[i - channels] : 0;
+      int b = prev[i];
+      int c = i >= (size_t)channels ? prev[i - channels] : 0;
+      switch (filter) {
+        case 0: break;
+        case 1: row[i] += a; break;
+        case 2: row[i] += b; break;
+        case 3: row[i] += (a + b) / 2; break;
+        case 4: row[i] += pngPaeth(a, b, c); break;
+        default: return false;
+      }
+    }
+    memcpy(prev.data(), row, stride);
+    for (int x = 0; x < w; x++) {
+      uint8_t rgb[3];
+      const uint8_t *px = row + x * channels;
+      for (int k = 0; k < 3; k++)
+        rgb[k] = channels == 4 ? (px[k] * px[3] + 255 * (255 - px[3])) / 255 : px[k];
+      fb[y * w + x] = rgb888ToRgb565(rgb);
+    }
+  }
+  return true;
+}
+
+#endif  // HOST_PNG_H_
@@ -0,0 +1,117 @@
+// Checks ReactionStats against exact results: mean and variance from two
+// passes over the samples, and the P² median and 90th percentile against
+// the sorted samples, for a few thousand draws from several known
+// distributions. Up to five samples the quantiles must be exact.
+//
+//   g++ -std=c++20 -O2 host/reaction_stats_test.cpp -o reaction_stats_test
+//   ./reaction_stats_test
+//
+// Prints one line per check. Exit status is 1 if any fails.
+#include "../reaction_stats.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#define STATS_SAMPLES 3000
+#define STATS_QUANTILE_TOLERANCE 0.02  // Of the exact quantile
+
+static int failures = 0;
+
+static void check(const std::string &what, bool ok, const std::string &detail = "") {
+  printf("%-40s %-4s %s\n", what.c_str(), ok ? "ok" : "FAIL", detail.c_str());
+  if (!ok)
+    failures++;
+}
+
+// The sample P2Quantile::value() picks while it is still exact
+static double nearestRank(std::vector<uint32_t> sorted, double p) {
+  std::sort(sorted.begin(), sorted.end());
+  return sorted[(size_t)(p * (sorted.size() - 1) + 0.5)];
+}
+
+static std::string pair(double got, double want) {
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.1f, exact %.1f", got, want);
+  return buf;
+}
+
+static void checkSamples(const char *name, const std::vector<uint32_t> &samples) {
+  ReactionStats stats;
+  for (uint32_t us : samples)
+    stats.add(us);
+
+  double mean = 0;
+  for (uint32_t us : samples)
+    mean += us;
+  mean /= samples.size();
+  double m2 = 0;
+  for (uint32_t us : samples)
+    m2 += (us - mean) * (us - mean);
+  double variance = samples.size() > 1 ? m2 / (samples.size() - 1) : 0;
+
+  std::string what = name;
+  check(what + " mean", fabs(stats.mean() - mean) <= 1e-9 * mean, pair(stats.mean(), mean));
+  check(what + " variance", fabs(stats.variance() - variance) <= 1e-9 * variance + 1e-9,
+        pair(stats.variance(), variance));
+  check(what + " min/max", stats.min() == *std::min_element(samples.begin(), samples.end())
+                               && stats.max() == *std::max_element(samples.begin(), samples.end()));
+
+  double p50 = nearestRank(samples, 0.5), p90 = nearestRank(samples, 0.9);
+  if (samples.size() <= 5) {
+    check(what + " p50", stats.p50() == p50, pair(stats.p50(), p50));
+    check(what + " p90", stats.p90() == p90, pair(stats.p90(), p90));
+  } else {
+    check(what + " p50", fabs(stats.p50() - p50) <= STATS_QUANTILE_TOLERANCE * p50, pair(stats.p50(), p50));
+    check(what + " p90", fabs(stats.p90() - p90) <= STATS_QUANTILE_TOLERANCE * p90, pair(stats.p90(), p90));
+  }
+}
+
+template <typename Draw>
+static std::vector<uint32_t> draw(Draw next) {
+  std::mt19937 rng(12345);
+  std::vector<uint32_t> samples;
+  while (samples.size() < STATS_SAMPLES) {
+    double us = next(rng);
+    if (us > 0)
+      samples.push_back((uint32_t)us);
+  }
+  return samples;
+}
+
+int main() {
+  ReactionStats empty;
+  check("no samples", empty.count() == 0 && empty.mean() == 0 && empty.variance() == 0 && empty.p50() == 0
+                          && empty.p90() == 0);
+  checkSamples("1 sample", { 250000 });
+  checkSamples("2 samples", { 310000, 190000 });
+  checkSamples("3 samples", { 400000, 100000, 300000 });
+  checkSamples("5 samples", { 5000, 1000, 4000, 2000, 3000 });
+
+  std::uniform_real_distribution<double> uniform(150000, 600000);
+  checkSamples("uniform", draw([&](std::mt19937 &rng) { return uniform(rng); }));
+  std::normal_distribution<double> normal(300000, 50000);
+  checkSamples("normal", draw([&](std::mt19937 &rng) { return normal(rng); }));
+  // Reaction times are skewed right: a normal with an exponential tail
+  std::normal_distribution<double> base(250000, 30000);
+  std::exponential_distribution<double> tail(1.0 / 100000);
+  checkSamples("ex-Gaussian", draw([&](std::mt19937 &rng) { return base(rng) + tail(rng); }));
+  std::lognormal_distribution<double> lognormal(log(320000), 0.35);
+  checkSamples("lognormal", draw([&](std::mt19937 &rng) { return lognormal(rng); }));
+
+  // A player warming up: every sample faster than the one before
+  std::vector<uint32_t> falling;
+  for (uint32_t i = 0; i < STATS_SAMPLES; i++)
+    falling.push_back(800000 - i * 150);
+  checkSamples("steadily falling", falling);
+
+  ReactionStats stats;
+  stats.add(1000);
+  stats.add(2000);
+  stats.reset();
+  stats.add(7000);
+  check("reset starts over", stats.count() == 1 && stats.mean() == 7000 && stats.p50() == 7000 && stats.min() == 7000);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,170 @@
+// Benchmarks the compressed image assets against the alternatives:
+//
+//   old screen  what the screen drew before the asset existed
+//   primitives  the same artwork drawn with Arduino_GFX calls (banners:
+//               round rects and text; star and ring: one drawPixel per
+//               non-background pixel)
+//   raw         the same pixels as an uncompressed RGB565 bitmap
+//   rle         drawRleImage() onto a white screen, background skipped
+//
+// Bus columns come from the emulated panel at 40 MHz; "decode ns" is host
+// CPU time to walk the runs, a rough proxy for the decode cost on device.
+//
+//   g++ -std=c++20 -O2 -I host host/rle_bench.cpp -lz -o rle_bench && ./rle_bench
+#include <Arduino_GFX_Library.h>
+#include "../rle_image.h"
+#include "../assets/star.h"
+#include "../assets/loading_ring.h"
+#include "../assets/code_breaker_title.h"
+#include "../assets/color_word_title.h"
+#include "../assets/led_reaction_title.h"
+
+#include <chrono>
+#include <vector>
+
+static Arduino_ESP32SPI bus(0);
+static Arduino_ILI9341 display(&bus);
+
+struct Asset {
+  const char *name;
+  const RleImage *image;
+  void (*oldScreen)();
+  void (*primitives)(int16_t x, int16_t y);  // nullptr: per-pixel from the image
+};
+
+static void printCentered(const char *text, uint8_t size, int16_t y) {
+  int16_t x1, y1;
+  uint16_t w, h;
+  display.setTextSize(size);
+  display.getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
+  display.setCursor((240 - w) / 2, y);
+  display.print(text);
+}
+
+// Title banner as drawn when the asset was made (assets/src/*.png).
+static void banner(int16_t x, int16_t y, const char *text, uint16_t color) {
+  int16_t x1, y1;
+  uint16_t w, h;
+  display.fillRoundRect(x + 3, y + 3, 200, 48, 10, LIGHTGREY);
+  display.fillRoundRect(x, y, 200, 48, 10, color);
+  display.drawRoundRect(x, y, 200, 48, 10, BLACK);
+  display.setTextSize(2);
+  display.getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
+  display.setTextColor(BLACK);
+  display.setCursor(x + (200 - w) / 2 + 1, y + 18);
+  display.print(text);
+  display.setTextColor(WHITE);
+  display.setCursor(x + (200 - w) / 2, y + 17);
+  display.print(text);
+}
+
+static const Asset assets[] = {
+  { "5 stars", &starImage,
+    [] {
+      display.setTextColor(GREEN);
+      printCentered("* * * * * ", 3, 120);
+    },
+    nullptr },
+  { "loading ring", &loadingRingImage, [] { display.drawCircle(120, 130, 40, BLACK); }, nullptr },
+  { "code breaker title", &codeBreakerTitleImage,
+    [] {
+      display.setTextColor(BLACK);
+      display.setTextSize(2);
+      display.setCursor(30, 100);
+      display.print("Code breaker game");
+    },
+    [](int16_t x, int16_t y) { banner(x, y, "Code Breaker", NAVY); } },
+  { "color word title", &colorWordTitleImage,
+    [] {
+      display.setTextColor(BLACK);
+      printCentered("Color Word", 2, 100);
+    },
+    [](int16_t x, int16_t y) { banner(x, y, "Color Word", PURPLE); } },
+  { "led reaction title", &ledReactionTitleImage,
+    [] {
+      display.setTextColor(BLACK);
+      printCentered("Led Reaction", 2, 100);
+    },
+    [](int16_t x, int16_t y) { banner(x, y, "Led Reaction", MAROON); } },
+};
+
+struct BusCost {
+  uint32_t transactions;
+  uint64_t bytes;
+  uint64_t micros;
+};
+
+template <typename Fn>
+static BusCost measure(Fn draw) {
+  display.fillScreen(WHITE);
+  bus.resetStats();
+  uint64_t start = hostClockUs();
+  draw();
+  return BusCost{ bus.stats().transactions, bus.stats().bytes, hostClockUs() - start };
+}
+
+static void printRow(const char *asset, const char *method, const BusCost &c, size_t flash, double decodeNs) {
+  printf("%-20s %-11s %6lu %9llu %8llu %8zu", asset, method, (unsigned long)c.transactions,
+         (unsigned long long)c.bytes, (unsigned long long)c.micros, flash);
+  if (decodeNs > 0)
+    printf(" %10.0f", decodeNs);
+  printf("\n");
+}
+
+int main() {
+  display.begin();
+  printf("%-20s %-11s %6s %9s %8s %8s %10s\n", "asset", "method", "txns", "bytes", "bus us", "flash", "decode ns");
+  for (const Asset &a : assets) {
+    const RleImage &img = *a.image;
+    // The five stars are drawn as a row, like showCenteredStarsAndScore(5).
+    int copies = img.width < 40 ? 5 : 1;
+    int16_t x = (240 - copies * (img.width + 2) + 2) / 2, y = 100;
+
+    BusCost before = measure(a.oldScreen);
+
+    std::vector<uint16_t> raw;
+    decodeRleImage(img, [&](uint8_t index, uint32_t count) { raw.insert(raw.end(), count, img.palette[index]); });
+
+    BusCost prim = measure([&] {
+      for (int i = 0; i < copies; i++) {
+        int16_t ix = x + i * (img.width + 2);
+        if (a.primitives) {
+          a.primitives(ix, y);
+          continue;
+        }
+        for (int p = 0; p < (int)raw.size(); p++) {
+          if (raw[p] != img.palette[0])
+            display.drawPixel(ix + p % img.width, y + p / img.width, raw[p]);
+        }
+      }
+    });
+
+    BusCost rawCost = measure([&] {
+      for (int i = 0; i < copies; i++) {
+        display.startWrite();
+        display.writeAddrWindow(x + i * (img.width + 2), y, img.width, img.height);
+        bus.writePixels(raw.data(), raw.size());
+        display.endWrite();
+      }
+    });
+
+    BusCost rle = measure([&] {
+      for (int i = 0; i < copies; i++)
+        drawRleImage(display, bus, x + i * (img.width + 2), y, img, false);
+    });
+    size_t rleFlash = img.size + img.paletteSize * 2;
+
+    const int reps = 20000;
+    volatile uint32_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++)
+      decodeRleImage(img, [&](uint8_t index, uint32_t count) { sink = sink + index + count; });
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / reps;
+
+    printRow(a.name, "old screen", before, 0, 0);
+    printRow(a.name, "primitives", prim, 0, 0);
+    printRow(a.name, "raw", rawCost, raw.size() * 2, 0);
+    printRow(a.name, "rle", rle, rleFlash, ns * copies);
+  }
+  return 0;
+}
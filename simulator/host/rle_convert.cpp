@@ -0,0 +1,107 @@
+// Converts a PNG into an RleImage header for the firmware (see rle_image.h).
+// The name is given in snake_case and becomes the header guard and the
+// camelCase identifiers (star_icon -> starIconImage).
+//
+//   g++ -std=c++20 -O2 -I host host/rle_convert.cpp -lz -o rle_convert
+//   ./rle_convert assets/src/star.png star > assets/star.h
+//
+// Colours are reduced to RGB565 first; the image may then use at most 16
+// distinct colours. Prints the compressed size and ratio on stderr.
+#include "png.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#define RLE_MAX_PALETTE 16
+
+static void emitRun(std::vector<uint8_t> &out, uint8_t index, uint32_t count) {
+  if (count < 16) {
+    out.push_back((index << 4) | (count - 1));
+    return;
+  }
+  out.push_back((index << 4) | 0x0F);
+  uint32_t extra = count - 16;
+  do {
+    uint8_t b = extra & 0x7F;
+    extra >>= 7;
+    out.push_back(extra ? (b | 0x80) : b);
+  } while (extra);
+}
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s input.png name > name.h\n", argv[0]);
+    return 2;
+  }
+  const char *name = argv[2];
+  std::vector<uint16_t> pixels;
+  int w, h;
+  if (!readPng(argv[1], pixels, w, h)) {
+    fprintf(stderr, "%s: not an 8-bit RGB/RGBA PNG\n", argv[1]);
+    return 1;
+  }
+  if (w > 0xFFFF || h > 0xFFFF) {
+    fprintf(stderr, "%s: too large\n", argv[1]);
+    return 1;
+  }
+
+  // Palette in order of first appearance, so the background is usually 0.
+  std::vector<uint16_t> palette;
+  std::vector<uint8_t> indices(pixels.size());
+  for (size_t i = 0; i < pixels.size(); i++) {
+    size_t k = 0;
+    while (k < palette.size() && palette[k] != pixels[i])
+      k++;
+    if (k == palette.size()) {
+      if (palette.size() == RLE_MAX_PALETTE) {
+        fprintf(stderr, "%s: more than %d colours after RGB565 reduction\n", argv[1], RLE_MAX_PALETTE);
+        return 1;
+      }
+      palette.push_back(pixels[i]);
+    }
+    indices[i] = k;
+  }
+
+  std::vector<uint8_t> data;
+  for (size_t i = 0; i < indices.size();) {
+    size_t j = i + 1;
+    while (j < indices.size() && indices[j] == indices[i])
+      j++;
+    emitRun(data, indices[i], j - i);
+    i = j;
+  }
+
+  printf("// Generated by host/rle_convert.cpp from %s - do not edit.\n", argv[1]);
+  printf("// %dx%d, %zu colours, %zu bytes (raw RGB565: %zu bytes)\n", w, h, palette.size(), data.size(),
+         pixels.size() * 2);
+  // star_icon -> starIconPalette, starIconData, starIconImage
+  std::string ident;
+  for (const char *c = name; *c; c++) {
+    if (*c == '_' && c[1])
+      ident += (char)toupper((unsigned char)*++c);
+    else
+      ident += *c;
+  }
+  std::string guard = "ASSET_";
+  for (const char *c = name; *c; c++)
+    guard += (char)toupper((unsigned char)*c);
+  guard += "_H_";
+  printf("#ifndef %s\n#define %s\n\n#include \"../rle_image.h\"\n\n", guard.c_str(), guard.c_str());
+  printf("static const uint16_t %sPalette[] PROGMEM = {", ident.c_str());
+  for (size_t i = 0; i < palette.size(); i++)
+    printf("%s0x%04X", i ? ", " : " ", palette[i]);
+  printf(" };\n\n");
+  printf("static const uint8_t %sData[] PROGMEM = {", ident.c_str());
+  for (size_t i = 0; i < data.size(); i++)
+    printf("%s0x%02X,", i % 16 ? " " : "\n  ", data[i]);
+  printf("\n};\n\n");
+  printf("static const RleImage %sImage = { %d, %d, %zu, %sPalette, %sData, sizeof(%sData) };\n", ident.c_str(),
+         w, h, palette.size(), ident.c_str(), ident.c_str(), ident.c_str());
+  printf("\n#endif  // %s\n", guard.c_str());
+
+  fprintf(stderr, "%s: %dx%d, %zu colours, %zu bytes (%.1fx smaller than RGB565)\n", name, w, h, palette.size(),
+          data.size(), pixels.size() * 2.0 / data.size());
+  return 0;
+}
@@ -0,0 +1,186 @@
+// Renders every screen in simulator/main.cpp through the host framebuffer,
+// writes a PNG per screen, compares it with the checked-in golden and
+// prints pixel-push / overdraw statistics for each one.
+//
+//   g++ -std=c++20 -O2 -DWOKWI_SIMULATION -I host host/screenshots.cpp -lz -o screenshots
+//   ./screenshots                 compare against host/golden, write host/out
+//   ./screenshots --update        rewrite the goldens after an intended change
+//
+// Exit status is 1 if any screen differs from its golden (or has none).
+#include "../main.cpp"
+#include "png.h"
+
+#include <sys/stat.h>
+
+struct Scene {
+  const char *name;
+  void (*base)();  // Screen the partial redraw lands on, or nullptr
+  void (*draw)();
+};
+
+static void seedPlayers() {
+  playerNames = { "Alice", "Bob", "Charlie", "Dana", "Eli" };
+  playerDocIds = { "a", "b", "c", "d", "e" };
+  playerCount = playerNames.size();
+}
+
+// A roster far bigger than the screen, to check scrolling stays cheap
+static void seedManyPlayers() {
+  playerNames.clear();
+  playerDocIds.clear();
+  char name[16];
+  for (int i = 0; i < 3000; i++) {
+    snprintf(name, sizeof(name), "Player %04d", i + 1);
+    playerNames.push_back(name);
+    playerDocIds.push_back(name);
+  }
+  playerCount = playerNames.size();
+}
+
+// A Code Breaker game with its number dealt and hidden
+static void newCodeBreakerGame() {
+  games.start<CodeBreakerGame>();
+  generateNewRandomNumber();
+}
+
+// The roster of `items` players, `exclude` left out, scrolled to `top`
+static RosterWindow window(int items, int exclude = -1, int top = 0) {
+  RosterWindow w;
+  w.begin(items, exclude);
+  w.top = top;
+  return w;
+}
+
+static const Scene scenes[] = {
+  { "loading", nullptr, [] { showLoadingScreen(); } },
+  { "mode_select", nullptr, [] { showModeSelect(); } },
+  { "player_menu", nullptr, [] { showPlayerMenu(window(5)); } },
+  { "player_selected", nullptr, [] { showPlayerSelected(1); } },
+  { "multiplayer_select1", nullptr, [] { showMultiplayerPlayerSelect1(window(5)); } },
+  { "multiplayer_select2", nullptr, [] { showMultiplayerPlayerSelect2(window(5, 0)); } },
+  { "player_menu_scroll_down", [] { showPlayerMenu(window(5)); }, [] { roster.show(window(5, -1, 1)); } },
+  { "player_menu_scroll_up", [] { showPlayerMenu(window(5)), roster.show(window(5, -1, 1)); },
+    [] { roster.show(window(5)); } },
+  { "roster_3000", nullptr, [] { seedManyPlayers(), showPlayerMenu(window(3000)); } },
+  { "roster_3000_scroll", [] { seedManyPlayers(), showPlayerMenu(window(3000)); },
+    [] { roster.show(window(3000, -1, 1)); } },
+  { "menu", nullptr, [] { showMenu(); } },
+  { "multiplayer_menu", nullptr, [] { showMultiplayerMenu(); } },
+  { "menu_message", [] { showMultiplayerMenu(); }, [] { showMenuMessage("Not implemented"); } },
+  { "code_breaker_difficulty", nullptr, [] { showCodeBreakerDifficultyMenu(); } },
+  { "code_breaker_title", nullptr, [] { showCodeBreakerTitle(); } },
+  { "code_breaker_new_number", nullptr, newCodeBreakerGame },
+  { "code_breaker_input", newCodeBreakerGame, [] { showInputProgress("12", 2); } },
+  { "code_breaker_result", newCodeBreakerGame, [] { showCodeBreakerResult(1, 1); } },
+  { "code_breaker_last_try", newCodeBreakerGame, [] { showLastTry("123"); } },
+  { "color_word_title", nullptr, [] { showColorWordTitle(); } },
+  { "color_word_difficulty", nullptr, [] { showColorWordDifficultySelect(); } },
+  { "color_word_step", nullptr, [] { showColorWordChallengeStep(0, 1); } },
+  { "visual_memory_difficulty", nullptr, [] { showVisualMemoryDifficultyMenu(); } },
+  { "visual_memory_color", nullptr, [] { showColorOnDisplay(2); } },
+  { "visual_memory_prompt", nullptr, [] { showRepeatSequencePrompt(); } },
+  { "tries_remaining", [] { showRepeatSequencePrompt(); }, [] { showTriesRemaining(2); } },
+  { "led_reaction_title", nullptr, [] { showLedReactionTitle(); } },
+  { "led_reaction_difficulty", nullptr, [] { showLedReactionDifficultySelect(); } },
+  { "led_reaction_color", nullptr, [] { showLedReactionColor(1); } },
+  { "led_reaction_next", nullptr, [] { showLedReactionStimulus(random(0, 3)); } },
+  { "led_reaction_score", nullptr, [] { showLedReactionScore(7); } },
+  { "stars_and_score", nullptr, [] { showCenteredStarsAndScore(4); } },
+  { "enter_secret", nullptr, [] { showEnterSecretPrompt(1); } },
+  { "secret_entry", nullptr, [] { showSecretEntry(2, "12", 2); } },
+  { "masked_input", [] { showEnterSecretPrompt(1); }, [] { showMaskedInputProgress("12", 2); } },
+  { "guess_screen", nullptr, [] { showGuessScreen(1, 2); } },
+  { "last_feedback", nullptr, [] { showLastFeedback(2, "456", 1, 2); } },
+  { "guess_feedback", nullptr, [] { showGuessFeedback(1, "123", 2, 0); } },
+  { "winner", nullptr, [] { showWinner(2, 5); } },
+  { "bottom_hints", nullptr, [] { stepClearToBottomHints(0); } },
+  { "resume_offer", nullptr, [] { showResumeOffer(GAME_COLOR_WORD, 1); } },
+};
+
+struct SceneResult {
+  HostPanelStats stats;
+  uint64_t busMicros;
+  long diffPixels;  // -1: no golden
+};
+
+// Counts differing pixels and reports their bounding box on stderr.
+static long compareWithGolden(const Scene &scene, const std::string &goldenPath) {
+  std::vector<uint16_t> golden;
+  int w, h;
+  if (!readPng(goldenPath, golden, w, h))
+    return -1;
+  if (w != bus.WIDTH || h != bus.HEIGHT)
+    return (long)bus.WIDTH * bus.HEIGHT;
+  const uint16_t *fb = bus.framebuffer();
+  long diff = 0;
+  int minX = w, minY = h, maxX = -1, maxY = -1;
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      if (fb[y * w + x] != golden[y * w + x]) {
+        diff++;
+        minX = min(minX, x), maxX = max(maxX, x);
+        minY = min(minY, y), maxY = max(maxY, y);
+      }
+    }
+  }
+  if (diff)
+    fprintf(stderr, "%s: %ld pixels differ in (%d,%d)-(%d,%d)\n", scene.name, diff, minX, minY, maxX, maxY);
+  return diff;
+}
+
+int main(int argc, char **argv) {
+  bool update = false;
+  std::string goldenDir = "host/golden", outDir = "host/out";
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--update") == 0)
+      update = true;
+    else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc)
+      goldenDir = argv[++i];
+    else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+      outDir = argv[++i];
+  }
+  mkdir(outDir.c_str(), 0755);
+  if (update)
+    mkdir(goldenDir.c_str(), 0755);
+
+  Serial.muted = true;
+  display.begin();
+
+  int failures = 0;
+  printf("%-26s %9s %9s %8s %9s %6s %8s %8s  %s\n", "screen", "pushed", "unique", "overdraw", "wasted",
+         "txns", "bytes", "bus us", "golden");
+  for (const Scene &scene : scenes) {
+    // Every screen starts from the same panel, RNG and LED state.
+    bus.resetPanel();
+    randomSeed(1);
+    turnOffAllRings();
+    seedPlayers();
+    if (scene.base)
+      scene.base();
+    bus.resetStats();
+    uint64_t start = hostClockUs();
+    scene.draw();
+
+    SceneResult r{ bus.stats(), hostClockUs() - start, 0 };
+    std::string file = std::string(scene.name) + ".png";
+    writePng(outDir + "/" + file, bus.framebuffer(), bus.WIDTH, bus.HEIGHT);
+    const char *verdict;
+    if (update) {
+      writePng(goldenDir + "/" + file, bus.framebuffer(), bus.WIDTH, bus.HEIGHT);
+      verdict = "updated";
+    } else {
+      r.diffPixels = compareWithGolden(scene, goldenDir + "/" + file);
+      verdict = r.diffPixels < 0 ? "MISSING" : r.diffPixels ? "DIFF" : "ok";
+      if (r.diffPixels != 0)
+        failures++;
+    }
+    printf("%-26s %9llu %9lu %8.2f %9llu %6lu %8llu %8llu  %s\n", scene.name,
+           (unsigned long long)r.stats.pixelsPushed, (unsigned long)r.stats.uniquePixels, r.stats.overdraw(),
+           (unsigned long long)r.stats.wastedPixels, (unsigned long)r.stats.transactions,
+           (unsigned long long)r.stats.bytes, (unsigned long long)r.busMicros, verdict);
+  }
+
+  if (failures)
+    printf("%d screen(s) differ from %s; PNGs are in %s\n", failures, goldenDir.c_str(), outDir.c_str());
+  return failures ? 1 : 0;
+}
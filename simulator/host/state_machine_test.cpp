@@ -0,0 +1,193 @@
+// Checks StateMachine on the host: handler order and deferred go() on a
+// small table of its own, then '*'/'#' routing and a few flows through
+// the firmware's gameStates, driven by loop() with keypad presses.
+//
+//   g++ -std=c++20 -O2 -DWOKWI_SIMULATION -I host host/state_machine_test.cpp -o state_machine_test
+//   ./state_machine_test
+//
+// Prints one line per check. Exit status is 1 if any fails.
+#include "../main.cpp"
+
+#include <string>
+
+static int failures = 0;
+
+static void check(const char *what, bool ok, const std::string &detail = "") {
+  printf("%-48s %-4s %s\n", what, ok ? "ok" : "FAIL", detail.c_str());
+  if (!ok)
+    failures++;
+}
+
+// --- A table of its own, logging every handler ---
+
+enum TestState : uint8_t { T_IDLE, T_A, T_B, T_C, T_COUNT };
+
+static std::string trace;
+static StateMachine *machine;
+
+static void note(const char *what) {
+  trace += trace.empty() ? "" : " ";
+  trace += what;
+}
+
+static void aEnter() {
+  note("A.enter");
+}
+static void aExit() {
+  note("A.exit");
+}
+static void aEvent(const InputEvent &event) {
+  note(event.key == '*' ? "A.event*" : "A.event");
+  if (event.key == '1') {
+    machine->go(T_B);
+    note(machine->state() == T_A ? "still-A" : "left-A");  // go() waits for the handler to return
+  }
+}
+static void bEnter() {
+  note("B.enter");
+  machine->go(T_C);  // A transition asked for by onEnter follows at once
+}
+static void bExit() {
+  note("B.exit");
+}
+static void cEnter() {
+  note("C.enter");
+}
+static void cExit() {
+  note("C.exit");
+}
+static void cEvent(const InputEvent &) {
+  note("C.event");
+}
+static void cTick() {
+  note("C.tick");
+  machine->go(T_IDLE);
+}
+
+constexpr StateDef testStates[] = {
+  { T_IDLE, "T_IDLE", nullptr, nullptr, nullptr, nullptr, STATE_NONE, STATE_NONE, true },
+  { T_A, "T_A", aEnter, aEvent, nullptr, aExit, STATE_NONE, T_IDLE },
+  { T_B, "T_B", bEnter, nullptr, nullptr, bExit, T_A, T_IDLE },
+  { T_C, "T_C", cEnter, cEvent, cTick, cExit, T_A, T_IDLE },
+};
+static_assert(stateTableValid(testStates), "testStates rows must be in TestState order");
+
+static InputEvent press(char key, InputSource source = INPUT_KEYPAD) {
+  return InputEvent{ 0, source, INPUT_PRESS, key, 0 };
+}
+
+static void expectTrace(const char *what, const char *expected) {
+  check(what, trace == expected, "[" + trace + "]");
+  trace.clear();
+}
+
+static void testOwnTable() {
+  StateMachine m(testStates, T_COUNT, T_IDLE);
+  machine = &m;
+  m.go(T_A);
+  expectTrace("go() outside a handler moves at once", "A.enter");
+  m.dispatch(press('1'));
+  expectTrace("go() in onEvent waits for it, onEnter chains", "A.event still-A A.exit B.enter B.exit C.enter");
+  check("  ending in the last state asked for", m.state() == T_C);
+  m.dispatch(press('*'));
+  expectTrace("'*' follows the table, not onEvent", "C.exit A.enter");
+  m.dispatch(press('*'));
+  expectTrace("'*' without a target reaches onEvent", "A.event*");
+  m.dispatch(press('*', INPUT_BUTTON));
+  expectTrace("a game button is never a navigation key", "A.event*");
+  m.go(T_A);
+  expectTrace("re-entering runs onExit and onEnter", "A.exit A.enter");
+  m.dispatch(press('#'));
+  expectTrace("'#' follows the table", "A.exit");
+  check("  to the idle row", m.state() == T_IDLE && m.idle());
+  m.go(T_C);
+  trace.clear();
+  m.tick();
+  expectTrace("go() in onTick waits for it", "C.tick C.exit");
+  m.go(T_COUNT);
+  check("go() past the table is ignored", m.state() == T_IDLE && trace.empty());
+  check("every move is counted", m.transitions() == 8, std::to_string(m.transitions()));
+}
+
+// --- The firmware's table ---
+
+static void run(uint32_t ms) {
+  for (uint32_t i = 0; i < ms; i++) {
+    loop();
+    hostAdvanceUs(1000);
+  }
+}
+
+static void key(char c) {
+  keypad.press(c);
+  run(150);
+}
+
+static bool in(State state) {
+  return stateMachine.state() == state;
+}
+
+static void testGameStates() {
+  int wrong = failures;
+  for (uint8_t s = 0; s < STATE_COUNT; s++) {
+    const StateDef &row = gameStates[s];
+    if (row.onHash != STATE_NONE && row.onHash != MODE_SELECT)
+      check(row.name, false, "'#' should log out");
+    bool multi = s >= CODE_BREAKER_MULTI_SECRET1 && s <= CODE_BREAKER_MULTI_TURN_P2;
+    if (!row.idle && row.onStar != (multi ? MULTI_MENU : MENU))
+      check(row.name, false, "'*' should lead back to its games menu");
+  }
+  check("every game row leads back with '*' and '#'", failures == wrong);
+
+  for (uint8_t i = 0; i < 3; i++)
+    hostSetPin(buttonPins[i], HIGH);
+  playerNames = { "Ann", "Bob", "Cy" };
+  playerDocIds = { "a", "b", "c" };
+  playerCount = 3;
+  display.begin();
+  keypadScanner.begin();
+  buttons.begin(buttonPins, 3);
+  stimuli.begin();
+  netWorker.begin(runSessionUpload);
+  inputBus.addSource(readKeypadInput);
+  inputBus.addSource(readButtonInput);
+  inputBus.addSource(readTouchInput);
+  stateMachine.go(MODE_SELECT);
+
+  key('1');
+  check("mode select '1' picks a player", in(PLAYER_SELECT));
+  key('2');
+  run(1300);
+  check("  then the games menu", in(MENU) && currentPlayer == 1);
+  key('1');
+  check("'1' opens Code Breaker's difficulties", in(CODE_BREAKER_DIFFICULTY_SELECT));
+  key('*');
+  check("  '*' goes back", in(MENU));
+  key('2');
+  key('1');
+  run(3000);
+  check("Visual Memory plays its sequence", in(VISUAL_MEMORY));
+  key('*');
+  check("  '*' cuts it short", in(MENU) && !games.get<VisualMemoryGame>());
+  run(10000);
+  check("the menu idles without moving", in(MENU) && stateMachine.idle());
+  key('#');
+  check("'#' logs out", in(MODE_SELECT));
+  key('2');
+  key('1');
+  key('1');
+  check("multiplayer picks both players", in(MULTI_MENU));
+  key('1');
+  check("  Code Breaker asks for a secret", in(CODE_BREAKER_MULTI_SECRET1));
+  key('*');
+  check("  '*' goes back to the multiplayer menu", in(MULTI_MENU) && !games.get<MultiCodeBreakerGame>());
+  key('#');
+  check("  '#' logs out", in(MODE_SELECT));
+}
+
+int main() {
+  Serial.muted = true;
+  testOwnTable();
+  testGameStates();
+  return failures ? 1 : 0;
+}
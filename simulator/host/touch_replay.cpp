@@ -0,0 +1,106 @@
+// Replays recorded touch traces through GestureRecognizer and checks the
+// gestures it reports against the expectations written in each trace.
+//
+//   g++ -std=c++20 -O2 -I host host/touch_replay.cpp -o touch_replay
+//   ./touch_replay host/traces/*.trace
+//
+// Trace lines (the format the 'T' serial command prints, so traces can be
+// captured on the device and pasted into a file):
+//
+//   <t_us> down <x> <y>      a sample with a finger on the panel
+//   <t_us> up                the finger lifted
+//   expect <gesture> <x> <y> the next gesture reported (gestureName() spelling)
+//   # ...                    comment
+//
+// Between samples the recognizer is polled every 10 ms, like loop() does,
+// so long presses fire at the time they would on the device. Exit status is
+// 1 if any trace reports something other than what it expects.
+#include "../touch_gesture.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#define REPLAY_POLL_US 10000
+
+struct Expected {
+  std::string type;
+  int x, y;
+};
+
+static bool replay(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    printf("%-34s cannot open\n", path);
+    return false;
+  }
+  GestureRecognizer recognizer;
+  std::vector<Gesture> got;
+  std::vector<Expected> expected;
+  uint32_t lastUs = 0;
+  bool started = false;
+  char line[128];
+  int lineNo = 0;
+  bool ok = true;
+  while (fgets(line, sizeof(line), f)) {
+    lineNo++;
+    char word[16];
+    unsigned long t;
+    int x = 0, y = 0;
+    Gesture g;
+    if (line[0] == '#' || sscanf(line, "%15s", word) != 1)
+      continue;
+    if (strcmp(word, "expect") == 0) {
+      if (sscanf(line, "expect %15s %d %d", word, &x, &y) < 1) {
+        printf("%s:%d: bad expect\n", path, lineNo);
+        ok = false;
+      }
+      expected.push_back(Expected{ word, x, y });
+      continue;
+    }
+    int fields = sscanf(line, "%lu %15s %d %d", &t, word, &x, &y);
+    bool down = fields == 4 && strcmp(word, "down") == 0;
+    if (!down && !(fields >= 2 && strcmp(word, "up") == 0)) {
+      printf("%s:%d: bad sample\n", path, lineNo);
+      ok = false;
+      continue;
+    }
+    for (uint32_t now = lastUs + REPLAY_POLL_US; started && now < t; now += REPLAY_POLL_US) {
+      if (recognizer.poll(now, g))
+        got.push_back(g);
+    }
+    if (recognizer.feed(TouchSample{ (uint32_t)t, (uint16_t)x, (uint16_t)y, down }, g))
+      got.push_back(g);
+    lastUs = t;
+    started = true;
+  }
+  fclose(f);
+
+  std::string seen;
+  for (const Gesture &g : got) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%s%s %u,%u @%lums", seen.empty() ? "" : ", ", gestureName(g.type), g.x, g.y,
+             (unsigned long)((g.atUs - g.downUs) / 1000));
+    seen += buf;
+  }
+  if (got.size() != expected.size())
+    ok = false;
+  for (size_t i = 0; ok && i < got.size(); i++) {
+    const Expected &e = expected[i];
+    ok = e.type == gestureName(got[i].type) && e.x == got[i].x && e.y == got[i].y;
+  }
+  printf("%-34s %-4s %s\n", path, ok ? "ok" : "FAIL", seen.empty() ? "(nothing)" : seen.c_str());
+  return ok;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s trace...\n", argv[0]);
+    return 2;
+  }
+  int failures = 0;
+  for (int i = 1; i < argc; i++)
+    failures += !replay(argv[i]);
+  return failures ? 1 : 0;
+}
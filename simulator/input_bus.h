@@ -0,0 +1,113 @@
+#ifndef INPUT_BUS_H_
+#define INPUT_BUS_H_
+
+// One stream of input events from every source.
+//
+// The keypad, the game buttons and the touch panel each produce
+// timestamped events in their own way: a scanning task, pin interrupts, a
+// sampling task. InputBus pulls from all of them and gives loop() the
+// oldest pending event, so game code reads events rather than owning GPIO,
+// and a press is judged by its own timestamp whatever it came from.
+//
+// Debouncing stays with each source, which knows its own contacts. The
+// buttons and the keypad integrate contact time the same way, with the
+// window set per button by ButtonInput::setDebounce() and for the whole
+// matrix by KeypadScanner::setDebounce(). The touch panel needs none.
+//
+// A source is a function that fills in the next InputEvent, so adding one
+// (a serial remote, a replayed trace) doesn't touch game code. The bus
+// holds at most one event per source while it compares timestamps.
+
+#include <stdint.h>
+
+#define INPUT_MAX_SOURCES 4
+
+enum InputSource : uint8_t {
+  INPUT_KEYPAD,
+  INPUT_BUTTON,
+  INPUT_TOUCH,
+  INPUT_SOURCE_COUNT
+};
+
+enum InputAction : uint8_t {
+  INPUT_PRESS,
+  INPUT_HOLD,
+  INPUT_RELEASE
+};
+
+inline const char *inputSourceName(InputSource source) {
+  switch (source) {
+    case INPUT_KEYPAD: return "keypad";
+    case INPUT_BUTTON: return "buttons";
+    case INPUT_TOUCH: return "touch";
+    default: return "?";
+  }
+}
+
+struct InputEvent {
+  uint32_t tUs;  // When it happened, on the esp_timer clock
+  InputSource source;
+  InputAction action;
+  char key;        // Keypad key, or the key a touch stands for
+  uint8_t button;  // Game button index (INPUT_BUTTON)
+};
+
+class InputBus {
+public:
+  typedef bool (*ReadFn)(InputEvent &event);
+
+  bool addSource(ReadFn read) {
+    if (_count >= INPUT_MAX_SOURCES)
+      return false;
+    _sources[_count++] = Source{ read, false, {} };
+    return true;
+  }
+
+  // Oldest event waiting on any source.
+  bool read(InputEvent &event) {
+    int8_t oldest = -1;
+    for (uint8_t i = 0; i < _count; i++) {
+      Source &s = _sources[i];
+      if (!s.held)
+        s.held = s.read(s.event);
+      if (s.held && (oldest < 0 || (int32_t)(s.event.tUs - _sources[oldest].event.tUs) < 0))
+        oldest = i;
+    }
+    if (oldest < 0)
+      return false;
+    Source &s = _sources[oldest];
+    s.held = false;
+    event = s.event;
+    if (event.source < INPUT_SOURCE_COUNT)
+      _events[event.source]++;
+    return true;
+  }
+
+  // Drop everything waiting, e.g. presses made while a sequence played.
+  void flush() {
+    for (uint8_t i = 0; i < _count; i++) {
+      Source &s = _sources[i];
+      s.held = false;
+      while (s.read(s.event)) {
+      }
+    }
+  }
+
+  // Events delivered from `source` since boot
+  uint32_t events(InputSource source) const {
+    return source < INPUT_SOURCE_COUNT ? _events[source] : 0;
+  }
+
+private:
+  struct Source {
+    ReadFn read;
+    bool held;  // `event` was read from the source but not delivered yet
+    InputEvent event;
+  };
+
+  Source _sources[INPUT_MAX_SOURCES];
+  uint8_t _count = 0;
+  uint32_t _events[INPUT_SOURCE_COUNT] = {};
+};
+
+#endif  // INPUT_BUS_H_
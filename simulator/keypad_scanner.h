@@ -0,0 +1,192 @@
+#ifndef KEYPAD_SCANNER_H_
+#define KEYPAD_SCANNER_H_
+
+// Scans the keypad matrix from a background task at a fixed rate.
+//
+// keypad.getKey() in loop() only sees the matrix when loop() gets round to
+// it, so a key pressed and released during a redraw or an HTTP call was
+// never seen. The "keypad" task calls Keypad::getKeys() every
+// KEYPAD_SCAN_MS whatever loop() is doing, and turns each key state change
+// into a timestamped press, hold or release event in a lock-free ring.
+// loop() takes presses from it with getKey(), or every event with read().
+//
+// The Keypad library still drives the matrix, but only as a raw sampler:
+// its own time-window debounce is cut to the minimum, and each scan's
+// closed keys feed the same integrator ButtonInput uses. Per key, the time
+// seen closed minus the time seen open is clamped to [0, debounce]; the
+// key is pressed once that reaches the debounce time and released once it
+// is back to zero, so a contact bouncing across a scan or two can't make
+// a second press. The level a scan sees counts from the scan before. An
+// event keeps the time of the scan that first saw the transition start,
+// so a press is stamped when it happened, not when it settled. A key held
+// KEYPAD_HOLD_MS past its press also gives a hold.
+//
+// Only the task touches the Keypad once begin() has run. Without a
+// background task (host builds) read() scans before it looks at the ring.
+
+#include <Arduino.h>
+#include <Keypad.h>
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "spsc_ring.h"
+
+#define KEYPAD_SCAN_MS 10
+#define KEYPAD_DEBOUNCE_US 20000  // Net closed (or open) time to change state: two scans
+#define KEYPAD_HOLD_MS 600
+#define KEYPAD_KEYS 16  // Distinct keys tracked
+#define KEYPAD_QUEUE_LEN 32
+#define KEYPAD_TASK_STACK 2048
+#define KEYPAD_TASK_PRIORITY 2
+#define KEYPAD_TASK_CORE 1  // App core, with loop()
+
+enum KeyEventType : uint8_t {
+  KEY_PRESS,
+  KEY_HOLD,
+  KEY_RELEASE
+};
+
+struct KeyEvent {
+  uint32_t tUs;  // First scan of the transition; the hold's own scan
+  char key;
+  KeyEventType type;
+};
+
+class KeypadScanner {
+public:
+  explicit KeypadScanner(Keypad &keypad) : _keypad(keypad) {}
+
+  // Time a key's contact must settle for before a press or release counts.
+  void setDebounce(uint32_t us) {
+    _debounceUs = us;
+  }
+  uint32_t debounce() const {
+    return _debounceUs;
+  }
+
+  void begin() {
+    _keypad.setDebounceTime(1);  // Scan on every getKeys(); the integrator debounces
+    _scanUs = (uint32_t)esp_timer_get_time();
+    xTaskCreatePinnedToCore(taskEntry, "keypad", KEYPAD_TASK_STACK, this, KEYPAD_TASK_PRIORITY, &_task, KEYPAD_TASK_CORE);
+  }
+
+  // Stop scanning while the matrix is parked as a light sleep wake source
+  void pause(bool paused) {
+    _paused = paused;
+  }
+
+  // Next event, oldest first.
+  bool read(KeyEvent &event) {
+    if (!_task)
+      scan();
+    return _events.pop(event);
+  }
+
+  // Next key press, or NO_KEY; holds and releases are skipped.
+  char getKey() {
+    KeyEvent event;
+    while (read(event)) {
+      if (event.type == KEY_PRESS)
+        return event.key;
+    }
+    return NO_KEY;
+  }
+
+  // Events lost because loop() fell KEYPAD_QUEUE_LEN behind, and the most
+  // that were ever waiting
+  uint32_t overflows() const {
+    return _events.overflows();
+  }
+  uint32_t peak() const {
+    return _events.peak();
+  }
+
+private:
+  struct Contact {
+    char key = NO_KEY;
+    bool closed = false;  // Seen closed by the latest scan
+    bool down = false;    // Debounced state
+    bool held = false;    // Hold sent for this press
+    uint32_t integral = 0;
+    uint32_t moveUs = 0;   // First scan of the transition under way
+    uint32_t pressUs = 0;  // Stamp of the current press
+  };
+
+  static void taskEntry(void *arg) {
+    ((KeypadScanner *)arg)->run();
+  }
+
+  void run() {
+    TickType_t wake = xTaskGetTickCount();
+    for (;;) {
+      if (!_paused)
+        scan();
+      vTaskDelayUntil(&wake, pdMS_TO_TICKS(KEYPAD_SCAN_MS));
+    }
+  }
+
+  void scan() {
+    _keypad.getKeys();
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    uint32_t dt = now - _scanUs;
+    _scanUs = now;
+    for (uint8_t i = 0; i < _keyCount; i++)
+      _keys[i].closed = false;
+    for (uint8_t i = 0; i < LIST_MAX; i++) {
+      const Key &k = _keypad.key[i];
+      if (k.kchar == NO_KEY || (k.kstate != PRESSED && k.kstate != HOLD))
+        continue;
+      Contact *key = find(k.kchar);
+      if (key)
+        key->closed = true;
+    }
+    for (uint8_t i = 0; i < _keyCount; i++)
+      integrate(_keys[i], dt, now);
+  }
+
+  // The key's contact, added the first time the key is seen
+  Contact *find(char c) {
+    for (uint8_t i = 0; i < _keyCount; i++) {
+      if (_keys[i].key == c)
+        return &_keys[i];
+    }
+    if (_keyCount == KEYPAD_KEYS)
+      return nullptr;
+    _keys[_keyCount].key = c;
+    return &_keys[_keyCount++];
+  }
+
+  // Integrate `dt` more of the key's contact level, as seen by the scan at
+  // `now`, and push whatever that changed.
+  void integrate(Contact &k, uint32_t dt, uint32_t now) {
+    bool atRest = k.down ? k.integral >= _debounceUs : k.integral == 0;
+    if (k.closed != k.down && atRest)
+      k.moveUs = now;
+    if (k.closed)
+      k.integral = dt >= _debounceUs - k.integral ? _debounceUs : k.integral + dt;
+    else
+      k.integral = k.integral > dt ? k.integral - dt : 0;
+    bool down = k.down ? k.integral > 0 : k.integral >= _debounceUs;
+    if (down != k.down) {
+      k.down = down;
+      k.held = false;
+      if (down)
+        k.pressUs = k.moveUs;
+      _events.push(KeyEvent{ k.moveUs, k.key, down ? KEY_PRESS : KEY_RELEASE });
+    } else if (k.down && !k.held && now - k.pressUs >= KEYPAD_HOLD_MS * 1000UL) {
+      k.held = true;
+      _events.push(KeyEvent{ now, k.key, KEY_HOLD });
+    }
+  }
+
+  Keypad &_keypad;
+  Contact _keys[KEYPAD_KEYS];
+  uint8_t _keyCount = 0;
+  uint32_t _scanUs = 0;  // Integrated up to here
+  SpscRing<KeyEvent, KEYPAD_QUEUE_LEN> _events;
+  TaskHandle_t _task = nullptr;
+  uint32_t _debounceUs = KEYPAD_DEBOUNCE_US;
+  volatile bool _paused = false;
+};
+
+#endif  // KEYPAD_SCANNER_H_
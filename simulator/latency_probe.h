@@ -0,0 +1,161 @@
+#ifndef LATENCY_PROBE_H_
+#define LATENCY_PROBE_H_
+
+// Press-to-photon latency measurement.
+//
+// A measurement starts when a game acts on a button press. press() gets the
+// press's edge time (from the interrupt) and the time it was acted on.
+// The next loop() pass commits the response to the display task, and once
+// that batch is drawn (DisplayServer::shown()) rendered() takes when its
+// first command started drawing and its last one finished. complete() then
+// takes when the LED frame carrying it finished clocking out. The LED task
+// sends that frame a little later, so the caller waits up to
+// LATENCY_LED_WAIT_US for it. Each press then adds one sample to each of
+// these histograms:
+//
+//   input->handled   edge to the game's state change (queueing, loop() lag)
+//   handled->render  acting on it to the display task starting its response
+//   render           drawing the response, first command to last
+//   input->tft       edge to the response fully on the TFT
+//   input->leds      edge to the LED frame fully sent
+//
+// Buckets double from LATENCY_BUCKET0_US, so one row covers 250 us to half
+// a second, plus a bucket for anything slower. Each row also keeps
+// min/mean/max.
+//
+// Nothing is recorded unless the mode is enabled, so it costs nothing in
+// normal play.
+
+#include <Arduino.h>
+
+#define LATENCY_BUCKETS 13
+#define LATENCY_BUCKET0_US 250  // Bucket i holds samples below 250 << i us; the last one the rest
+#define LATENCY_LED_WAIT_US 100000  // A response that changes no LEDs is recorded without them
+
+enum LatencySegment : uint8_t {
+  LAT_INPUT_HANDLED,
+  LAT_HANDLED_RENDER,
+  LAT_RENDER,
+  LAT_INPUT_TFT,
+  LAT_INPUT_LEDS,
+  LAT_SEGMENTS
+};
+
+struct LatencyHistogram {
+  uint32_t count;
+  uint32_t minUs;
+  uint32_t maxUs;
+  uint64_t sumUs;
+  uint32_t buckets[LATENCY_BUCKETS];
+
+  void add(uint32_t us) {
+    if (count == 0 || us < minUs)
+      minUs = us;
+    if (us > maxUs)
+      maxUs = us;
+    count++;
+    sumUs += us;
+    uint8_t i = 0;
+    while (i < LATENCY_BUCKETS - 1 && us >= ((uint32_t)LATENCY_BUCKET0_US << i))
+      i++;
+    buckets[i]++;
+  }
+};
+
+// One press, as far as it got; 0 for a stage that didn't happen
+struct LatencySample {
+  uint32_t inputUs;
+  uint32_t handledUs;
+  uint32_t renderStartUs;
+  uint32_t tftDoneUs;
+  uint32_t ledsDoneUs;
+};
+
+class LatencyProbe {
+public:
+  void setEnabled(bool on) {
+    _enabled = on;
+    _pending = false;
+  }
+  bool enabled() const {
+    return _enabled;
+  }
+  // A press waiting for rendered(), then complete()
+  bool pending() const {
+    return _pending;
+  }
+  bool rendered() const {
+    return _rendered;
+  }
+  uint32_t handledUs() const {
+    return _sample.handledUs;
+  }
+
+  // A press from `inputUs` was acted on at `handledUs`. A press that
+  // arrives before the last one completed replaces it.
+  void press(uint32_t inputUs, uint32_t handledUs) {
+    if (!_enabled)
+      return;
+    _sample = LatencySample{ inputUs, handledUs, 0, 0, 0 };
+    _pending = true;
+    _rendered = false;
+  }
+
+  // The response's SPI traffic, 0 and 0 if it drew nothing.
+  void rendered(uint32_t renderStartUs, uint32_t tftDoneUs) {
+    _sample.renderStartUs = renderStartUs;
+    _sample.tftDoneUs = tftDoneUs;
+    _rendered = true;
+  }
+
+  // The LED frame is out, or 0 if none came. Stages that didn't happen are
+  // left out of their histograms.
+  const LatencySample &complete(uint32_t ledsDoneUs) {
+    LatencySample &s = _sample;
+    s.ledsDoneUs = ledsDoneUs;
+    _pending = false;
+    _hist[LAT_INPUT_HANDLED].add(s.handledUs - s.inputUs);
+    if (s.renderStartUs) {
+      _hist[LAT_HANDLED_RENDER].add(s.renderStartUs - s.handledUs);
+      _hist[LAT_RENDER].add(s.tftDoneUs - s.renderStartUs);
+      _hist[LAT_INPUT_TFT].add(s.tftDoneUs - s.inputUs);
+    }
+    if (ledsDoneUs)
+      _hist[LAT_INPUT_LEDS].add(ledsDoneUs - s.inputUs);
+    return s;
+  }
+
+  void reset() {
+    memset(_hist, 0, sizeof(_hist));
+    _pending = false;
+  }
+
+  void dump(Print &out) const {
+    static const char *names[LAT_SEGMENTS] = { "input->handled", "handled->render", "render", "input->tft",
+                                               "input->leds" };
+    out.println("--- Press-to-photon latency ---");
+    out.printf("%-16s %6s %8s %8s %8s  counts per bucket, upper bounds in ms:\n", "segment", "count", "min us",
+               "mean us", "max us");
+    out.printf("%-16s %6s %8s %8s %8s ", "", "", "", "", "");
+    for (uint8_t i = 0; i < LATENCY_BUCKETS - 1; i++)
+      out.printf(" %5g", (LATENCY_BUCKET0_US << i) / 1000.0);
+    out.println("  more");
+    for (uint8_t k = 0; k < LAT_SEGMENTS; k++) {
+      const LatencyHistogram &h = _hist[k];
+      out.printf("%-16s %6lu %8lu %8lu %8lu ", names[k], (unsigned long)h.count, (unsigned long)h.minUs,
+                 (unsigned long)(h.count ? h.sumUs / h.count : 0), (unsigned long)h.maxUs);
+      for (uint8_t i = 0; i < LATENCY_BUCKETS; i++)
+        out.printf(" %5lu", (unsigned long)h.buckets[i]);
+      out.println();
+    }
+  }
+
+private:
+  bool _enabled = false;
+  bool _pending = false;
+  bool _rendered = false;
+  LatencySample _sample = {};
+  LatencyHistogram _hist[LAT_SEGMENTS] = {};
+};
+
+#endif  // LATENCY_PROBE_H_
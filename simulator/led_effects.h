@@ -0,0 +1,342 @@
+#ifndef LED_EFFECTS_H_
+#define LED_EFFECTS_H_
+
+// Background effect engine for the three LED rings.
+//
+// Each ring runs one effect, restarted by play():
+//
+//   LED_SOLID      steady colour (0 is off)
+//   LED_FADE       from whatever the ring shows now to `color` over periodMs,
+//                  then steady
+//   LED_PULSE      brightness rises and falls once per periodMs
+//   LED_SPINNER    a lit head with a fading tail goes round once per periodMs
+//   LED_COUNTDOWN  the ring starts full and empties LED by LED over periodMs,
+//                  so the last one goes out when the time is up
+//
+// play() only queues a command. commit(), called once per loop() pass,
+// wakes the "leds" task, which owns the strip: it applies every command
+// queued since the last commit, re-renders the rings they touched (and the
+// animated ones) and starts one non-blocking show() if any pixel actually
+// changed. However many times a pass switches rings on and off, the strip
+// gets at most one frame, and none if it ends where it started; stats()
+// counts the show() calls this saves. Call commit() early where a change
+// must not wait for the rest of the pass (a reaction stimulus ahead of a
+// slow screen redraw). While anything animates the task renders every
+// LED_FRAME_MS; otherwise it sleeps until the next command. A frame that
+// finds the previous one still on the wire is retried after LED_RETRY_MS,
+// not a whole frame later. Callers never wait for the LEDs.
+//
+// Effects are timed from when play() was called, not from when the task got
+// to the command, so a countdown started with a game step runs in step with
+// the step timer.
+//
+// Without a background task (host builds) commit() renders immediately and
+// service(), called from loop(), stands in for the task.
+
+#include <Arduino.h>
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "led_strip.h"
+
+#define LED_FRAME_MS 20  // 50 fps while animating
+#define LED_RETRY_MS 2   // A 48-LED frame takes about 1.5 ms to send
+#define LED_QUEUE_LEN 16
+#define LED_TASK_STACK 3072
+#define LED_TASK_PRIORITY 3  // Above the display server: frames never wait for a screen fill
+#define LED_TASK_CORE 1  // App core, with loop()
+#define LED_SPINNER_TAIL 3
+
+#define LED_RING(i) (1 << (i))
+
+struct LedStats {
+  uint32_t writes;      // play()/playOnly()/off() calls, each a show() before coalescing
+  uint32_t shows;       // Frames actually sent
+  uint32_t writeShows;  // Of those, frames carrying writes (the rest are animation)
+
+  uint32_t saved() const {
+    return writes - writeShows;
+  }
+};
+
+enum LedEffectType : uint8_t {
+  LED_SOLID,
+  LED_FADE,
+  LED_PULSE,
+  LED_SPINNER,
+  LED_COUNTDOWN
+};
+
+template <uint8_t RINGS, uint8_t PER_RING>
+class LedEffects {
+public:
+  static const uint8_t ALL = (1 << RINGS) - 1;
+
+  explicit LedEffects(int8_t pin) : _strip(pin) {}
+
+  bool begin() {
+    if (!_strip.begin())
+      return false;
+    _strip.show();
+    _queue = xQueueCreate(LED_QUEUE_LEN, sizeof(Command));
+    if (!_queue)
+      return false;
+    xTaskCreatePinnedToCore(taskEntry, "leds", LED_TASK_STACK, this, LED_TASK_PRIORITY, &_task, LED_TASK_CORE);
+    return true;
+  }
+
+  // Start `type` on every ring in the `rings` mask (LED_RING(i) bits).
+  // Rings outside the mask keep their effect.
+  void play(uint8_t rings, LedEffectType type, uint32_t color, uint16_t periodMs = 0) {
+    post(Command{ rings, false, type, color, periodMs, (uint32_t)millis() });
+  }
+
+  // Same, and switch the other rings off in the same frame.
+  void playOnly(uint8_t rings, LedEffectType type, uint32_t color, uint16_t periodMs = 0) {
+    post(Command{ rings, true, type, color, periodMs, (uint32_t)millis() });
+  }
+
+  void off() {
+    playOnly(0, LED_SOLID, 0);
+  }
+
+  // Send what was written since the last commit, as one frame.
+  void commit() {
+    if (!_queue || !uxQueueMessagesWaiting(_queue))
+      return;
+    if (_task)
+      xTaskNotifyGive(_task);
+    else
+      frame(millis());
+  }
+
+  // Runs due frames from loop() when there is no background task.
+  void service(uint32_t nowMs) {
+    if (!_task && _queue && (_pending || (_animating && nowMs - _lastFrameMs >= LED_FRAME_MS)))
+      frame(nowMs);
+  }
+
+  // No animation running and no frame waiting to go out
+  bool idle() const {
+    return !_animating && !_pending && !(_queue && uxQueueMessagesWaiting(_queue));
+  }
+
+  // Forwarded to the strip; both take effect from the next frame
+  void setBrightness(uint8_t brightness) {
+    _strip.setBrightness(brightness);
+  }
+  void setCurrentBudget(uint16_t milliamps) {
+    _strip.setCurrentBudget(milliamps);
+  }
+
+  const LedPower &power() const {
+    return _strip.power();
+  }
+
+  const LedStats &stats() const {
+    return _stats;
+  }
+
+  // esp_timer time the last frame finished going out (its start plus the
+  // wire time; the RMT driver has no completion callback), or 0
+  uint32_t lastFrameDoneUs() const {
+    return _lastShowUs ? _lastShowUs + LedStrip<RINGS * PER_RING>::frameUs() : 0;
+  }
+
+  // Commands dropped because the queue filled up between commits.
+  uint32_t dropped() const {
+    return _dropped;
+  }
+
+private:
+  struct Command {
+    uint8_t rings;
+    bool othersOff;
+    LedEffectType type;
+    uint32_t color;
+    uint16_t periodMs;
+    uint32_t startMs;
+  };
+
+  struct Ring {
+    LedEffectType type = LED_SOLID;
+    uint32_t color = 0;
+    uint32_t from = 0;  // LED_FADE start colour
+    uint16_t periodMs = 0;
+    uint32_t startMs = 0;
+    bool dirty = true;  // Written since it was last rendered
+  };
+
+  void post(const Command &cmd) {
+    if (!_queue)
+      return;
+    _stats.writes++;
+    if (xQueueSend(_queue, &cmd, 0) != pdTRUE)
+      _dropped++;
+  }
+
+  static void taskEntry(void *arg) {
+    ((LedEffects *)arg)->run();
+  }
+
+  void run() {
+    for (;;) {
+      TickType_t wait = portMAX_DELAY;
+      if (_pending)
+        wait = pdMS_TO_TICKS(LED_RETRY_MS);
+      else if (_animating)
+        wait = pdMS_TO_TICKS(LED_FRAME_MS);
+      ulTaskNotifyTake(pdTRUE, wait);
+      frame(millis());
+    }
+  }
+
+  void frame(uint32_t nowMs) {
+    Command cmd;
+    bool written = false;
+    while (xQueueReceive(_queue, &cmd, 0) == pdTRUE) {
+      apply(cmd);
+      written = true;
+    }
+
+    bool animating = false, changed = false;
+    for (uint8_t r = 0; r < RINGS; r++) {
+      Ring &ring = _rings[r];
+      if (ring.dirty || ring.type != LED_SOLID)
+        changed |= render(r, nowMs);
+      ring.dirty = false;
+      animating |= ring.type != LED_SOLID;
+    }
+    _animating = animating;
+
+    // A frame that changed pixels because of writes still counts as theirs
+    // if it had to wait for the wire.
+    bool forWrites = (written && changed) || (_pending && _pendingForWrites);
+    if (changed || _pending) {
+      _pending = !_strip.show();
+      if (!_pending) {
+        _lastShowUs = (uint32_t)esp_timer_get_time();
+        _stats.shows++;
+        _stats.writeShows += forWrites;
+      }
+      _pendingForWrites = _pending && forWrites;
+    }
+    _lastFrameMs = nowMs;
+  }
+
+  void apply(const Command &cmd) {
+    for (uint8_t r = 0; r < RINGS; r++) {
+      Ring &ring = _rings[r];
+      if (cmd.rings & LED_RING(r)) {
+        ring.from = _strip.getPixelColor(r * PER_RING);
+        ring.type = cmd.type;
+        ring.color = cmd.color;
+        ring.periodMs = cmd.periodMs;
+        ring.startMs = cmd.startMs;
+        ring.dirty = true;
+      } else if (cmd.othersOff) {
+        ring = Ring();
+      }
+    }
+  }
+
+  // Draw ring `r` for time `nowMs`; returns true if any pixel changed.
+  bool render(uint8_t r, uint32_t nowMs) {
+    Ring &ring = _rings[r];
+    uint32_t t = nowMs - ring.startMs;
+    if (ring.type != LED_SOLID && ring.periodMs == 0)
+      ring.type = LED_SOLID;
+
+    uint32_t px[PER_RING];
+    switch (ring.type) {
+      case LED_FADE:
+        if (t >= ring.periodMs) {
+          ring.type = LED_SOLID;
+          fillRing(px, ring.color);
+        } else {
+          fillRing(px, blend(ring.from, ring.color, t * 255 / ring.periodMs));
+        }
+        break;
+      case LED_PULSE:
+        {
+          uint32_t phase = (t % ring.periodMs) * 510 / ring.periodMs;  // 0..509: up then down
+          uint8_t level = phase < 255 ? phase : 509 - phase;
+          fillRing(px, scale(ring.color, 24 + level * 231 / 255));
+          break;
+        }
+      case LED_SPINNER:
+        {
+          uint8_t head = (t % ring.periodMs) * PER_RING / ring.periodMs;
+          fillRing(px, 0);
+          for (uint8_t k = 0; k <= LED_SPINNER_TAIL; k++)
+            px[(head + PER_RING - k) % PER_RING] = scale(ring.color, 255 >> k);
+          break;
+        }
+      case LED_COUNTDOWN:
+        if (t >= ring.periodMs) {
+          ring.type = LED_SOLID;
+          ring.color = 0;
+          fillRing(px, 0);
+        } else {
+          // Remaining time in 1/256ths of an LED; the last lit LED dims as it runs out
+          uint32_t left = (uint32_t)(ring.periodMs - t) * PER_RING * 256 / ring.periodMs;
+          for (uint8_t i = 0; i < PER_RING; i++) {
+            uint32_t lit = left > (uint32_t)i * 256 ? left - i * 256 : 0;
+            px[i] = lit >= 256 ? ring.color : scale(ring.color, lit);
+          }
+        }
+        break;
+      default:
+        fillRing(px, ring.color);
+        break;
+    }
+
+    bool changed = false;
+    for (uint8_t i = 0; i < PER_RING; i++) {
+      uint16_t n = r * PER_RING + i;
+      if (_strip.getPixelColor(n) != px[i]) {
+        _strip.setPixelColor(n, px[i]);
+        changed = true;
+      }
+    }
+    return changed;
+  }
+
+  static void fillRing(uint32_t *px, uint32_t color) {
+    for (uint8_t i = 0; i < PER_RING; i++)
+      px[i] = color;
+  }
+
+  // Each channel of `color` times level/255
+  static uint32_t scale(uint32_t color, uint16_t level) {
+    uint32_t r = ((color >> 16) & 0xFF) * level / 255;
+    uint32_t g = ((color >> 8) & 0xFF) * level / 255;
+    uint32_t b = (color & 0xFF) * level / 255;
+    return (r << 16) | (g << 8) | b;
+  }
+
+  // `a` to `b` in 1/255 steps
+  static uint32_t blend(uint32_t a, uint32_t b, uint8_t k) {
+    uint32_t out = 0;
+    for (uint8_t shift = 0; shift <= 16; shift += 8) {
+      int ca = (a >> shift) & 0xFF, cb = (b >> shift) & 0xFF;
+      out |= (uint32_t)(ca + (cb - ca) * k / 255) << shift;
+    }
+    return out;
+  }
+
+  LedStrip<RINGS * PER_RING> _strip;
+  Ring _rings[RINGS];
+  QueueHandle_t _queue = nullptr;
+  TaskHandle_t _task = nullptr;
+  bool _animating = false;
+  bool _pending = false;  // A changed frame that show() couldn't send yet
+  bool _pendingForWrites = false;
+  uint32_t _lastFrameMs = 0;
+  volatile uint32_t _lastShowUs = 0;  // Written by the task, read from loop()
+  uint32_t _dropped = 0;
+  LedStats _stats = {};
+};
+
+#endif  // LED_EFFECTS_H_
@@ -0,0 +1,204 @@
+#ifndef LED_STRIP_H_
+#define LED_STRIP_H_
+
+// WS2812 output through the RMT peripheral, without blocking.
+//
+// Adafruit_NeoPixel::show() waits for the whole frame to clock out: 48 LEDs
+// x 24 bits x 1.25 us is about 1.5 ms per update, spent spinning. Here
+// show() encodes the pixels into RMT symbols and starts an asynchronous
+// transmit; the peripheral refills itself from the symbol buffer by
+// interrupt while the CPU carries on. The symbol buffer is separate from
+// the pixel buffer, so pixels can be changed while a frame is going out.
+//
+// If the previous frame is still being sent, show() does nothing and
+// returns false; the caller keeps the frame pending and tries again later
+// rather than waiting.
+//
+// Pixels are stored as perceptual colours and converted on the way out:
+// each channel goes through one 256-entry table that combines gamma
+// correction (ledGamma, built at compile time) with the global brightness.
+// show() then estimates the frame's supply current from the converted
+// values and, if it exceeds the budget, scales the whole frame down to fit
+// so the LEDs can't brown out a USB supply. Both cost one lookup and one
+// add per channel; the scaling pass only runs on frames over budget.
+
+#include <Arduino.h>
+
+#define LED_RMT_HZ 10000000  // 100 ns ticks
+// WS2812 bit timings in RMT ticks: high then low time for a 0 and a 1
+#define LED_T0H 4
+#define LED_T0L 9
+#define LED_T1H 8
+#define LED_T1L 5
+#define LED_RESET_TICKS 300  // Twice per reset symbol: 60 us low latches the frame
+
+// WS2812B supply current: about 20 mA per channel at full duty, plus about
+// 1 mA per LED for the controller even when dark
+#define LED_CHANNEL_MA 20
+#define LED_IDLE_MA 1
+
+// Channel value to PWM duty for gamma 2.5 (x^2 * sqrt(x)), evaluated by the
+// compiler; the table lives in flash.
+struct LedLut {
+  uint8_t v[256];
+};
+
+constexpr double ledSqrt(double x) {
+  double r = 1;
+  for (int i = 0; i < 32; i++)
+    r = (r + x / r) / 2;
+  return r;
+}
+
+constexpr LedLut makeLedGamma() {
+  LedLut lut = {};
+  for (int i = 0; i < 256; i++) {
+    double x = i / 255.0;
+    lut.v[i] = (uint8_t)(x * x * ledSqrt(x) * 255 + 0.5);
+  }
+  return lut;
+}
+
+constexpr LedLut ledGamma = makeLedGamma();
+static_assert(ledGamma.v[0] == 0 && ledGamma.v[255] == 255, "gamma table must keep black and full");
+static_assert(ledGamma.v[128] == 46, "gamma 2.5 at half input");
+
+struct LedPower {
+  uint16_t requestedMa;  // Last frame before limiting
+  uint16_t sentMa;       // Last frame as sent
+  uint16_t peakMa;       // Highest requestedMa seen
+  uint32_t limitedFrames;
+};
+
+// 0xRRGGBB, the same packing as Adafruit_NeoPixel::Color()
+inline uint32_t ledColor(uint8_t r, uint8_t g, uint8_t b) {
+  return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+}
+
+template <uint16_t COUNT>
+class LedStrip {
+public:
+  explicit LedStrip(int8_t pin) : _pin(pin) {}
+
+  bool begin() {
+    _ready = rmtInit(_pin, RMT_TX_MODE, RMT_MEM_NUM_BLOCKS_1, LED_RMT_HZ);
+    return _ready;
+  }
+
+  // 0-255, applied on top of gamma from the next show()
+  void setBrightness(uint8_t brightness) {
+    _brightness = brightness;
+  }
+
+  // Supply current the strip may draw; 0 means unlimited
+  void setCurrentBudget(uint16_t milliamps) {
+    _budgetMa = milliamps;
+  }
+
+  const LedPower &power() const {
+    return _power;
+  }
+
+  uint16_t numPixels() const {
+    return COUNT;
+  }
+
+  void setPixelColor(uint16_t i, uint32_t color) {
+    if (i < COUNT)
+      _pixels[i] = color;
+  }
+
+  uint32_t getPixelColor(uint16_t i) const {
+    return i < COUNT ? _pixels[i] : 0;
+  }
+
+  // Start sending the current pixels. Returns false if the previous frame
+  // is still on the wire (nothing is sent) or the strip isn't set up.
+  bool show() {
+    if (!_ready || !rmtTransmitCompleted(_pin))
+      return false;
+    if (_lutBrightness != _brightness)
+      buildLut();
+
+    // Convert to duty in wire (GRB) order and add up the current
+    uint32_t duty = 0;
+    for (uint16_t i = 0; i < COUNT; i++) {
+      uint32_t c = _pixels[i];
+      uint8_t *d = _duty[i];
+      d[0] = _lut[(c >> 8) & 0xFF];
+      d[1] = _lut[(c >> 16) & 0xFF];
+      d[2] = _lut[c & 0xFF];
+      duty += d[0] + d[1] + d[2];
+    }
+    uint32_t requestedMa = COUNT * LED_IDLE_MA + duty * LED_CHANNEL_MA / 255;
+    _power.requestedMa = requestedMa;
+    _power.sentMa = requestedMa;
+    if (requestedMa > _power.peakMa)
+      _power.peakMa = requestedMa;
+    // A dark frame is over budget only if the budget is below the idle
+    // draw, which no scaling reduces
+    if (_budgetMa && requestedMa > _budgetMa && duty) {
+      // Duty the budget allows once the idle draw is paid, as an 8.8 factor
+      uint32_t idleMa = COUNT * LED_IDLE_MA;
+      uint32_t allowed = _budgetMa > idleMa ? (_budgetMa - idleMa) * 255 / LED_CHANNEL_MA : 0;
+      uint32_t factor = allowed * 256 / duty;
+      uint32_t sent = 0;
+      for (uint16_t i = 0; i < COUNT; i++) {
+        for (uint8_t k = 0; k < 3; k++) {
+          _duty[i][k] = _duty[i][k] * factor >> 8;
+          sent += _duty[i][k];
+        }
+      }
+      _power.sentMa = idleMa + sent * LED_CHANNEL_MA / 255;
+      _power.limitedFrames++;
+    }
+
+    rmt_data_t *out = _symbols;
+    for (uint16_t i = 0; i < COUNT; i++) {
+      uint32_t grb = ((uint32_t)_duty[i][0] << 16) | ((uint32_t)_duty[i][1] << 8) | _duty[i][2];
+      for (uint32_t bit = 1UL << 23; bit; bit >>= 1, out++) {
+        bool one = grb & bit;
+        out->level0 = 1;
+        out->duration0 = one ? LED_T1H : LED_T0H;
+        out->level1 = 0;
+        out->duration1 = one ? LED_T1L : LED_T0L;
+      }
+    }
+    out->level0 = 0;
+    out->duration0 = LED_RESET_TICKS;
+    out->level1 = 0;
+    out->duration1 = LED_RESET_TICKS;
+    return rmtWriteAsync(_pin, _symbols, SYMBOLS);
+  }
+
+  bool busy() const {
+    return _ready && !rmtTransmitCompleted(_pin);
+  }
+
+  // Time one frame takes to clock out, reset included
+  static constexpr uint32_t frameUs() {
+    return (COUNT * 24 * (LED_T0H + LED_T0L) + 2 * LED_RESET_TICKS) / (LED_RMT_HZ / 1000000);
+  }
+
+private:
+  void buildLut() {
+    for (uint16_t i = 0; i < 256; i++)
+      _lut[i] = (ledGamma.v[i] * _brightness + 127) / 255;
+    _lutBrightness = _brightness;
+  }
+
+  static const uint16_t SYMBOLS = COUNT * 24 + 1;  // One per bit, plus the reset
+
+  int8_t _pin;
+  bool _ready = false;
+  uint32_t _pixels[COUNT] = {};
+  uint8_t _duty[COUNT][3];
+  rmt_data_t _symbols[SYMBOLS];
+  uint8_t _lut[256];
+  uint8_t _brightness = 255;
+  int16_t _lutBrightness = -1;
+  uint16_t _budgetMa = 0;
+  LedPower _power = {};
+};
+
+#endif  // LED_STRIP_H_
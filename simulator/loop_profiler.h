@@ -0,0 +1,143 @@
+#ifndef LOOP_PROFILER_H_
+#define LOOP_PROFILER_H_
+
+// Always-on loop() iteration profiler.
+//
+// pass() at the top of loop() closes the previous iteration: the time from
+// its start to now goes into the log2 histogram of the State it started
+// in. Time the loop task spent preempted (by the display server drawing,
+// say) counts, since the game waited through it too. phase() splits an
+// iteration into named parts, typically the function about to be called;
+// each iteration remembers its longest part, so a long iteration is
+// reported with what took the time:
+//
+//   48213 us in MENU, 47980 us of it in onEvent
+//
+// Each State keeps its own longest iteration and culprit as well as the
+// overall longest. The cost is one esp_timer_get_time() per pass() and
+// phase() call plus a count-leading-zeros for the bucket, a few
+// microseconds per iteration with the half dozen phases loop() marks.
+
+#include <Arduino.h>
+#include "esp_timer.h"
+
+#define LOOP_BUCKETS 14     // Below 16 us, then doubling; the last one takes the rest
+#define LOOP_BUCKET0_US 16
+#define LOOP_BUCKET0_LOG2 4
+
+template <uint8_t STATES>
+class LoopProfiler {
+public:
+  // Start of an iteration in `state`, whose first phase is `phase`;
+  // closes the one before
+  void pass(uint8_t state, const char *phase) {
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    if (_passStartUs) {
+      closePhase(now);
+      record(now - _passStartUs);
+    }
+    _state = state < STATES ? state : 0;
+    _passStartUs = now;
+    _phaseStartUs = now;
+    _phase = phase;
+    _worstPhase = nullptr;
+    _worstPhaseUs = 0;
+  }
+
+  // The rest of this iteration, until the next phase() or pass(), is `name`
+  void phase(const char *name) {
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    closePhase(now);
+    _phase = name;
+    _phaseStartUs = now;
+  }
+
+  void dump(Print &out, const char *(*stateName)(uint8_t)) const {
+    out.println("--- Loop iterations ---");
+    out.printf("%-32s %8s %7s %8s  iterations per duration, upper bounds in us:\n", "state", "passes", "mean",
+               "max");
+    out.printf("%-32s %8s %7s %8s ", "", "", "", "");
+    for (uint8_t i = 0; i < LOOP_BUCKETS - 1; i++)
+      out.printf(" %6lu", (unsigned long)LOOP_BUCKET0_US << i);
+    out.println("   more");
+    for (uint8_t s = 0; s < STATES; s++) {
+      const PerState &p = _states[s];
+      if (!p.passes)
+        continue;
+      out.printf("%-32s %8lu %7lu %8lu ", stateName(s), (unsigned long)p.passes,
+                 (unsigned long)(p.sumUs / p.passes), (unsigned long)p.worst.us);
+      for (uint8_t i = 0; i < LOOP_BUCKETS; i++)
+        out.printf(" %6lu", (unsigned long)p.buckets[i]);
+      out.println();
+    }
+    out.println("longest iteration per state:");
+    for (uint8_t s = 0; s < STATES; s++) {
+      if (_states[s].passes)
+        printStall(out, _states[s].worst, stateName);
+    }
+    out.print("overall: ");
+    printStall(out, _longest, stateName);
+  }
+
+private:
+  struct Stall {
+    uint32_t us;
+    uint8_t state;
+    const char *phase;
+    uint32_t phaseUs;
+  };
+
+  struct PerState {
+    uint32_t passes;
+    uint64_t sumUs;
+    uint32_t buckets[LOOP_BUCKETS];
+    Stall worst;
+  };
+
+  void closePhase(uint32_t now) {
+    uint32_t us = now - _phaseStartUs;
+    if (us >= _worstPhaseUs) {
+      _worstPhaseUs = us;
+      _worstPhase = _phase;
+    }
+  }
+
+  void record(uint32_t us) {
+    PerState &p = _states[_state];
+    p.passes++;
+    p.sumUs += us;
+    p.buckets[bucket(us)]++;
+    if (us > p.worst.us) {
+      p.worst = Stall{ us, _state, _worstPhase, _worstPhaseUs };
+      if (us > _longest.us)
+        _longest = p.worst;
+    }
+  }
+
+  static uint8_t bucket(uint32_t us) {
+    if (us < LOOP_BUCKET0_US)
+      return 0;
+    uint8_t i = 32 - __builtin_clz(us) - LOOP_BUCKET0_LOG2;
+    return i < LOOP_BUCKETS ? i : LOOP_BUCKETS - 1;
+  }
+
+  static void printStall(Print &out, const Stall &stall, const char *(*stateName)(uint8_t)) {
+    if (!stall.us) {
+      out.println("none");
+      return;
+    }
+    out.printf("%lu us in %s, %lu us of it in %s\n", (unsigned long)stall.us, stateName(stall.state),
+               (unsigned long)stall.phaseUs, stall.phase ? stall.phase : "?");
+  }
+
+  PerState _states[STATES] = {};
+  Stall _longest = {};
+  uint8_t _state = 0;
+  uint32_t _passStartUs = 0;
+  uint32_t _phaseStartUs = 0;
+  const char *_phase = nullptr;
+  const char *_worstPhase = nullptr;
+  uint32_t _worstPhaseUs = 0;
+};
+
+#endif  // LOOP_PROFILER_H_
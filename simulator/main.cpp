@@ -3,43 +3,59 @@
 #include <WiFi.h>
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
-#include <Adafruit_NeoPixel.h>
 #include "esp_wpa2.h"  // Only needed for WPA2-Enterprise
 #include <WiFiClientSecure.h>
+#include <Preferences.h>
 #include <vector>
 #include <time.h>
+#include "render_stats.h"
+#include "timeline.h"
+#include "roster_list.h"
+#include "touch_ft6206.h"
+#include "led_effects.h"
+#include "button_input.h"
+#include "keypad_scanner.h"
+#include "input_bus.h"
+#include "reaction_stats.h"
+#include "latency_probe.h"
+#include "stimulus_scheduler.h"
+#include "state_machine.h"
+#include "net_worker.h"
+#include "display_server.h"
+#include "script_runner.h"
+#include "loop_profiler.h"
+#include "stall_watchdog.h"
+#include "power_manager.h"
+#include "game_arena.h"
+#include "checkpoint.h"
+#include "assets/star.h"
+#include "assets/loading_ring.h"
+#include "assets/code_breaker_title.h"
+#include "assets/color_word_title.h"
+#include "assets/led_reaction_title.h"
 
-unsigned long colorWordStepStartTime = 0;
 enum CodeBreakerDifficulty {
   CB_EASY,
   CB_MEDIUM,
   CB_HARD
 };
-CodeBreakerDifficulty codeBreakerDifficulty = CB_EASY;  // Default
-int codeBreakerMaxTries = 12;
+const int codeBreakerMaxTries[3] = { 12, 8, 5 };  // Easy, medium, hard
 enum LedReactionDifficulty {
   LED_EASY,
   LED_MEDIUM,
   LED_HARD
 };
-LedReactionDifficulty ledReactionDifficulty = LED_EASY;
 const unsigned long ledReactionDurations[3] = { 2000, 1000, 500 };  // ms: easy, medium, hard
-unsigned long ledReactionStepDuration = 2000;                       // default to easy
 
-int colorWordStars = 0;
 enum Difficulty {
   EASY,
   MEDIUM,
   HARD
 };
-Difficulty colorWordDifficulty = EASY;
-bool ledReactionWaiting = false;  // true when in the white screen delay
-unsigned long ledReactionDelayStart = 0;
-const unsigned long ledReactionDelayDuration = 1000;  // 1 second
+const unsigned long ledReactionDelayDuration = 1000;  // 1 second of white between colours
 
 const unsigned long colorWordDurations[3] = { 7000, 4000, 2000 };  // ms: easy, medium, hard
-// Global variables (near the top of your file)
-unsigned long colorWordStepDuration = 7000;  // Default to easy (7 seconds)
+const uint8_t visualMemoryLengths[3] = { 5, 8, 10 };                 // Colours: easy, medium, hard
 
 // --- PIN DEFINITIONS (TOP) ---
 #define TFT_SCLK 18
@@ -57,12 +73,24 @@ unsigned long colorWordStepDuration = 7000;  // Default to easy (7 seconds)
 #define BLUE_BUTTON_PIN 22
 #define GREEN_BUTTON_PIN 5
 
+// Cap-touch controller (FT6206) on the display's I2C pins
+#define TOUCH_SDA 17
+#define TOUCH_SCL 0
+#ifdef WOKWI_SIMULATION
+#define TOUCH_INT -1  // Wokwi's panel has no INT pin; the driver polls
+#else
+#define TOUCH_INT 35
+#endif
+
 // Led definitions
 #define WS2812_PIN 16
 #define LEDS_PER_RING 16
 #define NUM_RINGS 3
 #define WS2812_NUM_LEDS (LEDS_PER_RING * NUM_RINGS)
-Adafruit_NeoPixel leds(WS2812_NUM_LEDS, WS2812_PIN, NEO_GRB + NEO_KHZ800);
+#define LED_SPINNER_MS 800  // One turn of the loading spinner
+#define LED_BRIGHTNESS 192  // Global, after gamma
+#define LED_BUDGET_MA 500   // What the rings may draw from a USB supply
+LedEffects<NUM_RINGS, LEDS_PER_RING> leds(WS2812_PIN);
 
 // Visual Memory Game
 #define MAX_SEQUENCE_LENGTH 10
@@ -71,58 +99,117 @@ uint16_t colorValues[] = { RED, BLUE, GREEN };  // TFT color values
 
 // --- Color-Word Challenge definitions ---
 #define COLOR_WORD_CHALLENGE_LENGTH 5
-uint8_t cwcSeq1[COLOR_WORD_CHALLENGE_LENGTH];
-uint8_t cwcSeq2[COLOR_WORD_CHALLENGE_LENGTH];
-
-// --- Color-Word Challenge game variables ---
-int colorWordWrongTries = 0;
-uint8_t colorWordCurrentStep = 0;
 const int colorWordMaxTries = 5;  // same as sequence length
 
-// --- Led Reaction game variables ---
-unsigned long ledReactionStartTime = 0;
+// --- Led Reaction ---
 const unsigned long ledReactionGameDuration = 20000;  // 20 seconds in ms
-int ledReactionCorrect = 0;
-int ledReactionCurrentColor = 0;
-bool ledReactionActive = false;
+LatencyProbe latencyProbe;                            // Press-to-photon diagnostic, toggled with 'P'
+StimulusScheduler stimuli;                            // Colours and words on and off at esp_timer deadlines
+
+// Firestore game documents, in GameId order
+enum GameId : uint8_t {
+  GAME_CODE_BREAKER,
+  GAME_VISUAL_MEMORY,
+  GAME_COLOR_WORD,
+  GAME_LED_REACTION
+};
+const char *const gameDocNames[] = { "code_breaker_game", "visual_memory_challenge", "color_word_game",
+                                     "LED_reaction_game" };
+#define NO_HIGH_SCORE -1
+
+// A finished game, uploaded from the network core
+struct SessionUpload {
+  GameId game;
+  uint8_t player;  // Index into playerDocIds
+  int16_t coins;
+  int16_t score;
+  // Fetch the stored high score and, if `beats` is above it, store
+  // `highScore`. NO_HIGH_SCORE skips both.
+  int16_t beats;
+  int16_t highScore;
+  ReactionStats reaction;  // LED Reaction only
+};
+#define NET_QUEUE_LEN 4
+NetWorker<SessionUpload, NET_QUEUE_LEN> netWorker;  // Uploads and gameplay logging, on core 0
 
 // Multiplayer game variables
 byte multiplayerPlayer1 = 0;  // 1-based index
 byte multiplayerPlayer2 = 0;  // 1-based index
 
-// --- Code Breaker multiplayer game variables ---
-// --- Secret numbers for each player (3 digits + null terminator) ---
-char player1Secret[4] = "";  // Player 1's secret number (as a string)
-char player2Secret[4] = "";  // Player 2's secret number (as a string)
-
-// --- Current guess buffers for each player ---
-char player1Guess[4] = "";  // Player 1's current guess (as a string)
-char player2Guess[4] = "";  // Player 2's current guess (as a string)
-
-bool cbSecretNeedsRedraw = true;
+// --- Per-game state ---
+// Everything a session changes lives in its game's struct, constructed
+// when the game starts and destroyed when the menus come back; the member
+// initialisers are the reset. Each game deals its content (secret,
+// sequence, words) as it starts, so a game resumed from a checkpoint can
+// be started with its own instead. 'g' prints the arena.
+
+struct CodeBreakerGame {
+  static constexpr const char *name = "Code Breaker";
+  uint8_t level;
+  int maxWrongTries;
+  int wrongTries = 0;
+  char secret[4] = "";  // The number to guess
+  char input[4] = "";   // 3 chars + null terminator
+  byte inputIndex = 0;
+
+  explicit CodeBreakerGame(uint8_t level = CB_EASY) : level(level), maxWrongTries(codeBreakerMaxTries[level]) {}
+};
 
-// --- Try counters (optional, for stats) ---
-uint8_t player1Tries = 0;  // Number of guesses Player 1 has made
-uint8_t player2Tries = 0;  // Number of guesses Player 2 has made
+struct VisualMemoryGame {
+  static constexpr const char *name = "Visual Memory";
+  uint8_t level;
+  uint8_t length;
+  uint8_t sequence[MAX_SEQUENCE_LENGTH] = {};
+  int wrongTries = 0;
 
-// --- Whose turn is it? ---
-bool codeBreakerMultiplayerTurn = false;  // false = Player 1's turn, true = Player 2's turn
+  explicit VisualMemoryGame(uint8_t level = 0) : level(level), length(visualMemoryLengths[level]) {}
+};
 
-// --- Input buffer index for entering numbers ---
-uint8_t cbMultiInputIndex = 0;  // For multiplayer code breaker digit entry
+struct ColorWordGame {
+  static constexpr const char *name = "Color-Word Challenge";
+  uint8_t level;
+  unsigned long stepDuration;                       // ms to answer each word
+  uint8_t words[COLOR_WORD_CHALLENGE_LENGTH] = {};  // The colour each word names
+  uint8_t inks[COLOR_WORD_CHALLENGE_LENGTH] = {};   // The colour it is printed in
+  uint8_t step = 0;
+  int wrongTries = 0;
+  uint32_t stepPostedUs = 0;  // When the current word was posted; its time runs from here
+  uint32_t stepScreen = 0;    // Its screen, for when it reached the panel
+
+  explicit ColorWordGame(Difficulty level = EASY) : level(level), stepDuration(colorWordDurations[level]) {}
+};
 
-// --- (Optional) Game over flags ---
-bool player1Guessed = false;
-bool player2Guessed = false;
+struct LedReactionGame {
+  static constexpr const char *name = "LED Reaction";
+  uint8_t level;
+  unsigned long stepDuration;  // ms each colour stays up
+  unsigned long startTime = 0;
+  unsigned long playedMs = 0;  // Before a restart, for a resumed game
+  int correct = 0;
+  ReactionStats times;  // Colour-to-press time of every counted press
+  int currentColor = 0;
+  bool active = false;
+
+  explicit LedReactionGame(LedReactionDifficulty level = LED_EASY)
+      : level(level), stepDuration(ledReactionDurations[level]) {}
+};
 
-// --- Last guess results for each player ---
-char player1LastGuess[4] = "";
-int player1LastExact = 0;
-int player1LastPartial = 0;
+struct MultiCodeBreakerGame {
+  static constexpr const char *name = "Code Breaker, 2 players";
+  struct Player {
+    char secret[4] = "";     // 3 digits + null terminator
+    char guess[4] = "";      // This turn's guess
+    char lastGuess[4] = "";  // Shown with its result on the player's next turn
+    int lastExact = 0;
+    int lastPartial = 0;
+    uint8_t tries = 0;
+  };
+  Player players[2];
+};
 
-char player2LastGuess[4] = "";
-int player2LastExact = 0;
-int player2LastPartial = 0;
+GameArena<CodeBreakerGame, VisualMemoryGame, ColorWordGame, LedReactionGame, MultiCodeBreakerGame> games;
+const char *const gameTitles[] = { CodeBreakerGame::name, VisualMemoryGame::name, ColorWordGame::name,
+                                   LedReactionGame::name };  // By GameId
 
 // Keypad definitions
 const byte ROWS = 4;
@@ -139,21 +226,62 @@ byte rowPins[ROWS] = { 14, 12, 27, 13 };
 byte colPins[COLS] = { 25, 33, 32 };
 
 Keypad keypad = Keypad(makeKeymap(keys), rowPins, colPins, ROWS, COLS);
+KeypadScanner keypadScanner(keypad);  // Owns keypad once begun
+
+// Timed screen and LED sequences, ticked from loop() instead of delay()
+Timeline timeline;
+
+// The game flow written as a coroutine, resumed from its state's handlers
+ScriptRunner scripts;
+
+// Touch input: taps on menu lines act like the keypad key for that line
+Ft6206Touch touch;
+GestureRecognizer gestures;
+TouchMap touchMap;
+bool touchTrace = false;           // Print samples in host/traces format
+uint32_t touchActionStartUs = 0;   // Gesture completion time of the action in flight
+uint32_t touchShownBatch = 0;      // The display batch carrying its response, once committed
+uint32_t touchShownStartUs = 0;
+uint32_t touchLatencyCount = 0;
+uint64_t touchLatencySumUs = 0;
+uint32_t touchLatencyMaxUs = 0;
+
+// Make a menu line tappable: the band around text printed at y acts as `key`
+void addTouchRow(int16_t y, char key) {
+  touchMap.add(0, y - 7, SCREEN_WIDTH, 30, key);
+}
 
 // Set up the SPI bus and display
-Arduino_ESP32SPI bus(TFT_DC, TFT_CS, TFT_SCLK, TFT_MOSI, TFT_MISO);
+InstrumentedBus<Arduino_ESP32SPI> bus(TFT_DC, TFT_CS, TFT_SCLK, TFT_MOSI, TFT_MISO);
 Arduino_ILI9341 display(&bus, TFT_RST);
 
-char inputBuffer[4];  // 3 chars + null terminator
-byte inputIndex = 0;
-char randomNumberStr[4];
+// Scrolling player list shared by the single and multiplayer pickers. The
+// loop moves rosterWindow; the renderers draw copies of it with roster.
+const char *playerLabel(int index);
+RosterList roster(display, playerLabel, BLACK, WHITE, DARKGREY, LIGHTGREY);
+RosterWindow rosterWindow;
+
+DrawArgs rosterArgs(const RosterWindow &window) {
+  return DrawArgs(window.count, window.exclude, window.top);
+}
+
+RosterWindow rosterWindowOf(const DrawArgs &args) {
+  return RosterWindow{ args.a, args.b, args.c };
+}
+
+// Owns display and roster once begun; game logic posts screens to it
+DisplayServer screens;
+
 byte currentPlayer = 0;
-uint8_t colorSequence[MAX_SEQUENCE_LENGTH];
-uint8_t colorSequenceLength = 5;
-uint8_t currentStep = 0;
-unsigned long lastDebounceTime[3] = { 0, 0, 0 };
-const unsigned long debounceDelay = 200;
-int lastButtonState[3] = { HIGH, HIGH, HIGH };
+
+// Game buttons, in colour index order, timestamped by interrupt
+const uint8_t buttonPins[3] = { RED_BUTTON_PIN, BLUE_BUTTON_PIN, GREEN_BUTTON_PIN };
+ButtonInput buttons;
+BounceCapture bounceCapture;  // Raw edge timings while 'b' capture is on
+bool bounceCapturing = false;
+
+// Keypad, buttons and touch merged into one time-ordered event stream
+InputBus inputBus;
 
 enum State {
   MODE_SELECT,
@@ -173,13 +301,35 @@ enum State {
   VISUAL_MEMORY_DIFFICULTY_SELECT,
   VISUAL_MEMORY,
   VISUAL_MEMORY_INPUT,
-  VISUAL_MEMORY_RESULT,
   LED_REACTION_DIFFICULTY_SELECT,
-
-  COLOR_WORD_CHALLENGE_INPUT,
-  LED_REACTION
+  LED_REACTION,
+  RESUME_OFFER,
+  STATE_COUNT
 };
-State currentState = PLAYER_SELECT;
+// Defined with its table of handlers further down
+extern StateMachine stateMachine;
+
+const char *stateName(uint8_t state) {
+  return stateMachine.name(state);
+}
+
+// loop() iteration times per State, printed with 'L' or by holding * and #
+// together on the keypad
+LoopProfiler<STATE_COUNT> loopProfiler;
+uint8_t profileChordKeys = 0;  // Bit 0: '*' held, bit 1: '#' held
+
+// Catches the loop stuck, with a record that survives a restart
+RTC_NOINIT_ATTR StallRecord stallRecord;
+StallWatchdog stallWatchdog;
+
+// The single-player game in progress, kept through a restart or a power
+// cut; 'C' prints the store
+RTC_NOINIT_ATTR CheckpointRecord checkpointRecord;
+CheckpointStore checkpoints;
+Checkpoint resumeOffer;  // What the last run left unfinished, offered on RESUME_OFFER
+
+// Slower clock and light sleep on the menus; 'w' prints the wake latencies
+PowerManager power;
 
 // WiFi credentials
 #ifdef WOKWI_SIMULATION
@@ -209,14 +359,8 @@ const char *collection = "users";
 std::vector<String> playerNames;
 std::vector<String> playerDocIds;
 int playerCount = 0;  // Will be updated after fetching
-int maxToShow = 0;
-int playerDisplayOffset = 0;  // For paging through playerNames
 
-// Game variables for number of tries
-int codeBreakerWrongTries = 0;
-int visualMemoryWrongTries = 0;
-int maxWrongTries = 5;
-int maxWrongTries_VM = 3;  // For Visual Memory game
+const int maxWrongTries_VM = 3;  // For Visual Memory game
 
 // Call this once after WiFi connects
 void setupTime() {
@@ -242,6 +386,7 @@ String getCurrentISOTimeUTC() {
 
 
 void showLedReactionScore(int score) {
+  RENDER_SCOPE();
   display.fillScreen(WHITE);
   display.setTextSize(3);
   display.setTextColor(BLACK);
@@ -253,10 +398,10 @@ void showLedReactionScore(int score) {
   int y = (SCREEN_HEIGHT - 3 * 8) / 2;
   display.setCursor(x, y);
   display.print(msg);
-  delay(2000);  // Show for 2 seconds
 }
 
 void showLedReactionDifficultySelect() {
+  RENDER_SCOPE();
   display.fillScreen(WHITE);
   display.setTextSize(2);
   display.setTextColor(BLACK);
@@ -268,9 +413,15 @@ void showLedReactionDifficultySelect() {
   display.print("2. Medium (1s)");
   display.setCursor(40, 180);
   display.print("3. Hard (0.5s)");
+  touchMap.begin(LED_REACTION_DIFFICULTY_SELECT);
+  addTouchRow(100, '1');
+  addTouchRow(140, '2');
+  addTouchRow(180, '3');
+  touchMap.end();
 }
 
 void showColorWordDifficultySelect() {
+  RENDER_SCOPE();
   display.fillScreen(WHITE);
   display.setTextSize(2);
   display.setTextColor(BLACK);
@@ -282,19 +433,22 @@ void showColorWordDifficultySelect() {
   display.print("2. Medium (4s)");
   display.setCursor(40, 180);
   display.print("3. Hard (2s)");
+  touchMap.begin(COLOR_WORD_DIFFICULTY_SELECT);
+  addTouchRow(100, '1');
+  addTouchRow(140, '2');
+  addTouchRow(180, '3');
+  touchMap.end();
 }
 
 void showColorOnRings(int colorIndex) {
   uint32_t color;
   if (colorIndex == 0)
-    color = leds.Color(255, 0, 0);  // Red
+    color = ledColor(255, 0, 0);  // Red
   else if (colorIndex == 1)
-    color = leds.Color(0, 0, 255);  // Blue
+    color = ledColor(0, 0, 255);  // Blue
   else
-    color = leds.Color(0, 255, 0);  // Green
-  for (int i = 0; i < WS2812_NUM_LEDS; i++)
-    leds.setPixelColor(i, color);
-  leds.show();
+    color = ledColor(0, 255, 0);  // Green
+  leds.play(leds.ALL, LED_SOLID, color);
 }
 
 // --- Color-Word Challenge helpers ---
@@ -309,21 +463,24 @@ void generateColorWordChallengeSequences(uint8_t seq1[], uint8_t seq2[], uint8_t
   }
 }
 
-void showColorWordChallengeStep(uint8_t index) {
+// The colour name `word`, printed in the colour `ink`
+void showColorWordChallengeStep(uint8_t word, uint8_t ink) {
+  RENDER_SCOPE();
   display.fillScreen(WHITE);
   display.setTextSize(3);
-  display.setTextColor(colorValues[cwcSeq2[index]]);
+  display.setTextColor(colorValues[ink]);
   int16_t x1, y1;
   uint16_t w, h;
-  display.getTextBounds(colorNames[cwcSeq1[index]], 0, 0, &x1, &y1, &w, &h);
+  display.getTextBounds(colorNames[word], 0, 0, &x1, &y1, &w, &h);
   int x = (SCREEN_WIDTH - w) / 2;
   int y = (SCREEN_HEIGHT - 3 * 8) / 2;
   display.setCursor(x, y);
-  display.print(colorNames[cwcSeq1[index]]);
+  display.print(colorNames[word]);
 }
 
 // --- Display helpers ---
 void showBottomHints() {
+  RENDER_SCOPE();
   display.setTextSize(1);
   display.setTextColor(DARKGREY);
   int y = SCREEN_HEIGHT - 10;
@@ -337,7 +494,29 @@ void showBottomHints() {
   display.print(logoutText);
 }
 
+// Draw a compressed image from flash onto a cleared (white) screen
+void drawImage(int16_t x, int16_t y, const RleImage &img) {
+  drawRleImage(display, bus, x, y, img, false);
+}
+
+void drawImageCentered(int16_t y, const RleImage &img) {
+  drawImage((SCREEN_WIDTH - img.width) / 2, y, img);
+}
+
+// Blank screen with only the navigation hints
+void showBlankWithHints() {
+  RENDER_SCOPE();
+  display.fillScreen(WHITE);
+  showBottomHints();
+}
+
+// Timeline step: clear a title screen down to the hints
+void stepClearToBottomHints(uint8_t) {
+  screens.screen(showBlankWithHints);
+}
+
 void showGuessScreen(uint8_t player, uint8_t tries) {
+  RENDER_SCOPE();
   display.fillScreen(WHITE);
   display.setTextColor(BLACK);
   display.setTextSize(2);
@@ -381,6 +560,7 @@ void cbMultiCountMatches(const char *guess, const char *secret, int &exact, int
 }
 
 void showSecretEntry(uint8_t player, const char *buffer, uint8_t bufLen) {
+  RENDER_SCOPE();
   display.fillScreen(WHITE);
   display.setTextColor(BLACK);
   display.setTextSize(2);
@@ -406,6 +586,7 @@ void showSecretEntry(uint8_t player, const char *buffer, uint8_t bufLen) {
 
 // Show the mode selection screen
 void showModeSelect() {
+  RENDER_SCOPE();
   display.fillScreen(WHITE);
 
   // --- Title ---
@@ -462,6 +643,11 @@ void showModeSelect() {
   display.setCursor(btnX + 55, btnY2 + btnHeight / 2 - 6);
   display.print("Multiplayer");
 
+  touchMap.begin(MODE_SELECT);
+  touchMap.add(btnX, btnY1, btnWidth, btnHeight, '1');
+  touchMap.add(btnX, btnY2, btnWidth, btnHeight, '2');
+  touchMap.end();
+
   // --- Shortcut hint at bottom ---
   display.setTextSize(1);
   display.setTextColor(DARKGREY);
@@ -471,124 +657,140 @@ void showModeSelect() {
   display.print(hint);
 }
 
-// Show the multiplayer player selection screen, first for player 1 then for player 2
-void showMultiplayerPlayerSelect1() {
-  display.fillScreen(WHITE);
-  display.setTextColor(BLACK);
-  display.setTextSize(2);
-  display.setCursor(20, 60);
-  display.print("Choose Player 1:");
-  int y = 100;
-  int shown = 0;
-  // for (int i = playerDisplayOffset; i < playerNames.size() && shown < 4; i++) {
-  for (int i = 0; i < maxToShow; i++) {
-    display.setCursor(20, y);
-    display.print(String(i + 1) + ") " + playerNames[playerDisplayOffset + i]);
-    y += 30;
-    ++shown;
-  }
-  // --- Add this for # logout at bottom right ---
-  const char *logoutText = "# logout";
+const char *playerLabel(int index) {
+  return playerNames[index].c_str();
+}
+
+// "7/9 scroll" bottom left when the roster doesn't fit, "# logout" bottom right
+void showRosterHints(const RosterWindow &window) {
   int16_t x1, y1;
   uint16_t w, h;
   display.setTextSize(1);
   display.setTextColor(DARKGREY);
+  if (window.count > ROSTER_ROWS) {
+    display.setCursor(0, SCREEN_HEIGHT - 10);
+    display.print("7/9 scroll");
+  }
+  const char *logoutText = "# logout";
   display.getTextBounds(logoutText, 0, 0, &x1, &y1, &w, &h);
   display.setCursor(SCREEN_WIDTH - w, SCREEN_HEIGHT - 10);
   display.print(logoutText);
 }
 
-void showMultiplayerPlayerSelect2(byte excludeIndex) {
+// Roster rows are tappable; swipes scroll them (see touchKey())
+void addRosterTouchRows(State owner) {
+  touchMap.begin(owner);
+  for (uint8_t r = 0; r < ROSTER_ROWS; r++)
+    touchMap.add(0, ROSTER_TOP - 7 + r * ROSTER_ROW_HEIGHT, ROSTER_BAR_X, ROSTER_ROW_HEIGHT, '1' + r);
+  touchMap.end();
+}
+
+// Show the multiplayer player selection screen, first for player 1 then for player 2
+void showMultiplayerPlayerSelect1(const RosterWindow &window) {
+  RENDER_SCOPE();
+  display.fillScreen(WHITE);
+  display.setTextColor(BLACK);
+  display.setTextSize(2);
+  display.setCursor(20, 60);
+  display.print("Choose Player 1:");
+  roster.draw(window);
+  showRosterHints(window);
+  addRosterTouchRows(PLAYER1_SELECT);
+}
+
+void showMultiplayerPlayerSelect2(const RosterWindow &window) {
+  RENDER_SCOPE();
   display.fillScreen(WHITE);
   display.setTextColor(BLACK);
   display.setTextSize(2);
   display.setCursor(20, 60);
   display.print("Choose Player 2:");
-  int y = 100;
-  int optionNum = 1;
-  int shown = 0;
-  for (int i = playerDisplayOffset; i < playerNames.size() && shown < 4; i++) {
-    if (i == excludeIndex)
-      continue;  // skip the chosen player
-    display.setCursor(20, y);
-    display.print(String(optionNum) + ") " + playerNames[i]);
-    y += 30;
-    optionNum++;
-    ++shown;
-  }
-  // --- Add this for # logout at bottom right ---
-  const char *logoutText = "# logout";
-  int16_t x1, y1;
-  uint16_t w, h;
-  display.setTextSize(1);
-  display.setTextColor(DARKGREY);
-  display.getTextBounds(logoutText, 0, 0, &x1, &y1, &w, &h);
-  display.setCursor(SCREEN_WIDTH - w, SCREEN_HEIGHT - 10);
-  display.print(logoutText);
+  roster.draw(window);
+  showRosterHints(window);
+  addRosterTouchRows(PLAYER2_SELECT);
 }
 
-void showNextLedReactionColor() {
-  ledReactionCurrentColor = random(0, 3);
+// LED Reaction colours are stimuli: the rings switch from the esp_timer
+// task at the scheduled moments and the screen follows from loop().
+void lightLedReactionRings(uint8_t colorIdx) {
   uint32_t color;
-  if (ledReactionCurrentColor == 0)
-    color = leds.Color(255, 0, 0);  // Red
-  else if (ledReactionCurrentColor == 1)
-    color = leds.Color(0, 0, 255);  // Blue
+  if (colorIdx == 0)
+    color = ledColor(255, 0, 0);  // Red
+  else if (colorIdx == 1)
+    color = ledColor(0, 0, 255);  // Blue
   else
-    color = leds.Color(0, 255, 0);  // Green
+    color = ledColor(0, 255, 0);  // Green
+  leds.play(leds.ALL, LED_SOLID, color);
+  leds.commit();
+}
 
-  for (int i = 0; i < WS2812_NUM_LEDS; i++)
-    leds.setPixelColor(i, color);
-  leds.show();
+void clearLedReactionRings(uint8_t) {
+  leds.off();
+  leds.commit();
+}
+
+// Pick the next colour and have it come on at `onUs` for one step
+void scheduleLedReactionColor(uint32_t onUs) {
+  LedReactionGame &game = games.as<LedReactionGame>();
+  game.currentColor = random(0, 3);
+  stimuli.schedule(game.currentColor, onUs, game.stepDuration * 1000UL, lightLedReactionRings,
+                   clearLedReactionRings);
+}
 
-  // Fill the entire TFT screen with the color (no text)
-  display.fillScreen(colorValues[ledReactionCurrentColor]);
+// Fill the entire TFT screen with the colour (no text)
+void showLedReactionStimulus(uint8_t color) {
+  RENDER_SCOPE();
+  display.fillScreen(colorValues[color]);
 }
 
 void showPlayerSelected(byte player) {
+  RENDER_SCOPE();
   display.fillScreen(WHITE);
   display.setTextColor(BLACK);
   display.setTextSize(2);
   display.setCursor(20, 100);
   display.print("Welcome back :)");
   display.setCursor(20, 140);
-  // player is 1-based, array is 0-based
-  int actualIndex = playerDisplayOffset + (player - 1);
-  Serial.println(actualIndex);
-  Serial.println(player);
   if (player >= 1 && player < playerNames.size()) {
     display.print(playerNames[player]);
   } else {
     display.print("Unknown Player");
   }
-  delay(1200);
 }
 
 // Show single player games menu
 void showMenu() {
+  RENDER_SCOPE();
   display.fillScreen(WHITE);
   display.setTextColor(BLACK);
   display.setTextSize(2);
   int y = 40;
   display.setCursor(20, y);
   display.print("Choose your game:");
+  touchMap.begin(MENU);
   y += 40;
   display.setCursor(20, y);
   display.print("1) Code breaker");
+  addTouchRow(y, '1');
   y += 30;
   display.setCursor(20, y);
   display.print("2) Visual memory");
+  addTouchRow(y, '2');
   y += 30;
   display.setCursor(20, y);
   display.print("3) Color Word");
+  addTouchRow(y, '3');
   y += 30;
   display.setCursor(20, y);
   display.print("4) Led Reaction");
+  addTouchRow(y, '4');
+  touchMap.end();
   showBottomHints();
 }
 
 // Show multiplayer games menu
 void showMultiplayerMenu() {
+  RENDER_SCOPE();
   display.fillScreen(WHITE);
   display.setTextColor(BLACK);
   display.setTextSize(2);
@@ -597,6 +799,9 @@ void showMultiplayerMenu() {
   int y = 110;
   display.setCursor(20, y);
   display.print("1) Code Breaker");
+  touchMap.begin(MULTI_MENU);
+  addTouchRow(y, '1');
+  touchMap.end();
   // --- Add this for # logout at bottom right ---
   const char *logoutText = "# logout";
   int16_t x1, y1;
@@ -609,6 +814,7 @@ void showMultiplayerMenu() {
 }
 
 void showMenuMessage(const char *msg) {
+  RENDER_SCOPE();
   int msgHeight = 40;
   display.fillRect(0, SCREEN_HEIGHT - msgHeight, SCREEN_WIDTH, msgHeight, WHITE);
   display.setTextColor(BLUE);
@@ -618,30 +824,24 @@ void showMenuMessage(const char *msg) {
 }
 
 void showColorWordTitle() {
+  RENDER_SCOPE();
   display.fillScreen(WHITE);
-  display.setTextColor(BLACK);
-  display.setTextSize(2);
-
-  const char *title = "Color Word";
-  int16_t x1, y1;
-  uint16_t w, h;
-  display.getTextBounds(title, 0, 0, &x1, &y1, &w, &h);
-  int x = (SCREEN_WIDTH - w) / 2;
-  int y = 100;
-
-  display.setCursor(x, y);
-  display.print(title);
-  delay(2000);
+  drawImageCentered(80, colorWordTitleImage);
+}
 
-  display.fillScreen(WHITE);
-  showBottomHints();
+void newCodeBreakerNumber() {
+  CodeBreakerGame &game = games.as<CodeBreakerGame>();
+  int randomNumber = random(0, 1000) % 1000;
+  game.secret[0] = '0' + randomNumber / 100;
+  game.secret[1] = '0' + randomNumber / 10 % 10;
+  game.secret[2] = '0' + randomNumber % 10;
+  game.secret[3] = '\0';
+  netWorker.log("New random number: %s\n", game.secret);
 }
 
-void generateNewRandomNumber() {
-  int randomNumber = random(0, 1000);
-  snprintf(randomNumberStr, sizeof(randomNumberStr), "%03d", randomNumber);
-  Serial.print("New random number: ");
-  Serial.println(randomNumberStr);
+// The number to guess, hidden, over a cleared play area
+void showHiddenNumber() {
+  RENDER_SCOPE();
   int charWidth = 6 * 2;
   int charHeight = 8 * 2;
   int numChars = 3;
@@ -658,7 +858,13 @@ void generateNewRandomNumber() {
   showBottomHints();
 }
 
+void generateNewRandomNumber() {
+  newCodeBreakerNumber();
+  showHiddenNumber();
+}
+
 void showCodeBreakerResult(int exact, int partial) {
+  RENDER_SCOPE();
   int y = 90;
   display.fillRect(0, y, SCREEN_WIDTH, 60, WHITE);
   display.setTextSize(2);
@@ -673,6 +879,7 @@ void showCodeBreakerResult(int exact, int partial) {
 }
 
 void showLastTry(const char *guess) {
+  RENDER_SCOPE();
   int y = 150;
   display.fillRect(0, y, SCREEN_WIDTH, 30, WHITE);
   display.setTextColor(DARKGREY);
@@ -683,6 +890,7 @@ void showLastTry(const char *guess) {
 }
 
 void showCodeBreakerDifficultyMenu() {
+  RENDER_SCOPE();
   display.fillScreen(WHITE);
   display.setTextColor(BLACK);
   display.setTextSize(2);
@@ -694,22 +902,23 @@ void showCodeBreakerDifficultyMenu() {
   display.print("2) Medium (8 tries)");
   display.setCursor(20, 190);
   display.print("3) Hard (5 tries)");
+  touchMap.begin(CODE_BREAKER_DIFFICULTY_SELECT);
+  addTouchRow(110, '1');
+  addTouchRow(150, '2');
+  addTouchRow(190, '3');
+  touchMap.end();
   showBottomHints();
 }
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void showCodeBreakerTitle() {
+  RENDER_SCOPE();
   display.fillScreen(WHITE);
-  display.setTextColor(BLACK);
-  display.setTextSize(2);
-  display.setCursor(30, 100);
-  display.print("Code breaker game");
-  delay(2000);
-  display.fillScreen(WHITE);
-  showBottomHints();
+  drawImageCentered(80, codeBreakerTitleImage);
 }
 // Show the difficulty selection screen for Visual Memory
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void showVisualMemoryDifficultyMenu() {
+  RENDER_SCOPE();
   display.fillScreen(WHITE);
   display.setTextColor(BLACK);
   display.setTextSize(2);
@@ -721,10 +930,16 @@ void showVisualMemoryDifficultyMenu() {
   display.print("2) Medium (8 colors)");
   display.setCursor(20, 190);
   display.print("3) Hard (10 colors)");
+  touchMap.begin(VISUAL_MEMORY_DIFFICULTY_SELECT);
+  addTouchRow(110, '1');
+  addTouchRow(150, '2');
+  addTouchRow(190, '3');
+  touchMap.end();
   showBottomHints();
 }
 
 void showInputProgress(const char *inputBuffer, byte inputIndex) {
+  RENDER_SCOPE();
   int y = 190;
   int numChars = 3;
   int charWidth = 12;
@@ -776,16 +991,15 @@ void generateRandomColorSequence(uint8_t sequence[], uint8_t length) {
   for (uint8_t i = 0; i < length; i++) {
     sequence[i] = random(0, 3);
   }
-  Serial.print("Color sequence: ");
-  for (uint8_t i = 0; i < length; i++) {
-    Serial.print(colorNames[sequence[i]]);
-    if (i < length - 1)
-      Serial.print(", ");
-  }
-  Serial.println();
+  char names[NET_LOG_LINE_LEN - 20] = "";
+  size_t used = 0;
+  for (uint8_t i = 0; i < length && used < sizeof(names); i++)
+    used += snprintf(names + used, sizeof(names) - used, i ? ", %s" : "%s", colorNames[sequence[i]]);
+  netWorker.log("Color sequence: %s\n", names);
 }
 
 void showColorOnDisplay(uint8_t colorIndex) {
+  RENDER_SCOPE();
   display.fillScreen(colorValues[colorIndex]);
   display.setTextSize(3);
   display.setTextColor(WHITE);
@@ -838,8 +1052,6 @@ void fetchPlayersFromFirestore() {
     Serial.println(error.c_str());
   }
 
-  maxToShow = min(4, (int)playerNames.size());
-
   Serial.println("Player names:");
   for (int i = 0; i < playerCount; i++) {
     Serial.println(playerNames[i]);
@@ -958,7 +1170,12 @@ void updateHighScore(const String &userDocId, const String &gameName, int newHig
   http.end();
 }
 
-void uploadLedReactionSession(const String &userDocId, int coins, int score) {
+// Firestore double field holding `us` in milliseconds
+void setMsField(JsonObject fields, const char *name, double us) {
+  fields[name]["doubleValue"] = us / 1000.0;
+}
+
+void uploadLedReactionSession(const String &userDocId, int coins, int score, const ReactionStats &times) {
   String url = "https://firestore.googleapis.com/v1/projects/";
   url += projectId;
   url += "/databases/(default)/documents/users/";
@@ -966,9 +1183,19 @@ void uploadLedReactionSession(const String &userDocId, int coins, int score) {
   url += "/games/LED_reaction_game/sessions?key=";
   url += apiKey;
 
-  DynamicJsonDocument doc(256);
+  DynamicJsonDocument doc(1024);
   doc["fields"]["coins"]["integerValue"] = coins;
   doc["fields"]["score"]["integerValue"] = score;
+  JsonObject reaction = doc["fields"]["reaction"]["mapValue"].createNestedObject("fields");
+  reaction["count"]["integerValue"] = times.count();
+  if (times.count()) {
+    setMsField(reaction, "meanMs", times.mean());
+    setMsField(reaction, "stddevMs", times.stddev());
+    setMsField(reaction, "p50Ms", times.p50());
+    setMsField(reaction, "p90Ms", times.p90());
+    setMsField(reaction, "minMs", times.min());
+    setMsField(reaction, "maxMs", times.max());
+  }
 
   String payload;
   serializeJson(doc, payload);
@@ -1020,47 +1247,201 @@ void uploadColorWordSession(const String &userDocId, int coins, int score) {
 }
 
 
-// Show player selection menu with fetched names
-void showPlayerMenu() {
-  inputIndex = 0;
-  inputBuffer[0] = inputBuffer[1] = inputBuffer[2] = inputBuffer[3] = '\0';
+// Runs on the network core
+void runSessionUpload(const SessionUpload &u) {
+  if (u.player >= playerDocIds.size())
+    return;
+  const String &userDocId = playerDocIds[u.player];
+  switch (u.game) {
+    case GAME_CODE_BREAKER:
+      uploadCodeBreakerSession(userDocId, u.coins, u.score);
+      break;
+    case GAME_VISUAL_MEMORY:
+      uploadVisualMemorySession(userDocId, u.coins, u.score);
+      break;
+    case GAME_COLOR_WORD:
+      uploadColorWordSession(userDocId, u.coins, u.score);
+      break;
+    case GAME_LED_REACTION:
+      uploadLedReactionSession(userDocId, u.coins, u.score, u.reaction);
+      break;
+  }
+  if (u.beats != NO_HIGH_SCORE && u.beats > fetchHighScore(userDocId, gameDocNames[u.game]))
+    updateHighScore(userDocId, gameDocNames[u.game], u.highScore);
+}
+
+// Hand the current player's finished game to the network core
+void postSession(GameId game, int coins, int score, int beats = NO_HIGH_SCORE, int highScore = 0,
+                 const ReactionStats *reaction = nullptr) {
+  checkpoints.clear();  // Finished: nothing to resume
+  SessionUpload upload;
+  upload.game = game;
+  upload.player = currentPlayer;
+  upload.coins = coins;
+  upload.score = score;
+  upload.beats = beats;
+  upload.highScore = highScore;
+  if (reaction)
+    upload.reaction = *reaction;
+  if (!netWorker.post(upload))
+    netWorker.log("Upload queue full; %s session dropped\n", gameDocNames[game]);
+}
 
+// --- Checkpoints ---
+// Each step of a single-player game is checkpointed, so that after a reset
+// the console can offer to carry on from it (checkpoint.h). The two-player
+// Code Breaker isn't kept.
+
+uint16_t playerHash(uint8_t player) {
+  return player < playerNames.size() ? checkpointHash(playerNames[player].c_str()) : 0;
+}
+
+// The running game as a checkpoint. False if it isn't one that is kept.
+bool checkpointOf(Checkpoint &cp) {
+  cp = {};
+  cp.player = currentPlayer;
+  cp.playerHash = playerHash(currentPlayer);
+  if (CodeBreakerGame *game = games.get<CodeBreakerGame>()) {
+    cp.game = GAME_CODE_BREAKER;
+    cp.level = game->level;
+    cp.tries = game->wrongTries;
+    cp.length = 3;
+    memcpy(cp.data, game->secret, 3);
+  } else if (VisualMemoryGame *game = games.get<VisualMemoryGame>()) {
+    cp.game = GAME_VISUAL_MEMORY;
+    cp.level = game->level;
+    cp.tries = game->wrongTries;
+    cp.length = game->length;
+    memcpy(cp.data, game->sequence, game->length);
+  } else if (ColorWordGame *game = games.get<ColorWordGame>()) {
+    cp.game = GAME_COLOR_WORD;
+    cp.level = game->level;
+    cp.step = game->step;
+    cp.tries = game->wrongTries;
+    cp.length = 2 * COLOR_WORD_CHALLENGE_LENGTH;
+    memcpy(cp.data, game->words, COLOR_WORD_CHALLENGE_LENGTH);
+    memcpy(cp.data + COLOR_WORD_CHALLENGE_LENGTH, game->inks, COLOR_WORD_CHALLENGE_LENGTH);
+  } else if (LedReactionGame *game = games.get<LedReactionGame>()) {
+    cp.game = GAME_LED_REACTION;
+    cp.level = game->level;
+    cp.step = game->correct < 255 ? game->correct : 255;
+    cp.playedMs = millis() - game->startTime;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// The running game reached a step worth coming back to
+void checkpointGame() {
+  Checkpoint cp;
+  if (checkpointOf(cp))
+    checkpoints.save(cp);
+}
+
+// False for a checkpoint this build or this roster can't carry on from
+bool resumable(const Checkpoint &cp) {
+  if (cp.game > GAME_LED_REACTION || cp.level > 2 || cp.player >= playerNames.size()
+      || cp.playerHash != playerHash(cp.player))
+    return false;
+  switch (cp.game) {
+    case GAME_CODE_BREAKER:
+      return cp.length == 3;
+    case GAME_VISUAL_MEMORY:
+      return cp.length == visualMemoryLengths[cp.level];
+    case GAME_COLOR_WORD:
+      return cp.length == 2 * COLOR_WORD_CHALLENGE_LENGTH && cp.step < COLOR_WORD_CHALLENGE_LENGTH;
+    default:
+      return cp.playedMs < ledReactionGameDuration;
+  }
+}
+
+// Start the checkpoint's game again where it was saved. Its steps' screens
+// come up as on a fresh start; Visual Memory plays its sequence again. LED
+// Reaction keeps its score and clock but not the earlier reaction times.
+void resumeGame(const Checkpoint &cp) {
+  currentPlayer = cp.player;
+  switch (cp.game) {
+    case GAME_CODE_BREAKER: {
+      CodeBreakerGame &game = games.start<CodeBreakerGame>(cp.level);
+      memcpy(game.secret, cp.data, 3);
+      game.wrongTries = cp.tries;
+      stateMachine.go(CODE_BREAKER);
+      break;
+    }
+    case GAME_VISUAL_MEMORY: {
+      VisualMemoryGame &game = games.start<VisualMemoryGame>(cp.level);
+      memcpy(game.sequence, cp.data, game.length);
+      game.wrongTries = cp.tries;
+      stateMachine.go(VISUAL_MEMORY);
+      break;
+    }
+    case GAME_COLOR_WORD: {
+      ColorWordGame &game = games.start<ColorWordGame>((Difficulty)cp.level);
+      memcpy(game.words, cp.data, COLOR_WORD_CHALLENGE_LENGTH);
+      memcpy(game.inks, cp.data + COLOR_WORD_CHALLENGE_LENGTH, COLOR_WORD_CHALLENGE_LENGTH);
+      game.step = cp.step;
+      game.wrongTries = cp.tries;
+      stateMachine.go(COLOR_WORD_CHALLENGE);
+      break;
+    }
+    case GAME_LED_REACTION: {
+      LedReactionGame &game = games.start<LedReactionGame>((LedReactionDifficulty)cp.level);
+      game.correct = cp.step;
+      game.playedMs = cp.playedMs;
+      stateMachine.go(LED_REACTION);
+      break;
+    }
+  }
+  netWorker.log("Resumed %s for %s\n", gameTitles[cp.game], playerNames[cp.player].c_str());
+}
+
+void showResumeOffer(uint8_t game, uint8_t player) {
+  RENDER_SCOPE();
+  display.fillScreen(WHITE);
+  display.setTextColor(BLACK);
+  display.setTextSize(2);
+  display.setCursor(20, 40);
+  display.print("Unfinished game:");
+  display.setTextSize(1);
+  display.setCursor(20, 70);
+  display.print(gameTitles[game]);
+  display.setCursor(20, 85);
+  display.print(playerNames[player]);
+  display.setTextSize(2);
+  display.setCursor(40, 140);
+  display.print("1. Resume");
+  display.setCursor(40, 180);
+  display.print("2. Start over");
+  touchMap.begin(RESUME_OFFER);
+  addTouchRow(140, '1');
+  addTouchRow(180, '2');
+  touchMap.end();
+}
+
+// Show player selection menu with fetched names
+void showPlayerMenu(const RosterWindow &window) {
+  RENDER_SCOPE();
   display.fillScreen(WHITE);
   display.setTextColor(BLACK);
   display.setTextSize(2);
   display.setCursor(20, 60);
   display.print("Select player:");
-  int y = 100;
-  int shown = 0;
-  for (int i = 0; i < maxToShow; i++) {
-    display.setCursor(20, y);
-    display.print(String(i + 1) + ") " + playerNames[playerDisplayOffset + i]);
-    y += 30;
-    ++shown;
-  }
-
-  // --- Add this for # logout at bottom right ---
-  const char *logoutText = "# logout";
-  int16_t x1, y1;
-  uint16_t w, h;
-  display.setTextSize(1);
-  display.setTextColor(DARKGREY);
-  display.getTextBounds(logoutText, 0, 0, &x1, &y1, &w, &h);
-  display.setCursor(SCREEN_WIDTH - w, SCREEN_HEIGHT - 10);
-  display.print(logoutText);
+  roster.draw(window);
+  showRosterHints(window);
+  addRosterTouchRows(PLAYER_SELECT);
 }
 
 // Show loading screen with a circle and "loading" text
 // This function can be called while fetching data or performing long operations
 void showLoadingScreen() {
+  RENDER_SCOPE();
   display.fillScreen(WHITE);
   // Draw a circle in the center
   int centerX = SCREEN_WIDTH / 2;
   int centerY = SCREEN_HEIGHT / 2 - 30;
-  int radius = 40;
-  display.drawCircle(centerX, centerY, radius, BLACK);
-  // Optionally, fill the circle
-  // display.fillCircle(centerX, centerY, radius, LIGHTGREY);
+  int radius = loadingRingImage.width / 2;
+  drawImage(centerX - radius, centerY - radius, loadingRingImage);
 
   // Draw "loading" text under the circle
   display.setTextColor(BLACK);
@@ -1075,38 +1456,27 @@ void showLoadingScreen() {
 
 // Show the color on the rings of NeoPixel LEDs
 void showColorOnRings(uint8_t colorIndex) {
-  // Turn off all LEDs first
-  for (uint8_t i = 0; i < WS2812_NUM_LEDS; i++) {
-    leds.setPixelColor(i, 0);
-  }
-
   uint32_t color = 0;
   if (colorIndex == 0) {  // Red
-    color = leds.Color(255, 0, 0);
+    color = ledColor(255, 0, 0);
   } else if (colorIndex == 1) {  // Blue
-    color = leds.Color(0, 0, 255);
+    color = ledColor(0, 0, 255);
   } else if (colorIndex == 2) {  // Green
-    color = leds.Color(0, 255, 0);
+    color = ledColor(0, 255, 0);
   }
 
-  // Light up the corresponding ring
-  uint8_t ringStart = colorIndex * LEDS_PER_RING;
-  for (uint8_t i = 0; i < LEDS_PER_RING; i++) {
-    leds.setPixelColor(ringStart + i, color);
-  }
-  leds.show();
+  // Light up the corresponding ring, the others off
+  leds.playOnly(LED_RING(colorIndex), LED_SOLID, color);
 }
 
 // Turn off all rings of NeoPixel LEDs
 void turnOffAllRings() {
-  for (uint8_t i = 0; i < WS2812_NUM_LEDS; i++) {
-    leds.setPixelColor(i, 0);
-  }
-  leds.show();
+  leds.off();
 }
 
 // Show the number of tries remaining for the current game
 void showTriesRemaining(int triesRemaining) {
+  RENDER_SCOPE();
   int y = 220;                                      // Just below the "Last try" line (which is at y=150)
   display.fillRect(0, y, SCREEN_WIDTH, 30, WHITE);  // Clear previous message
   display.setTextColor(DARKGREY);
@@ -1118,29 +1488,22 @@ void showTriesRemaining(int triesRemaining) {
 
 // Show stars and score centered on the display
 void showCenteredStarsAndScore(int stars) {
+  RENDER_SCOPE();
   display.fillScreen(WHITE);  // Clear everything
 
-  // Prepare stars string
-  String starsStr = "";
-  for (int i = 0; i < stars; i++) {
-    starsStr += "* ";
-  }
-
-  // Center stars
-  display.setTextSize(3);
-  display.setTextColor(GREEN);
-  int16_t x1, y1;
-  uint16_t w, h;
-  display.getTextBounds(starsStr.c_str(), 0, 0, &x1, &y1, &w, &h);
-  int starsX = (SCREEN_WIDTH - w) / 2;
+  // Center the row of stars
+  const int starPitch = starImage.width + 2;
+  int starsX = (SCREEN_WIDTH - (stars * starPitch - 2)) / 2;
   int starsY = (SCREEN_HEIGHT / 2) - 40;
-  display.setCursor(starsX, starsY);
-  display.print(starsStr);
+  for (int i = 0; i < stars; i++)
+    drawImage(starsX + i * starPitch, starsY, starImage);
 
   // Center score
   String scoreStr = "Score: " + String(stars * 2);
   display.setTextSize(2);
   display.setTextColor(BLACK);
+  int16_t x1, y1;
+  uint16_t w, h;
   display.getTextBounds(scoreStr.c_str(), 0, 0, &x1, &y1, &w, &h);
   int scoreX = (SCREEN_WIDTH - w) / 2;
   int scoreY = starsY + 50;
@@ -1150,28 +1513,15 @@ void showCenteredStarsAndScore(int stars) {
 
 // Show the title for the LED reaction game
 void showLedReactionTitle() {
+  RENDER_SCOPE();
   display.fillScreen(WHITE);
-  display.setTextColor(BLACK);
-  display.setTextSize(2);
-
-  const char *title = "Led Reaction";
-  int16_t x1, y1;
-  uint16_t w, h;
-  display.getTextBounds(title, 0, 0, &x1, &y1, &w, &h);
-  int x = (SCREEN_WIDTH - w) / 2;
-  int y = 100;  // Adjust vertically if you want
-
-  display.setCursor(x, y);
-  display.print(title);
-  delay(2000);
-
-  display.fillScreen(WHITE);
-  showBottomHints();
+  drawImageCentered(80, ledReactionTitleImage);
 }
 
 // Show the LED reaction color based on the index
+// The rings are the stimulus's (lightLedReactionRings); this is the screen
 void showLedReactionColor(int colorIdx) {
-  // Show on screen
+  RENDER_SCOPE();
   display.fillScreen(colorValues[colorIdx]);
   display.setTextSize(3);
   display.setTextColor(WHITE);
@@ -1182,9 +1532,6 @@ void showLedReactionColor(int colorIdx) {
   int y = (SCREEN_HEIGHT - 3 * 8) / 2;
   display.setCursor(x, y);
   display.print(colorNames[colorIdx]);
-
-  // Show on LED ring
-  showColorOnRings(colorIdx);
 }
 
 // Function to determine the number of stars based on coins
@@ -1203,6 +1550,7 @@ int ledReactionStars(int coins) {
 }
 
 void showEnterSecretPrompt(uint8_t player) {
+  RENDER_SCOPE();
   display.fillScreen(WHITE);
   display.setTextColor(BLACK);
   display.setTextSize(2);
@@ -1215,6 +1563,7 @@ void showEnterSecretPrompt(uint8_t player) {
 }
 
 void showMaskedInputProgress(const char *inputBuffer, byte inputIndex) {
+  RENDER_SCOPE();
   int y = 190;
   int numChars = 3;
   int charWidth = 12;
@@ -1239,6 +1588,7 @@ void showMaskedInputProgress(const char *inputBuffer, byte inputIndex) {
 
 // Show the last feedback for a player in code breaker multiplayer
 void showLastFeedback(uint8_t player, const char *lastGuess, int lastExact, int lastPartial) {
+  RENDER_SCOPE();
   display.fillScreen(WHITE);
   display.setTextSize(2);
   display.setTextColor(BLACK);
@@ -1257,18 +1607,1059 @@ void showLastFeedback(uint8_t player, const char *lastGuess, int lastExact, int
   display.print(lastPartial);
 }
 
+// Show the result of the guess a player just made in code breaker multiplayer
+void showGuessFeedback(uint8_t player, const char *guess, int exact, int partial) {
+  RENDER_SCOPE();
+  display.fillScreen(WHITE);
+  display.setTextSize(2);
+  display.setTextColor(BLACK);
+  display.setCursor(20, 60);
+  display.print("Player ");
+  display.print(player);
+  display.print(" Guess: ");
+  display.print(guess);
+  display.setCursor(20, 100);
+  display.setTextColor(GREEN);
+  display.print("Exact: ");
+  display.print(exact);
+  display.setTextColor(RED);
+  display.setCursor(20, 140);
+  display.print("Partial: ");
+  display.print(partial);
+}
+
+void showWinner(uint8_t player, uint8_t tries) {
+  RENDER_SCOPE();
+  display.fillScreen(WHITE);
+  display.setTextColor(GREEN);
+  display.setTextSize(2);
+  display.setCursor(20, 100);
+  display.print("Player ");
+  display.print(player);
+  display.print(" Wins!");
+  display.setCursor(20, 140);
+  display.setTextSize(1);
+  display.setTextColor(BLACK);
+  display.print("Tries: ");
+  display.print(tries);
+}
+
+void showRepeatSequencePrompt() {
+  RENDER_SCOPE();
+  display.fillScreen(WHITE);
+  display.setTextColor(BLACK);
+  display.setTextSize(2);
+  display.setCursor(20, 100);
+  display.print("Repeat the sequence!");
+  showBottomHints();
+}
+
+// A game-over or error message alone on the screen
+void showRedMessage(const char *msg) {
+  RENDER_SCOPE();
+  display.fillScreen(WHITE);
+  display.setTextColor(RED);
+  display.setTextSize(2);
+  display.setCursor(20, 120);
+  display.print(msg);
+}
+
+void showWrongSequence() {
+  RENDER_SCOPE();
+  display.fillScreen(WHITE);
+  display.setTextSize(2);
+  display.setTextColor(RED);
+  display.setCursor(20, 120);
+  display.print("Wrong sequence");
+  display.setCursor(20, 150);
+  display.print("try again");
+  showBottomHints();
+}
+
+void showWhite() {
+  RENDER_SCOPE();
+  display.fillScreen(WHITE);
+}
+
+void clearInputLine() {
+  RENDER_SCOPE();
+  display.fillRect(0, 190, SCREEN_WIDTH, 30, WHITE);
+}
+
+// --- Posting to the display server ---
+// Game logic draws through these; the renderers run on the display task.
+
+void postRedMessage(const char *msg) {
+  DrawArgs args;
+  args.str = msg;
+  screens.screen([](const DrawArgs &a) { showRedMessage(a.str); }, args);
+}
+
+void postInputProgress(const char *buffer, uint8_t index) {
+  screens.draw([](const DrawArgs &a) { showInputProgress(a.text, a.a); }, DrawArgs(index).copy(buffer));
+}
+
+void postMaskedInputProgress(uint8_t index) {
+  screens.draw([](const DrawArgs &a) { showMaskedInputProgress("", a.a); }, DrawArgs(index));
+}
+
+void postStarsAndScore(int stars) {
+  screens.screen([](const DrawArgs &a) { showCenteredStarsAndScore(a.a); }, DrawArgs(stars));
+}
+
+void postTriesRemaining(int tries) {
+  screens.draw([](const DrawArgs &a) { showTriesRemaining(a.a); }, DrawArgs(tries));
+}
+
+// --- Timeline steps ---
+// Timed hand-off to the next state, after a result or a title has been shown
+void stepEnter(uint8_t state) {
+  stateMachine.go(state);
+}
+
+void stepShowMultiplayerMenu(uint8_t) {
+  screens.screen(showMultiplayerMenu);
+}
+
+void stepShowHiddenNumber(uint8_t) {
+  screens.draw(showHiddenNumber);
+}
+
+// Drain queued touch samples and turn a finished gesture into a key, or 0.
+// Taps hit the current screen's TouchMap; a tap in the bottom band outside
+// the mode screen is '*' (left half) or '#' (right half), matching the
+// hints printed there; swipes scroll the player rosters.
+char touchKey() {
+  TouchSample sample;
+  Gesture gesture;
+  bool done = false;
+  while (!done && touch.read(sample)) {
+    if (touchTrace) {
+      if (sample.down)
+        Serial.printf("%lu down %u %u\n", (unsigned long)sample.tUs, sample.x, sample.y);
+      else
+        Serial.printf("%lu up\n", (unsigned long)sample.tUs);
+    }
+    done = gestures.feed(sample, gesture);
+  }
+  if (!done)
+    done = gestures.poll((uint32_t)esp_timer_get_time(), gesture);
+  if (!done)
+    return 0;
+  if (touchTrace)
+    Serial.printf("# %s %u %u\n", gestureName(gesture.type), gesture.x, gesture.y);
+
+  uint8_t state = stateMachine.state();
+  bool roster = state == PLAYER_SELECT || state == PLAYER1_SELECT || state == PLAYER2_SELECT;
+  char key = 0;
+  switch (gesture.type) {
+    case GESTURE_TAP:
+      key = touchMap.keyAt(state, gesture.x, gesture.y);
+      if (!key && state != MODE_SELECT && gesture.y >= SCREEN_HEIGHT - 30)
+        key = gesture.x < SCREEN_WIDTH / 2 ? '*' : '#';
+      break;
+    case GESTURE_SWIPE_UP:  // The list follows the finger
+      key = roster ? '9' : 0;
+      break;
+    case GESTURE_SWIPE_DOWN:
+      key = roster ? '7' : 0;
+      break;
+    default:
+      break;
+  }
+  if (key)
+    touchActionStartUs = gesture.atUs;
+  return key;
+}
+
+// InputBus sources
+bool readKeypadInput(InputEvent &event) {
+  static const InputAction actions[] = { INPUT_PRESS, INPUT_HOLD, INPUT_RELEASE };
+  KeyEvent k;
+  if (!keypadScanner.read(k))
+    return false;
+  event = InputEvent{ k.tUs, INPUT_KEYPAD, actions[k.type], k.key, 0 };
+  return true;
+}
+
+bool readButtonInput(InputEvent &event) {
+  ButtonEvent b;
+  if (!buttons.read(b))
+    return false;
+  event = InputEvent{ b.tUs, INPUT_BUTTON, b.down ? INPUT_PRESS : INPUT_RELEASE, NO_KEY, b.button };
+  return true;
+}
+
+// A gesture counts from when it finished, which is when it became a key
+bool readTouchInput(InputEvent &event) {
+  char key = touchKey();
+  if (!key)
+    return false;
+  event = InputEvent{ touchActionStartUs, INPUT_TOUCH, INPUT_PRESS, key, 0 };
+  return true;
+}
+
+// Called at the top of loop(), after the commit: `batch` holds what the
+// previous pass drew. If that pass handled a touch, its latency runs from
+// the gesture finishing to the last of that batch reaching the panel. A
+// touch that changed nothing on screen isn't counted.
+void recordTouchLatency(uint32_t batch) {
+  if (touchActionStartUs) {
+    touchShownBatch = batch;
+    touchShownStartUs = touchActionStartUs;
+    touchActionStartUs = 0;
+  }
+  uint32_t firstUs, lastUs;
+  if (!touchShownBatch || !screens.shown(touchShownBatch, firstUs, lastUs))
+    return;
+  touchShownBatch = 0;
+  if (!lastUs)
+    return;
+  uint32_t us = lastUs - touchShownStartUs;
+  touchLatencyCount++;
+  touchLatencySumUs += us;
+  if (us > touchLatencyMaxUs)
+    touchLatencyMaxUs = us;
+}
+
+// Per-button debounce windows, tuned from a bounce capture with 'B', are
+// kept in NVS as "buttons/db<i>" in microseconds; the keypad's, one for the
+// whole matrix, as "buttons/dbkeys".
+void buttonDebounceKey(char *key, uint8_t button) {
+  snprintf(key, 8, "db%u", button);
+}
+
+void loadDebounce() {
+  Preferences prefs;
+  prefs.begin("buttons", true);
+  char key[8];
+  for (uint8_t i = 0; i < 3; i++) {
+    buttonDebounceKey(key, i);
+    buttons.setDebounce(i, prefs.getUInt(key, BUTTON_DEBOUNCE_US));
+  }
+  keypadScanner.setDebounce(prefs.getUInt("dbkeys", KEYPAD_DEBOUNCE_US));
+  prefs.end();
+}
+
+void tuneButtonDebounce() {
+  bounceCapture.settle((uint32_t)esp_timer_get_time());
+  Preferences prefs;
+  prefs.begin("buttons", false);
+  char key[8];
+  for (uint8_t i = 0; i < 3; i++) {
+    uint32_t us = bounceCapture.suggest(i, buttons.debounce(i));
+    buttons.setDebounce(i, us);
+    buttonDebounceKey(key, i);
+    prefs.putUInt(key, us);
+    Serial.printf("button %u: %lu bursts, debounce %lu us\n", i, (unsigned long)bounceCapture.bursts(i),
+                  (unsigned long)us);
+  }
+  prefs.end();
+}
+
+// The display batch carrying the probed press's response
+#define PROBE_NEXT_BATCH UINT32_MAX  // Whichever the next commit returns
+uint32_t probeBatch = 0;
+
+// A game is acting on a button press made at `pressUs`; in press-to-photon
+// mode, time its response from here.
+void probePress(uint32_t pressUs) {
+  if (!latencyProbe.enabled())
+    return;
+  latencyProbe.press(pressUs, (uint32_t)esp_timer_get_time());
+  probeBatch = PROBE_NEXT_BATCH;
+}
+
+// Called at the top of loop(), after the commit: `batch` holds what the
+// previous pass drew. The response to a probed press is timed once the
+// display task has drawn that batch, and its LED frame once the LED task
+// has sent it, so either part may be picked up on a later pass.
+void finishLatencyProbe(uint32_t batch) {
+  if (!latencyProbe.pending())
+    return;
+  if (probeBatch == PROBE_NEXT_BATCH)
+    probeBatch = batch;  // 0 if the response drew nothing
+  if (!latencyProbe.rendered()) {
+    uint32_t firstUs = 0, lastUs = 0;
+    if (probeBatch && !screens.shown(probeBatch, firstUs, lastUs))
+      return;
+    latencyProbe.rendered(firstUs, lastUs);
+  }
+  uint32_t now = (uint32_t)esp_timer_get_time();
+  uint32_t handledUs = latencyProbe.handledUs();
+  uint32_t ledsDoneUs = leds.lastFrameDoneUs();
+  bool ledsOut = ledsDoneUs && (int32_t)(ledsDoneUs - handledUs) > 0 && (int32_t)(now - ledsDoneUs) >= 0;
+  if (!ledsOut && now - handledUs < LATENCY_LED_WAIT_US)
+    return;
+  const LatencySample &s = latencyProbe.complete(ledsOut ? ledsDoneUs : 0);
+  char render[48] = "", ledsPart[24] = "";
+  if (s.renderStartUs)
+    snprintf(render, sizeof(render), ", render +%lu us, tft +%lu us", (unsigned long)(s.renderStartUs - s.inputUs),
+             (unsigned long)(s.tftDoneUs - s.inputUs));
+  if (s.ledsDoneUs)
+    snprintf(ledsPart, sizeof(ledsPart), ", leds +%lu us", (unsigned long)(s.ledsDoneUs - s.inputUs));
+  netWorker.log("latency: handled +%lu us%s%s\n", (unsigned long)(s.handledUs - s.inputUs), render, ledsPart);
+}
+
+// Keypad holds and releases of '*' and '#'; both held dumps the loop profile
+void watchProfileChord(const InputEvent &event) {
+  if (event.source != INPUT_KEYPAD || (event.key != '*' && event.key != '#'))
+    return;
+  uint8_t bit = event.key == '*' ? 1 : 2;
+  if (event.action == INPUT_RELEASE) {
+    profileChordKeys &= ~bit;
+  } else if (event.action == INPUT_HOLD) {
+    profileChordKeys |= bit;
+    if (profileChordKeys == 3)
+      loopProfiler.dump(Serial, stateName);
+  }
+}
+
+// The loop is back after the stall watchdog caught it stuck: print the
+// record, and leave any game, whose timing the stall has spoiled
+void recoverFromStall() {
+  stallWatchdog.report(Serial, stateName);
+  if (stateMachine.target('*') == MENU) {
+    timeline.cancel();
+    stateMachine.go(MENU);
+  }
+}
+
+// Light sleep hook: lend the input pins to the power manager as wake
+// sources, and take them back after. With every keypad column driven low,
+// any key pulls its row low.
+void parkInputs(bool sleeping) {
+  if (sleeping) {
+    keypadScanner.pause(true);
+    buttons.sleep();
+    touch.sleep();
+  }
+  for (byte pin : colPins) {
+    pinMode(pin, sleeping ? OUTPUT : INPUT);  // Where the Keypad library leaves them after a scan
+    if (sleeping)
+      digitalWrite(pin, LOW);
+  }
+  if (!sleeping) {
+    touch.wake();
+    buttons.wake();
+    keypadScanner.pause(false);
+  }
+}
+
+// Single-character diagnostic commands typed into the serial monitor
+void handleSerialCommand() {
+  if (!Serial.available())
+    return;
+  switch (Serial.read()) {
+    case 'r':  // Render stats per screen and state, from the display task that keeps them
+      screens.call([] { renderStats.dump(Serial, stateName); });
+      break;
+    case 'R':
+      screens.call([] {
+        renderStats.reset();
+        Serial.println("Render stats cleared");
+      });
+      break;
+    case 't':  // Touch latency, gesture finished to screen updated
+      Serial.printf("touch: %lu actions, mean %lu us, max %lu us, %lu samples dropped\n",
+                    (unsigned long)touchLatencyCount,
+                    (unsigned long)(touchLatencyCount ? touchLatencySumUs / touchLatencyCount : 0),
+                    (unsigned long)touchLatencyMaxUs, (unsigned long)touch.dropped());
+      break;
+    case 'l':  // LED frames sent versus ring writes
+      Serial.printf("leds: %lu writes, %lu shows (%lu for writes), %lu saved, %lu dropped\n",
+                    (unsigned long)leds.stats().writes, (unsigned long)leds.stats().shows,
+                    (unsigned long)leds.stats().writeShows, (unsigned long)leds.stats().saved(),
+                    (unsigned long)leds.dropped());
+      Serial.printf("leds: %u mA requested, %u mA sent, peak %u mA, %lu frames limited to %d mA\n",
+                    leds.power().requestedMa, leds.power().sentMa, leds.power().peakMa,
+                    (unsigned long)leds.power().limitedFrames, LED_BUDGET_MA);
+      break;
+    case 'k':  // Input events per source and the source queues
+      for (uint8_t i = 0; i < INPUT_SOURCE_COUNT; i++)
+        Serial.printf("%s: %lu events\n", inputSourceName((InputSource)i),
+                      (unsigned long)inputBus.events((InputSource)i));
+      Serial.printf("keypad: queue peak %lu of %d, %lu events lost\n", (unsigned long)keypadScanner.peak(),
+                    KEYPAD_QUEUE_LEN, (unsigned long)keypadScanner.overflows());
+      Serial.printf("buttons: %lu bounce edges, %lu edges lost\n", (unsigned long)buttons.bounces(),
+                    (unsigned long)buttons.overflows());
+      break;
+    case 'P':  // Press-to-photon mode: time every game response to a button
+      latencyProbe.setEnabled(!latencyProbe.enabled());
+      Serial.println(latencyProbe.enabled() ? "Latency probe on" : "Latency probe off");
+      break;
+    case 'p':
+      latencyProbe.dump(Serial);
+      break;
+    case 'b':  // Bounce capture: start, or stop and print the histograms
+      if (bounceCapturing) {
+        buttons.setCapture(nullptr);
+        bounceCapture.settle((uint32_t)esp_timer_get_time());
+        bounceCapture.dump(Serial, 3);
+      } else {
+        bounceCapture.reset();
+        buttons.setCapture(&bounceCapture);
+        Serial.println("Bounce capture on; press each button a few dozen times, then 'b' again");
+      }
+      bounceCapturing = !bounceCapturing;
+      break;
+    case 'B':  // Debounce windows from the capture, saved to NVS
+      tuneButtonDebounce();
+      break;
+    case 'g':  // Game arena: its size against the games it holds
+      games.dump(Serial);
+      break;
+    case 'C':  // Checkpoint cost per step and NVS writes
+      checkpoints.dump(Serial);
+      break;
+    case 'c':  // Script frames and resumes
+      scripts.dump(Serial);
+      break;
+    case 'd':  // Display server queue and coalescing
+      screens.dump(Serial);
+      break;
+    case 'L':  // Loop iteration histograms and the longest stalls
+      loopProfiler.dump(Serial, stateName);
+      break;
+    case 'w':  // CPU clock, light sleeps and wake latency
+      power.dump(Serial);
+      break;
+    case 'n':  // Core utilisation and the network core's queues
+      netWorker.dump(Serial);
+      break;
+    case 's':  // Stimulus onset/offset log and timer jitter
+      stimuli.dump(Serial);
+      break;
+    case 'T':  // Print touch samples as a replayable trace
+      touchTrace = !touchTrace;
+      Serial.println(touchTrace ? "Touch trace on" : "Touch trace off");
+      break;
+  }
+}
+
+// --- States ---
+// Each state's handlers, wired up in gameStates below. '*' and '#' never
+// reach onEvent where the table gives them a target.
+
+void enterModeSelect() {
+  games.end();
+  checkpoints.clear();
+  screens.screen(showModeSelect);
+}
+
+void modeSelectEvent(const InputEvent &event) {
+  if (event.key == '1')
+    stateMachine.go(PLAYER_SELECT);
+  else if (event.key == '2')
+    stateMachine.go(PLAYER1_SELECT);
+}
+
+// '7'/'9' scroll the roster; a row key picks the player on that row.
+// Returns the player's index, or -1.
+int rosterPick(const InputEvent &event) {
+  if (event.key == '9' || event.key == '7') {
+    // Redraws only the rows that changed
+    if (rosterWindow.scroll(event.key == '9' ? 1 : -1))
+      screens.draw([](const DrawArgs &a) { roster.show(rosterWindowOf(a)); }, rosterArgs(rosterWindow));
+    return -1;
+  }
+  if (event.key >= '1' && event.key <= '0' + ROSTER_ROWS)
+    return rosterWindow.itemAtRow(event.key - '1');
+  return -1;
+}
+
+void enterPlayerSelect() {
+  rosterWindow.begin(playerNames.size());
+  screens.screen([](const DrawArgs &a) { showPlayerMenu(rosterWindowOf(a)); }, rosterArgs(rosterWindow));
+}
+
+void playerSelectEvent(const InputEvent &event) {
+  int index = rosterPick(event);
+  if (index >= 0) {
+    currentPlayer = index;
+    screens.screen([](const DrawArgs &a) { showPlayerSelected(a.a); }, DrawArgs(currentPlayer));
+    timeline.after(1200, stepEnter, MENU);
+  }
+}
+
+void enterPlayer1Select() {
+  rosterWindow.begin(playerNames.size());
+  screens.screen([](const DrawArgs &a) { showMultiplayerPlayerSelect1(rosterWindowOf(a)); }, rosterArgs(rosterWindow));
+}
+
+void player1SelectEvent(const InputEvent &event) {
+  int index = rosterPick(event);
+  if (index >= 0) {
+    multiplayerPlayer1 = index;  // 0-based
+    stateMachine.go(PLAYER2_SELECT);
+  }
+}
+
+void enterPlayer2Select() {
+  rosterWindow.begin(playerNames.size(), multiplayerPlayer1);  // Player 1 is left out
+  screens.screen([](const DrawArgs &a) { showMultiplayerPlayerSelect2(rosterWindowOf(a)); }, rosterArgs(rosterWindow));
+}
+
+void player2SelectEvent(const InputEvent &event) {
+  int index = rosterPick(event);  // The roster already skips player 1
+  if (index >= 0) {
+    multiplayerPlayer2 = index;
+    stateMachine.go(MULTI_MENU);
+  }
+}
+
+void enterMultiMenu() {
+  games.end();  // A multiplayer game left with '*' is over
+  screens.screen(showMultiplayerMenu);
+}
+
+void multiMenuEvent(const InputEvent &event) {
+  if (event.key == '1') {
+    stateMachine.go(CODE_BREAKER_MULTI_SECRET1);
+  } else if (event.key) {
+    postRedMessage("Not implemented");
+    timeline.after(1200, stepShowMultiplayerMenu);  // Then redraw the menu
+  }
+}
+
+// --- Script states ---
+// States whose flow is a Script (script_runner.h) hand it their input and
+// ticks, and end it when they are left.
+
+void scriptEvent(const InputEvent &event) {
+  scripts.feed(event);
+}
+
+void scriptTick() {
+  scripts.tick(millis());
+}
+
+void scriptExit() {
+  scripts.cancel();
+}
+
+// --- Code Breaker multiplayer ---
+// Both players enter a secret, then take turns guessing the other's. Each
+// secret and each turn is a script; the turns alternate between the two
+// TURN states.
+
+Script codeBreakerSecretScript(uint8_t player, char *secret, State next) {
+  screens.screen([](const DrawArgs &a) { showEnterSecretPrompt(a.a); }, DrawArgs(player));
+  postMaskedInputProgress(0);
+  for (uint8_t i = 0; i < 3;) {
+    char key = (co_await scripts.key()).key;
+    if (key < '0' || key > '9')
+      continue;
+    secret[i++] = key;
+    secret[i] = '\0';
+    postMaskedInputProgress(i);  // Update input line only
+  }
+  co_await scripts.sleep(500);
+  screens.draw(clearInputLine);
+  co_await scripts.sleep(300);
+  stateMachine.go(next);
+}
+
+void enterCodeBreakerSecret1() {
+  MultiCodeBreakerGame &game = games.start<MultiCodeBreakerGame>();
+  scripts.start("codeBreakerSecret", codeBreakerSecretScript(1, game.players[0].secret, CODE_BREAKER_MULTI_SECRET2));
+}
+
+void enterCodeBreakerSecret2() {
+  MultiCodeBreakerGame &game = games.as<MultiCodeBreakerGame>();
+  scripts.start("codeBreakerSecret", codeBreakerSecretScript(2, game.players[1].secret, CODE_BREAKER_MULTI_TURN_P1));
+}
+
+void postLastFeedback(uint8_t player, const char *guess, int exact, int partial) {
+  screens.screen([](const DrawArgs &a) { showLastFeedback(a.a, a.text, a.b, a.c); },
+                 DrawArgs(player, exact, partial).copy(guess));
+}
+
+// One guess: the player's last feedback if they have guessed before, three
+// digits, the result, then the other player's turn or the winner
+Script codeBreakerTurnScript(uint8_t player) {
+  MultiCodeBreakerGame &game = games.as<MultiCodeBreakerGame>();
+  MultiCodeBreakerGame::Player &me = game.players[player - 1];
+  const MultiCodeBreakerGame::Player &other = game.players[2 - player];
+  memset(me.guess, 0, sizeof(me.guess));
+
+  if (me.tries > 0) {
+    postLastFeedback(player, me.lastGuess, me.lastExact, me.lastPartial);
+    co_await scripts.sleep(2000);
+  }
+  screens.screen(
+    [](const DrawArgs &a) {
+      showGuessScreen(a.a, a.b);
+      showInputProgress("", 0);
+    },
+    DrawArgs(player, me.tries));
+
+  for (uint8_t i = 0; i < 3;) {
+    char key = (co_await scripts.key()).key;
+    if (key < '0' || key > '9')
+      continue;
+    me.guess[i++] = key;
+    postInputProgress(me.guess, i);
+  }
+  int exact = 0, partial = 0;
+  cbMultiCountMatches(me.guess, other.secret, exact, partial);
+
+  // Kept for the player's next turn
+  me.tries++;
+  strcpy(me.lastGuess, me.guess);
+  me.lastExact = exact;
+  me.lastPartial = partial;
+  screens.screen([](const DrawArgs &a) { showGuessFeedback(a.a, a.text, a.b, a.c); },
+                 DrawArgs(player, exact, partial).copy(me.guess));
+  co_await scripts.sleep(1500);
+
+  if (exact == 3) {
+    screens.screen([](const DrawArgs &a) { showWinner(a.a, a.b); }, DrawArgs(player, me.tries));
+    co_await scripts.sleep(2500);
+    stateMachine.go(MENU);
+  } else {
+    stateMachine.go(player == 1 ? CODE_BREAKER_MULTI_TURN_P2 : CODE_BREAKER_MULTI_TURN_P1);
+  }
+}
+
+void enterCodeBreakerTurnP1() {
+  scripts.start("codeBreakerTurn", codeBreakerTurnScript(1));
+}
+
+void enterCodeBreakerTurnP2() {
+  scripts.start("codeBreakerTurn", codeBreakerTurnScript(2));
+}
+
+// --- Games menu ---
+
+void enterMenu() {
+  games.end();  // Whatever game was running is over
+  checkpoints.clear();
+  screens.screen(showMenu);
+}
+
+void menuEvent(const InputEvent &event) {
+  if (!event.key)
+    return;
+  netWorker.log("Key pressed: %c\n", event.key);
+  switch (event.key) {
+    case '1':
+      stateMachine.go(CODE_BREAKER_DIFFICULTY_SELECT);
+      break;
+    case '2':
+      stateMachine.go(VISUAL_MEMORY_DIFFICULTY_SELECT);
+      break;
+    case '3':
+      stateMachine.go(COLOR_WORD_DIFFICULTY_SELECT);
+      break;
+    case '4':
+      stateMachine.go(LED_REACTION_DIFFICULTY_SELECT);
+      break;
+    default:
+      screens.draw([] { showMenuMessage("Please choose 1, 2, 3 or 4"); });
+      break;
+  }
+}
+
+// Difficulty screens: '1' easy, '2' medium, '3' hard; -1 for anything else
+int difficultyKey(const InputEvent &event) {
+  return event.key >= '1' && event.key <= '3' ? event.key - '1' : -1;
+}
+
+// --- Code Breaker ---
+
+void enterCodeBreakerDifficultySelect() {
+  screens.screen(showCodeBreakerDifficultyMenu);
+}
+
+void codeBreakerDifficultyEvent(const InputEvent &event) {
+  int level = difficultyKey(event);
+  if (level >= 0) {
+    games.start<CodeBreakerGame>(level);
+    newCodeBreakerNumber();
+    checkpointGame();
+    stateMachine.go(CODE_BREAKER);
+  }
+}
+
+void enterCodeBreaker() {
+  screens.screen(showCodeBreakerTitle);
+  timeline.after(2000, stepClearToBottomHints);
+  timeline.after(0, stepShowHiddenNumber);
+}
+
+void codeBreakerEvent(const InputEvent &event) {
+  CodeBreakerGame &game = games.as<CodeBreakerGame>();
+  if (game.inputIndex < 3 && event.key >= '0' && event.key <= '9') {
+    game.input[game.inputIndex++] = event.key;
+    postInputProgress(game.input, game.inputIndex);
+  }
+  if (game.inputIndex < 3)
+    return;
+
+  game.input[3] = '\0';
+  if (strcmp(game.input, game.secret) == 0) {
+    int stars = game.maxWrongTries - game.wrongTries;
+    postStarsAndScore(stars);  // Show only stars and score, centered
+    timeline.after(2000, stepEnter, MENU);  // Back to the games menu after 2 seconds
+    postSession(GAME_CODE_BREAKER, stars, stars * 2, stars * 20, stars);
+    return;
+  }
+
+  int exact = 0, partial = 0;
+  countMatches(game.input, game.secret, exact, partial);
+  screens.draw([](const DrawArgs &a) { showCodeBreakerResult(a.a, a.b); }, DrawArgs(exact, partial));
+  screens.draw([](const DrawArgs &a) { showLastTry(a.text); }, DrawArgs().copy(game.input));
+  postTriesRemaining(game.maxWrongTries - game.wrongTries - 1);
+  game.wrongTries++;  // Increment on wrong try
+
+  if (game.wrongTries >= game.maxWrongTries) {
+    postRedMessage("Out of tries!");
+    timeline.after(2000, stepEnter, MENU);
+    postSession(GAME_CODE_BREAKER, 0, 0);
+    return;
+  }
+
+  netWorker.log("Input: %s | Random: %s | Exact: %d | Partial: %d\n", game.input, game.secret, exact, partial);
+  checkpointGame();
+  game.inputIndex = 0;
+  postInputProgress(game.input, game.inputIndex);
+}
+
+// --- Visual Memory ---
+
+void enterVisualMemoryDifficultySelect() {
+  screens.screen(showVisualMemoryDifficultyMenu);
+}
+
+void visualMemoryDifficultyEvent(const InputEvent &event) {
+  int level = difficultyKey(event);
+  if (level >= 0) {
+    VisualMemoryGame &game = games.start<VisualMemoryGame>(level);
+    generateRandomColorSequence(game.sequence, game.length);
+    checkpointGame();
+    stateMachine.go(VISUAL_MEMORY);
+  }
+}
+
+// The sequence plays 2 s per color with a 1 s white gap; '*' and '#' can
+// cut it short. It then moves on to VISUAL_MEMORY_INPUT.
+Script visualMemoryPlayback() {
+  VisualMemoryGame &game = games.as<VisualMemoryGame>();
+  for (uint8_t i = 0; i < game.length; i++) {
+    if (i)
+      co_await scripts.sleep(1000);
+    screens.screen([](const DrawArgs &a) { showColorOnDisplay(a.a); }, DrawArgs(game.sequence[i]));
+    showColorOnRings(game.sequence[i]);
+    co_await scripts.sleep(2000);
+    turnOffAllRings();
+    if (i < game.length - 1)
+      screens.screen(showWhite);
+  }
+  stateMachine.go(VISUAL_MEMORY_INPUT);
+}
+
+void enterVisualMemory() {
+  scripts.start("visualMemoryPlayback", visualMemoryPlayback());
+}
+
+void exitVisualMemory() {
+  scripts.cancel();
+  turnOffAllRings();
+}
+
+// The player repeats the sequence on the buttons; a mistake starts the
+// repeat over until the tries run out
+Script visualMemoryInput() {
+  static const char *buttonNames[3] = { "Red button pressed", "Blue button pressed", "Green button pressed" };
+  VisualMemoryGame &game = games.as<VisualMemoryGame>();
+  screens.screen(showRepeatSequencePrompt);
+  for (;;) {
+    inputBus.flush();  // Presses made while the sequence or a message showed don't count
+    uint8_t step = 0;
+    while (step < game.length) {
+      InputEvent press = co_await scripts.button();
+      netWorker.log("%s\n", buttonNames[press.button]);
+      if (press.button != game.sequence[step])
+        break;
+      step++;
+    }
+    if (step == game.length) {
+      int stars = 10 - game.wrongTries;
+      postStarsAndScore(stars);
+      postSession(GAME_VISUAL_MEMORY, stars, stars * 2, stars * 20, stars);
+      break;
+    }
+
+    game.wrongTries++;  // Increment on wrong try
+    if (game.wrongTries >= maxWrongTries_VM) {
+      postRedMessage("Out of tries!");
+      postSession(GAME_VISUAL_MEMORY, 0, 0);
+      break;
+    }
+    netWorker.log("Wrong sequence try again\n");
+    checkpointGame();
+    screens.screen(showWrongSequence);
+    co_await scripts.sleep(1500);
+    screens.screen(showRepeatSequencePrompt);
+    postTriesRemaining(maxWrongTries_VM - game.wrongTries);
+  }
+  co_await scripts.sleep(2000);  // Back to the games menu after 2 seconds
+  stateMachine.go(MENU);
+}
+
+void enterVisualMemoryInput() {
+  scripts.start("visualMemoryInput", visualMemoryInput());
+}
+
+// --- Color-Word Challenge ---
+
+void enterColorWordDifficultySelect() {
+  screens.screen(showColorWordDifficultySelect);
+}
+
+void colorWordDifficultyEvent(const InputEvent &event) {
+  int level = difficultyKey(event);
+  if (level >= 0) {
+    ColorWordGame &game = games.start<ColorWordGame>((Difficulty)level);
+    generateColorWordChallengeSequences(game.words, game.inks, COLOR_WORD_CHALLENGE_LENGTH);
+    checkpointGame();
+    stateMachine.go(COLOR_WORD_CHALLENGE);
+  }
+}
+
+// The word's time limit and ring countdown start as it is posted, so they
+// run whether or not its frame is drawn. Presses only count once it has
+// reached the panel.
+void postColorWordStep(ColorWordGame &game) {
+  uint8_t i = game.step;
+  game.stepScreen = screens.screen([](const DrawArgs &a) { showColorWordChallengeStep(a.a, a.b); },
+                                   DrawArgs(game.words[i], game.inks[i]));
+  leds.play(leds.ALL, LED_COUNTDOWN, ledColor(96, 96, 96), game.stepDuration);  // Empties as the time runs out
+  game.stepPostedUs = (uint32_t)esp_timer_get_time();
+  stimuli.schedule(i, game.stepPostedUs, game.stepDuration * 1000UL, nullptr, nullptr);
+}
+
+void enterColorWordChallenge() {
+  postColorWordStep(games.as<ColorWordGame>());
+}
+
+// After each answer or timeout: the next word, or the score after the last
+void advanceColorWord(ColorWordGame &game) {
+  game.step++;
+  if (game.step < COLOR_WORD_CHALLENGE_LENGTH) {
+    checkpointGame();
+    postColorWordStep(game);
+    return;
+  }
+  int stars = colorWordMaxTries - game.wrongTries;
+  turnOffAllRings();
+  postStarsAndScore(stars);
+  timeline.after(2000, stepEnter, MENU);
+  postSession(GAME_COLOR_WORD, stars, stars * 2, stars * 20, stars);
+}
+
+// Button presses are judged by when they happened rather than by when this
+// pass got to them. Ones made before the word reached the panel or after
+// its time ran out don't count.
+void colorWordChallengeEvent(const InputEvent &event) {
+  ColorWordGame &game = games.as<ColorWordGame>();
+  if (event.source != INPUT_BUTTON)
+    return;
+  uint32_t shownUs = screens.shownUs(game.stepScreen);
+  if (!shownUs || (int32_t)(event.tUs - shownUs) < 0 || event.tUs - game.stepPostedUs >= game.stepDuration * 1000UL)
+    return;
+  probePress(event.tUs);
+  stimuli.end();
+  if (event.button != game.words[game.step])
+    game.wrongTries++;  // Wrong: count it and move on, no retry
+  advanceColorWord(game);
+}
+
+// The word's time ran out: count it as wrong and move on
+void colorWordChallengeTick() {
+  StimulusEdge edge;
+  if (stimuli.read(edge) && !edge.on) {
+    ColorWordGame &game = games.as<ColorWordGame>();
+    game.wrongTries++;
+    advanceColorWord(game);
+  }
+}
+
+void exitColorWordChallenge() {
+  stimuli.end();
+  turnOffAllRings();
+}
+
+// --- LED Reaction ---
+
+void enterLedReactionDifficultySelect() {
+  screens.screen(showLedReactionDifficultySelect);
+}
+
+void ledReactionDifficultyEvent(const InputEvent &event) {
+  int level = difficultyKey(event);
+  if (level >= 0) {
+    games.start<LedReactionGame>((LedReactionDifficulty)level);
+    stateMachine.go(LED_REACTION);
+  }
+}
+
+void enterLedReaction() {
+  LedReactionGame &game = games.as<LedReactionGame>();
+  game.startTime = millis() - game.playedMs;
+  game.active = true;
+  checkpointGame();
+  scheduleLedReactionColor((uint32_t)esp_timer_get_time());
+}
+
+// A press is timed from the colour's actual onset. Presses before the
+// colour came up, or too late to count, are ignored.
+void ledReactionEvent(const InputEvent &event) {
+  LedReactionGame &game = games.as<LedReactionGame>();
+  uint32_t reactionUs = event.tUs - stimuli.onsetUs();
+  if (!game.active || event.source != INPUT_BUTTON || !stimuli.shown() || (int32_t)reactionUs < 0
+      || reactionUs >= game.stepDuration * 1000UL)
+    return;
+  probePress(event.tUs);
+  stimuli.end();  // Rings off now
+  if (event.button == game.currentColor) {
+    game.correct++;  // Correct button
+  }
+  game.times.add(reactionUs);
+  netWorker.log("Reaction %lu us, %s\n", (unsigned long)reactionUs,
+                event.button == game.currentColor ? "correct" : "wrong");
+  checkpointGame();
+  // White screen before the next color
+  screens.screen(showWhite);
+  scheduleLedReactionColor((uint32_t)esp_timer_get_time() + ledReactionDelayDuration * 1000UL);
+}
+
+void ledReactionTick() {
+  LedReactionGame &game = games.as<LedReactionGame>();
+  if (!game.active)
+    return;
+
+  // The rings switched on or timed out on their own; the screen follows
+  StimulusEdge edge;
+  while (stimuli.read(edge)) {
+    if (edge.on) {
+      screens.screen([](const DrawArgs &a) { showLedReactionStimulus(a.a); }, DrawArgs(game.currentColor));
+    } else {
+      screens.screen(showWhite);
+      scheduleLedReactionColor(edge.tUs + ledReactionDelayDuration * 1000UL);
+    }
+  }
+
+  // End the game after 20 seconds
+  if (millis() - game.startTime < ledReactionGameDuration)
+    return;
+  game.active = false;
+  stimuli.end();
+  turnOffAllRings();
+  screens.screen([](const DrawArgs &a) { showLedReactionScore(a.a); }, DrawArgs(game.correct));
+  timeline.after(2000, stepEnter, MENU);
+  netWorker.log("Reactions: %lu, mean %.1f ms, sd %.1f ms, p50 %.1f ms, p90 %.1f ms\n",
+                (unsigned long)game.times.count(), game.times.mean() / 1000, game.times.stddev() / 1000,
+                game.times.p50() / 1000, game.times.p90() / 1000);
+  postSession(GAME_LED_REACTION, game.correct, game.correct * 2, game.correct * 2, game.correct * 2, &game.times);
+}
+
+void exitLedReaction() {
+  if (LedReactionGame *game = games.get<LedReactionGame>())
+    game->active = false;
+  stimuli.end();
+  turnOffAllRings();
+}
+
+// --- Resume ---
+
+void enterResumeOffer() {
+  screens.screen([](const DrawArgs &a) { showResumeOffer(a.a, a.b); }, DrawArgs(resumeOffer.game, resumeOffer.player));
+}
+
+// Starting over goes through MODE_SELECT, which forgets the checkpoint
+void resumeOfferEvent(const InputEvent &event) {
+  if (event.key == '1')
+    resumeGame(resumeOffer);
+  else if (event.key == '2')
+    stateMachine.go(MODE_SELECT);
+}
+
+// One row per State, in enum order. '*' goes back to the games menu (the
+// multiplayer one from a multiplayer game) and '#' logs out wherever the
+// screen offers them; a timed sequence in progress is cut short first. The
+// menus, which only wait for a press, are marked idle for the power
+// manager. Adding a game means adding its states here.
+#define TO_MENU MENU, MODE_SELECT
+#define TO_MULTI_MENU MULTI_MENU, MODE_SELECT
+#define NO_BACK STATE_NONE, MODE_SELECT
+constexpr StateDef gameStates[] = {
+  { MODE_SELECT, "MODE_SELECT", enterModeSelect, modeSelectEvent, nullptr, nullptr, STATE_NONE, STATE_NONE, true },
+  { PLAYER1_SELECT, "PLAYER1_SELECT", enterPlayer1Select, player1SelectEvent, nullptr, nullptr, NO_BACK, true },
+  { PLAYER2_SELECT, "PLAYER2_SELECT", enterPlayer2Select, player2SelectEvent, nullptr, nullptr, NO_BACK, true },
+  { PLAYER_SELECT, "PLAYER_SELECT", enterPlayerSelect, playerSelectEvent, nullptr, nullptr, NO_BACK, true },
+  { MULTI_MENU, "MULTI_MENU", enterMultiMenu, multiMenuEvent, nullptr, nullptr, NO_BACK, true },
+  { CODE_BREAKER_MULTI_SECRET1, "CODE_BREAKER_MULTI_SECRET1", enterCodeBreakerSecret1, scriptEvent, scriptTick,
+    scriptExit, TO_MULTI_MENU },
+  { CODE_BREAKER_MULTI_SECRET2, "CODE_BREAKER_MULTI_SECRET2", enterCodeBreakerSecret2, scriptEvent, scriptTick,
+    scriptExit, TO_MULTI_MENU },
+  { CODE_BREAKER_MULTI_TURN_P1, "CODE_BREAKER_MULTI_TURN_P1", enterCodeBreakerTurnP1, scriptEvent, scriptTick,
+    scriptExit, TO_MULTI_MENU },
+  { CODE_BREAKER_MULTI_TURN_P2, "CODE_BREAKER_MULTI_TURN_P2", enterCodeBreakerTurnP2, scriptEvent, scriptTick,
+    scriptExit, TO_MULTI_MENU },
+  { MENU, "MENU", enterMenu, menuEvent, nullptr, nullptr, NO_BACK, true },
+  { CODE_BREAKER, "CODE_BREAKER", enterCodeBreaker, codeBreakerEvent, nullptr, nullptr, TO_MENU },
+  { COLOR_WORD_DIFFICULTY_SELECT, "COLOR_WORD_DIFFICULTY_SELECT", enterColorWordDifficultySelect,
+    colorWordDifficultyEvent, nullptr, nullptr, TO_MENU, true },
+  { COLOR_WORD_CHALLENGE, "COLOR_WORD_CHALLENGE", enterColorWordChallenge, colorWordChallengeEvent,
+    colorWordChallengeTick, exitColorWordChallenge, TO_MENU },
+  { CODE_BREAKER_DIFFICULTY_SELECT, "CODE_BREAKER_DIFFICULTY_SELECT", enterCodeBreakerDifficultySelect,
+    codeBreakerDifficultyEvent, nullptr, nullptr, TO_MENU, true },
+  { VISUAL_MEMORY_DIFFICULTY_SELECT, "VISUAL_MEMORY_DIFFICULTY_SELECT", enterVisualMemoryDifficultySelect,
+    visualMemoryDifficultyEvent, nullptr, nullptr, TO_MENU, true },
+  { VISUAL_MEMORY, "VISUAL_MEMORY", enterVisualMemory, nullptr, scriptTick, exitVisualMemory, TO_MENU },
+  { VISUAL_MEMORY_INPUT, "VISUAL_MEMORY_INPUT", enterVisualMemoryInput, scriptEvent, scriptTick, scriptExit,
+    TO_MENU },
+  { LED_REACTION_DIFFICULTY_SELECT, "LED_REACTION_DIFFICULTY_SELECT", enterLedReactionDifficultySelect,
+    ledReactionDifficultyEvent, nullptr, nullptr, TO_MENU, true },
+  { LED_REACTION, "LED_REACTION", enterLedReaction, ledReactionEvent, ledReactionTick, exitLedReaction, TO_MENU },
+  { RESUME_OFFER, "RESUME_OFFER", enterResumeOffer, resumeOfferEvent, nullptr, nullptr, NO_BACK, true },
+};
+#undef TO_MENU
+#undef TO_MULTI_MENU
+#undef NO_BACK
+static_assert(sizeof(gameStates) / sizeof(gameStates[0]) == STATE_COUNT, "gameStates needs one row per State");
+static_assert(stateTableValid(gameStates), "gameStates rows must be in State order");
+
+StateMachine stateMachine(gameStates, STATE_COUNT, PLAYER_SELECT);
+
 void setup() {
   // Initialize NeoPixel LEDs
-  leds.begin();
-  leds.show();  // Initialize all LEDs to 'off'
+  leds.setBrightness(LED_BRIGHTNESS);
+  leds.setCurrentBudget(LED_BUDGET_MA);
+  leds.begin();  // All off
 
   Serial.begin(9600);
+  stallWatchdog.report(Serial, stateName);  // From before the last restart
   display.begin();
   display.setRotation(0);
+  screens.begin();
+  if (!touch.begin(TOUCH_SDA, TOUCH_SCL, TOUCH_INT, SCREEN_WIDTH, SCREEN_HEIGHT))
+    Serial.println("Touch controller not found; keypad only");
+  loadDebounce();
+  keypadScanner.begin();  // Keys pressed while Wi-Fi connects are kept for the first screen
+  inputBus.addSource(readKeypadInput);
+  inputBus.addSource(readButtonInput);
+  inputBus.addSource(readTouchInput);
   randomSeed(analogRead(0));
 
-  // Show loading screen while connecting to Wi-Fi
-  showLoadingScreen();
+  // Show loading screen while connecting to Wi-Fi. The spinner keeps
+  // turning while setup() blocks on Wi-Fi and Firestore.
+  screens.screen(showLoadingScreen);
+  screens.commit();
+  leds.play(leds.ALL, LED_SPINNER, ledColor(0, 0, 96), LED_SPINNER_MS);
+  leds.commit();
 
   // Connect to Wi-Fi
   WiFi.disconnect(true);
@@ -1306,1016 +2697,75 @@ void setup() {
 
   // showLoadingScreen();
   fetchPlayersFromFirestore();
-  showModeSelect();
-
-  currentState = MODE_SELECT;
-
-  pinMode(RED_BUTTON_PIN, INPUT_PULLUP);
-  pinMode(BLUE_BUTTON_PIN, INPUT_PULLUP);
-  pinMode(GREEN_BUTTON_PIN, INPUT_PULLUP);
+  turnOffAllRings();
+  // A game the last run didn't finish, for a player still on the roster
+  checkpoints.begin(checkpointRecord);
+  bool resume = checkpoints.load(resumeOffer) && resumable(resumeOffer);
+  stateMachine.go(resume ? RESUME_OFFER : MODE_SELECT);
+
+  buttons.begin(buttonPins, 3);
+  stimuli.begin();
+  netWorker.begin(runSessionUpload);
+  stallWatchdog.begin(stallRecord);
+
+  int8_t wakePins[ROWS + 3 + 1];
+  uint8_t wakePinCount = 0;
+  for (byte pin : rowPins)
+    wakePins[wakePinCount++] = pin;
+  for (uint8_t pin : buttonPins)
+    wakePins[wakePinCount++] = pin;
+  wakePins[wakePinCount++] = touch.wakePin();
+  power.begin(wakePins, wakePinCount, parkInputs);
 }
 
 void loop() {
-  char key = keypad.getKey();
-  switch (currentState) {
-    case MODE_SELECT:
-      {
-        if (key == '1') {
-          showPlayerMenu();
-          currentState = PLAYER_SELECT;
-          delay(150);
-          while (keypad.getKey() != NO_KEY) {
-          }
-        } else if (key == '2') {
-          showMultiplayerPlayerSelect1();
-          currentState = PLAYER1_SELECT;
-          delay(150);
-          while (keypad.getKey() != NO_KEY) {
-          }
-        }
-        break;
-      }
-
-    case PLAYER1_SELECT:
-      {
-        if (key == '9') {
-          if (playerDisplayOffset + 4 < playerNames.size()) {
-            playerDisplayOffset += 4;
-            showMultiplayerPlayerSelect1();
-          }
-          break;
-        }
-        if (key == '#') {
-          playerDisplayOffset = 0;  // <-- Reset the offset!
-          showModeSelect();
-          currentState = MODE_SELECT;
-          return;
-        }
-
-        if (key && key >= '1' && key <= '0' + maxToShow) {
-          int selection = key - '1';  // 0-based index for button pressed (0,1,2,3)
-          int actualIndex = playerDisplayOffset + selection;
-          if (actualIndex < playerNames.size()) {
-            multiplayerPlayer1 = actualIndex;                  // 0-based index for player
-            playerDisplayOffset = 0;                           // Reset for next selection
-            showMultiplayerPlayerSelect2(multiplayerPlayer1);  // Pass 0-based index to exclude
-            currentState = PLAYER2_SELECT;
-            delay(150);
-            while (keypad.getKey() != NO_KEY) {
-            }
-          }
-        }
-        break;
-      }
-
-    case PLAYER2_SELECT:
-      {
-        if (key == '9') {
-          if (playerDisplayOffset + 4 < playerNames.size()) {
-            playerDisplayOffset += 4;
-            showMultiplayerPlayerSelect2(multiplayerPlayer1);
-          }
-          break;
-        }
-        if (key == '#') {
-          playerDisplayOffset = 0;  // <-- Reset the offset!
-          showModeSelect();
-          currentState = MODE_SELECT;
-          return;  // or break; if not in a function
-        }
-
-        if (key && key >= '1' && key <= '0' + maxToShow) {
-          int option = key - '1';            // 0-based option (0,1,2,3)
-          int exclude = multiplayerPlayer1;  // 0-based index to skip
-          int chosenIdx = -1;
-          int count = 0;
-          // Loop through the currently displayed players
-          for (int i = playerDisplayOffset; i < playerNames.size() && count < maxToShow; i++) {
-            if (i == exclude)
-              continue;  // skip the chosen player
-            if (count == option) {
-              chosenIdx = i;
-              break;
-            }
-            count++;
-          }
-          if (chosenIdx != -1) {
-            multiplayerPlayer2 = chosenIdx;
-            showMultiplayerMenu();
-            currentState = MULTI_MENU;
-            delay(150);
-            while (keypad.getKey() != NO_KEY) {
-            }
-          }
-        }
-        break;
-      }
-
-    case MULTI_MENU:
-      {
-        if (key == '#') {
-          playerDisplayOffset = 0;  // <-- Reset the offset!
-          showModeSelect();
-          currentState = MODE_SELECT;
-          return;  // or break; if not in a function
-        }
-
-        if (key == '1') {
-          // Reset multiplayer Code Breaker variables
-          memset(player1Secret, 0, sizeof(player1Secret));
-          memset(player2Secret, 0, sizeof(player2Secret));
-          memset(player1Guess, 0, sizeof(player1Guess));
-          memset(player2Guess, 0, sizeof(player2Guess));
-          player1Tries = 0;
-          player2Tries = 0;
-          player1Guessed = false;
-          player2Guessed = false;
-          codeBreakerMultiplayerTurn = false;
-          cbMultiInputIndex = 0;
-
-          currentState = CODE_BREAKER_MULTI_SECRET1;
-          break;
-        }
-
-        // If any other key is pressed, show "Not implemented"
-        if (key && key != NO_KEY) {
-          display.fillScreen(WHITE);
-          display.setTextColor(RED);
-          display.setTextSize(2);
-          display.setCursor(20, 120);
-          display.print("Not implemented");
-          delay(1200);
-          showMultiplayerMenu();  // Redraw the menu
-        }
-        break;
-      }
-
-    case CODE_BREAKER_MULTI_SECRET1:
-      {
-        // Show prompt only once when entering the state
-        static bool promptShown1 = false;
-        if (!promptShown1) {
-          showEnterSecretPrompt(1);
-          showMaskedInputProgress(player1Secret, cbMultiInputIndex);
-          promptShown1 = true;
-        }
-
-        if (key && key >= '0' && key <= '9' && cbMultiInputIndex < 3) {
-          player1Secret[cbMultiInputIndex++] = key;
-          player1Secret[cbMultiInputIndex] = '\0';
-          showMaskedInputProgress(player1Secret, cbMultiInputIndex);  // Update input line only
-        }
-
-        if (cbMultiInputIndex == 3) {
-          delay(500);
-          display.fillRect(0, 190, SCREEN_WIDTH, 30, WHITE);  // Clear input line
-          delay(300);
-          cbMultiInputIndex = 0;
-          promptShown1 = false;  // Reset for next time
-          currentState = CODE_BREAKER_MULTI_SECRET2;
-        }
-        break;
-      }
-
-    case CODE_BREAKER_MULTI_SECRET2:
-      {
-        static bool promptShown2 = false;
-        if (!promptShown2) {
-          showEnterSecretPrompt(2);
-          showMaskedInputProgress(player2Secret, cbMultiInputIndex);
-          promptShown2 = true;
-        }
-
-        if (key && key >= '0' && key <= '9' && cbMultiInputIndex < 3) {
-          player2Secret[cbMultiInputIndex++] = key;
-          player2Secret[cbMultiInputIndex] = '\0';
-          showMaskedInputProgress(player2Secret, cbMultiInputIndex);
-        }
-
-        if (cbMultiInputIndex == 3) {
-          delay(500);
-          display.fillRect(0, 190, SCREEN_WIDTH, 30, WHITE);
-          delay(300);
-          codeBreakerMultiplayerTurn = false;
-          cbMultiInputIndex = 0;
-          promptShown2 = false;  // Reset for next time
-          // Now move to guessing phase...
-          currentState = CODE_BREAKER_MULTI_TURN_P1;
-        }
-        break;
-      }
-
-    case CODE_BREAKER_MULTI_TURN_P1:
-      {
-        static bool feedbackShown = false;
-        if (!feedbackShown) {
-          if (player1Tries > 0) {
-            showLastFeedback(1, player1LastGuess, player1LastExact, player1LastPartial);
-            delay(2000);
-          }
-          showGuessScreen(1, player1Tries);
-          showInputProgress(player1Guess, 0);
-          feedbackShown = true;
-        }
-        if (key && key >= '0' && key <= '9' && cbMultiInputIndex < 3) {
-          player1Guess[cbMultiInputIndex++] = key;
-          showInputProgress(player1Guess, cbMultiInputIndex);
-        }
-        if (cbMultiInputIndex == 3) {
-          player1Guess[3] = '\0';
-          int exact = 0, partial = 0;
-          cbMultiCountMatches(player1Guess, player2Secret, exact, partial);
-          player1Tries++;
-
-          // Store feedback for next turn
-          strcpy(player1LastGuess, player1Guess);
-          player1LastExact = exact;
-          player1LastPartial = partial;
-
-          // Show feedback
-          display.fillScreen(WHITE);
-          display.setTextSize(2);
-          display.setTextColor(BLACK);
-          display.setCursor(20, 60);
-          display.print("Player 1 Guess: ");
-          display.print(player1Guess);
-          display.setCursor(20, 100);
-          display.setTextColor(GREEN);
-          display.print("Exact: ");
-          display.print(exact);
-          display.setTextColor(RED);
-          display.setCursor(20, 140);
-          display.print("Partial: ");
-          display.print(partial);
-          delay(1500);
-
-          if (exact == 3) {
-            display.fillScreen(WHITE);
-            display.setTextColor(GREEN);
-            display.setTextSize(2);
-            display.setCursor(20, 100);
-            display.print("Player 1 Wins!");
-            display.setCursor(20, 140);
-            display.setTextSize(1);
-            display.setTextColor(BLACK);
-            display.print("Tries: ");
-            display.print(player1Tries);
-            delay(2500);
-            showMenu();
-            currentState = MENU;
-            feedbackShown = false;
-            cbMultiInputIndex = 0;
-            break;
-          }
-          // Next player's turn
-          cbMultiInputIndex = 0;
-          memset(player1Guess, 0, sizeof(player1Guess));
-          feedbackShown = false;
-          currentState = CODE_BREAKER_MULTI_TURN_P2;  // Switch to Player 2
-        }
-        break;
-      }
-
-    case CODE_BREAKER_MULTI_TURN_P2:
-      {
-        static bool feedbackShown = false;
-        if (!feedbackShown) {
-          if (player2Tries > 0) {
-            showLastFeedback(2, player2LastGuess, player2LastExact, player2LastPartial);
-            delay(2000);
-          }
-          showGuessScreen(2, player2Tries);
-          showInputProgress(player2Guess, 0);
-          feedbackShown = true;
-        }
-        if (key && key >= '0' && key <= '9' && cbMultiInputIndex < 3) {
-          player2Guess[cbMultiInputIndex++] = key;
-          showInputProgress(player2Guess, cbMultiInputIndex);
-        }
-        if (cbMultiInputIndex == 3) {
-          player2Guess[3] = '\0';
-          int exact = 0, partial = 0;
-          cbMultiCountMatches(player2Guess, player1Secret, exact, partial);
-          player2Tries++;
-
-          // Store feedback for next turn
-          strcpy(player2LastGuess, player2Guess);
-          player2LastExact = exact;
-          player2LastPartial = partial;
-
-          // Show feedback
-          display.fillScreen(WHITE);
-          display.setTextSize(2);
-          display.setTextColor(BLACK);
-          display.setCursor(20, 60);
-          display.print("Player 2 Guess: ");
-          display.print(player2Guess);
-          display.setCursor(20, 100);
-          display.setTextColor(GREEN);
-          display.print("Exact: ");
-          display.print(exact);
-          display.setTextColor(RED);
-          display.setCursor(20, 140);
-          display.print("Partial: ");
-          display.print(partial);
-          delay(1500);
-
-          if (exact == 3) {
-            display.fillScreen(WHITE);
-            display.setTextColor(GREEN);
-            display.setTextSize(2);
-            display.setCursor(20, 100);
-            display.print("Player 2 Wins!");
-            display.setCursor(20, 140);
-            display.setTextSize(1);
-            display.setTextColor(BLACK);
-            display.print("Tries: ");
-            display.print(player2Tries);
-            delay(2500);
-            showMenu();
-            currentState = MENU;
-            feedbackShown = false;
-            cbMultiInputIndex = 0;
-            break;
-          }
-          // Next player's turn
-          cbMultiInputIndex = 0;
-          memset(player2Guess, 0, sizeof(player2Guess));
-          feedbackShown = false;
-          currentState = CODE_BREAKER_MULTI_TURN_P1;  // Switch to Player 1
-        }
-        break;
-      }
-
-    case PLAYER_SELECT:
-      {
-        if (key == '9') {
-          if (playerDisplayOffset + 4 < playerNames.size()) {
-            playerDisplayOffset += 4;
-            // Redraw the selection menu with new offset
-            showPlayerMenu();
-          }
-          break;
-        }
-        if (key == '#') {
-          playerDisplayOffset = 0;  // <-- Reset the offset!
-          showModeSelect();
-          currentState = MODE_SELECT;
-          return;
-        }
-
-        if (key && key >= '1' && key <= '4' && (key - '0') <= maxToShow) {
-          int selection = key - '1';  // 0-based index for key pressed (0 for '1', 1 for '2', etc.)
-          int actualIndex = playerDisplayOffset + selection;
-          if (actualIndex < playerNames.size()) {
-            currentPlayer = actualIndex;        // 1-based index if you want, or just use actualIndex
-            showPlayerSelected(currentPlayer);  // Pass actualIndex+1 or actualIndex as needed
-            showMenu();
-            currentState = MENU;
-            playerDisplayOffset = 0;
-          }
-        }
-        break;
-      }
-
-    case MENU:
-
-      {
-        if (key) {
-          if (key == '#') {
-            playerDisplayOffset = 0;  // <-- Reset the offset!
-            showModeSelect();
-            currentState = MODE_SELECT;
-            codeBreakerWrongTries = 0;
-            visualMemoryWrongTries = 0;
-            break;
-          }
-          Serial.print("Key pressed: ");
-          Serial.println(key);
-
-          //  Code Breaker
-          if (key == '1') {
-            generateNewRandomNumber();
-            inputIndex = 0;
-            codeBreakerWrongTries = 0;  // Reset here the number of tries
-            showInputProgress(inputBuffer, inputIndex);
-            currentState = CODE_BREAKER_DIFFICULTY_SELECT;
-            showCodeBreakerDifficultyMenu();
-            if (key == '*') {
-              display.fillRect(0, 220, SCREEN_WIDTH, 30, WHITE);
-              showMenu();
-              currentState = MENU;
-              codeBreakerWrongTries = 0;
-              visualMemoryWrongTries = 0;
-              break;
-            }
-            if (key == '#') {
-              playerDisplayOffset = 0;  // <-- Reset the offset!
-              showModeSelect();
-              currentState = MODE_SELECT;
-              codeBreakerWrongTries = 0;
-              visualMemoryWrongTries = 0;
-              break;
-            }
-          } else if (key == '2') {
-            currentState = VISUAL_MEMORY_DIFFICULTY_SELECT;
-            showVisualMemoryDifficultyMenu();
-          }
-          // --- Color-Word Challenge menu handler ---
-          else if (key == '3') {
-            showColorWordDifficultySelect();
-            currentState = COLOR_WORD_DIFFICULTY_SELECT;
-          } else if (key == '4') {
-            showLedReactionDifficultySelect();
-            currentState = LED_REACTION_DIFFICULTY_SELECT;
-          }
-
-          else {
-            showMenuMessage("Please choose 1, 2, 3 or 4");
-          }
-        }
-        break;
-      }
-
-    case VISUAL_MEMORY_DIFFICULTY_SELECT:
-      {
-        if (key) {
-          if (key == '*') {
-            display.fillRect(0, 220, SCREEN_WIDTH, 30, WHITE);
-            showMenu();
-            currentState = MENU;
-            codeBreakerWrongTries = 0;
-            visualMemoryWrongTries = 0;
-            break;
-          }
-          if (key == '#') {
-            playerDisplayOffset = 0;  // <-- Reset the offset!
-            showModeSelect();
-            currentState = MODE_SELECT;
-            codeBreakerWrongTries = 0;
-            visualMemoryWrongTries = 0;
-            break;
-          }
-          switch (key) {
-            case '1':  // Easy
-              colorSequenceLength = 5;
-              break;
-            case '2':  // Medium
-              colorSequenceLength = 8;
-              break;
-            case '3':  // Hard
-              colorSequenceLength = 10;
-              break;
-            default:
-              // Ignore other keys
-              return;
-          }
-          visualMemoryWrongTries = 0;  // Reset tries
-
-          // Now start the Visual Memory game as before:
-          generateRandomColorSequence(colorSequence, colorSequenceLength);
-          for (uint8_t i = 0; i < colorSequenceLength; i++) {
-            showColorOnDisplay(colorSequence[i]);
-            showColorOnRings(colorSequence[i]);
-            delay(2000);
-            turnOffAllRings();
-            if (i < colorSequenceLength - 1) {
-              display.fillScreen(WHITE);
-              delay(1000);
-            }
-            turnOffAllRings();
-          }
-          display.fillScreen(WHITE);
-          display.setTextColor(BLACK);
-          display.setTextSize(2);
-          display.setCursor(20, 100);
-          display.print("Repeat the sequence!");
-          showBottomHints();
-          currentStep = 0;
-          lastButtonState[0] = lastButtonState[1] = lastButtonState[2] = HIGH;
-          currentState = VISUAL_MEMORY_INPUT;
-        }
-        break;
-      }
-
-    case VISUAL_MEMORY_INPUT:
-      {
-        if (key == '*') {
-          display.fillRect(0, 220, SCREEN_WIDTH, 30, WHITE);
-          showMenu();
-          currentState = MENU;
-          codeBreakerWrongTries = 0;
-          visualMemoryWrongTries = 0;
-          break;
-        }
-        if (key == '#') {
-          playerDisplayOffset = 0;  // <-- Reset the offset!
-          showModeSelect();
-          currentState = MODE_SELECT;
-          codeBreakerWrongTries = 0;
-          visualMemoryWrongTries = 0;
-          break;
-        }
-
-        // --- Handle button presses for visual memory game ---
-        int buttonPins[3] = { RED_BUTTON_PIN, BLUE_BUTTON_PIN, GREEN_BUTTON_PIN };
-        const char *buttonNames[3] = { "Red button pressed", "Blue button pressed", "Green button pressed" };
-        for (int i = 0; i < 3; i++) {
-          int reading = digitalRead(buttonPins[i]);
-          if (lastButtonState[i] == HIGH && reading == LOW && (millis() - lastDebounceTime[i]) > debounceDelay) {
-            lastDebounceTime[i] = millis();
-            Serial.println(buttonNames[i]);
-            if (i == colorSequence[currentStep]) {
-              currentStep++;
-              if (currentStep == colorSequenceLength) {
-                int stars = 10 - visualMemoryWrongTries;
-                showCenteredStarsAndScore(stars);
-                uploadVisualMemorySession(playerDocIds[currentPlayer], stars, stars * 2);
-                String gameName = "visual_memory_challenge";
-                int currentHighScore = fetchHighScore(playerDocIds[currentPlayer], gameName);
-                if (stars * 20 > currentHighScore) {
-                  updateHighScore(playerDocIds[currentPlayer], gameName, stars);
-                }             // Show only stars and score, centered
-                delay(2000);  // Show for 2 seconds
-                showMenu();   // Return to games menu
-                currentState = MENU;
-                visualMemoryWrongTries = 0;  // Reset tries
-                break;
-              }
-            } else {
-              visualMemoryWrongTries++;  // Increment on wrong try
-              // Check if the number of wrong tries exceeds the maximum allowed
-              if (visualMemoryWrongTries >= maxWrongTries_VM) {
-                display.fillScreen(WHITE);
-                display.setTextColor(RED);
-                display.setTextSize(2);
-                display.setCursor(20, 120);
-                display.print("Out of tries!");
-                uploadVisualMemorySession(playerDocIds[currentPlayer], 0, 0);
-
-                delay(2000);
-                display.fillRect(0, 220, SCREEN_WIDTH, 30, WHITE);
-                showMenu();
-                currentState = MENU;
-                visualMemoryWrongTries = 0;  // Reset for next game
-                break;
-              }
-
-              Serial.println("Wrong sequence try again");
-              display.fillScreen(WHITE);
-              display.setTextSize(2);
-              display.setTextColor(RED);
-              display.setCursor(20, 120);
-              display.print("Wrong sequence");
-              display.setCursor(20, 150);
-              display.print("try again");
-              showBottomHints();
-              delay(1500);
-              display.fillScreen(WHITE);
-              display.setTextColor(BLACK);
-              display.setTextSize(2);
-              display.setCursor(20, 100);
-              display.print("Repeat the sequence!");
-              showBottomHints();
-              showTriesRemaining(maxWrongTries_VM - visualMemoryWrongTries);
-              currentStep = 0;
-            }
-          }
-          lastButtonState[i] = reading;
-        }
-        break;
-      }
-
-    case LED_REACTION_DIFFICULTY_SELECT:
-      {
-        if (key == '*') {
-          showMenu();
-          currentState = MENU;
-          colorWordWrongTries = 0;
-          colorWordCurrentStep = 0;
-          break;
-        }
-        if (key == '#') {
-          playerDisplayOffset = 0;  // <-- Reset the offset!
-          showModeSelect();
-          currentState = MODE_SELECT;
-          colorWordWrongTries = 0;
-          colorWordCurrentStep = 0;
-          break;
-        }
-        if (key == '1') {
-          ledReactionDifficulty = LED_EASY;
-          ledReactionStepDuration = ledReactionDurations[LED_EASY];
-          // Prepare game
-          ledReactionCorrect = 0;
-          ledReactionStartTime = millis();
-          ledReactionActive = true;
-          ledReactionWaiting = false;
-          showNextLedReactionColor();
-          currentState = LED_REACTION;
-        } else if (key == '2') {
-          ledReactionDifficulty = LED_MEDIUM;
-          ledReactionStepDuration = ledReactionDurations[LED_MEDIUM];
-          // Prepare game
-          ledReactionCorrect = 0;
-          ledReactionStartTime = millis();
-          ledReactionActive = true;
-          ledReactionWaiting = false;
-          showNextLedReactionColor();
-          currentState = LED_REACTION;
-        } else if (key == '3') {
-          ledReactionDifficulty = LED_HARD;
-          ledReactionStepDuration = ledReactionDurations[LED_HARD];
-          // Prepare game
-          ledReactionCorrect = 0;
-          ledReactionStartTime = millis();
-          ledReactionActive = true;
-          ledReactionWaiting = false;
-          showNextLedReactionColor();
-          currentState = LED_REACTION;
-        }
-        break;
-      }
-
-    case COLOR_WORD_DIFFICULTY_SELECT:
-      {
-        if (key == '*') {
-          showMenu();
-          currentState = MENU;
-          colorWordWrongTries = 0;
-          colorWordCurrentStep = 0;
-          break;
-        }
-        if (key == '#') {
-          playerDisplayOffset = 0;  // <-- Reset the offset!
-          showModeSelect();
-          currentState = MODE_SELECT;
-          colorWordWrongTries = 0;
-          colorWordCurrentStep = 0;
-          break;
-        }
-        if (key == '1') {
-          colorWordStepDuration = colorWordDurations[EASY];
-          colorWordDifficulty = EASY;
-          // Prepare game
-          generateColorWordChallengeSequences(cwcSeq1, cwcSeq2, COLOR_WORD_CHALLENGE_LENGTH);
-          colorWordCurrentStep = 0;
-          colorWordWrongTries = 0;
-          colorWordStepStartTime = 0;
-          showColorWordChallengeStep(0);
-          currentState = COLOR_WORD_CHALLENGE;
-        } else if (key == '2') {
-          colorWordStepDuration = colorWordDurations[MEDIUM];
-          colorWordDifficulty = MEDIUM;
-          // Prepare game
-          generateColorWordChallengeSequences(cwcSeq1, cwcSeq2, COLOR_WORD_CHALLENGE_LENGTH);
-          colorWordCurrentStep = 0;
-          colorWordWrongTries = 0;
-          colorWordStepStartTime = 0;
-          showColorWordChallengeStep(0);
-          currentState = COLOR_WORD_CHALLENGE;
-        } else if (key == '3') {
-          colorWordStepDuration = colorWordDurations[HARD];
-          colorWordDifficulty = HARD;
-          // Prepare game
-          generateColorWordChallengeSequences(cwcSeq1, cwcSeq2, COLOR_WORD_CHALLENGE_LENGTH);
-          colorWordCurrentStep = 0;
-          colorWordWrongTries = 0;
-          colorWordStepStartTime = 0;
-          showColorWordChallengeStep(0);
-          currentState = COLOR_WORD_CHALLENGE;
-        }
-        break;
-      }
-
-    case COLOR_WORD_CHALLENGE:
-      {
-        unsigned long now = millis();
-        if (colorWordStepStartTime == 0) {
-          colorWordStepStartTime = now;
-        }
-        // Allow menu/logout
-        if (key == '*') {
-          showMenu();
-          currentState = MENU;
-          colorWordWrongTries = 0;
-          colorWordCurrentStep = 0;
-          break;
-        }
-        if (key == '#') {
-          playerDisplayOffset = 0;  // <-- Reset the offset!
-          showModeSelect();
-          currentState = MODE_SELECT;
-          colorWordWrongTries = 0;
-          colorWordCurrentStep = 0;
-          break;
-        }
-
-        // Start timer for each new word
-        if (colorWordStepStartTime == 0) {
-          colorWordStepStartTime = now;
-        }
-
-        // Handle timeout: if 7 seconds pass, count as wrong and advance
-        if (now - colorWordStepStartTime >= colorWordStepDuration) {
-          colorWordWrongTries++;
-          colorWordCurrentStep++;
-          colorWordStepStartTime = 0;  // reset for next word
-
-          if (colorWordCurrentStep == COLOR_WORD_CHALLENGE_LENGTH) {
-            int stars = colorWordMaxTries - colorWordWrongTries;
-            showCenteredStarsAndScore(stars);
-            uploadColorWordSession(playerDocIds[currentPlayer], stars, stars * 2);
-            String gameName = "color_word_game";
-            int currentHighScore = fetchHighScore(playerDocIds[currentPlayer], gameName);
-            if (stars * 20 > currentHighScore) {
-              updateHighScore(playerDocIds[currentPlayer], gameName, stars);
-            }
-
-            delay(2000);
-            showMenu();
-            currentState = MENU;
-            colorWordWrongTries = 0;
-            colorWordCurrentStep = 0;
-            break;
-          } else {
-            showColorWordChallengeStep(colorWordCurrentStep);
-          }
-        }
-
-        // Handle button presses
-        int buttonPins[3] = { RED_BUTTON_PIN, BLUE_BUTTON_PIN, GREEN_BUTTON_PIN };
-        for (int i = 0; i < 3; i++) {
-          int reading = digitalRead(buttonPins[i]);
-          if (lastButtonState[i] == HIGH && reading == LOW && (now - lastDebounceTime[i]) > debounceDelay) {
-            lastDebounceTime[i] = now;
-
-            if (i == cwcSeq1[colorWordCurrentStep]) {
-              // Correct: advance and award star (no need to increment wrongTries)
-              colorWordCurrentStep++;
-            } else {
-              // Wrong: advance, count as wrong, no retry
-              colorWordWrongTries++;
-              colorWordCurrentStep++;
-            }
-            colorWordStepStartTime = 0;  // reset timer for next word
-
-            if (colorWordCurrentStep == COLOR_WORD_CHALLENGE_LENGTH) {
-              int stars = colorWordMaxTries - colorWordWrongTries;
-              showCenteredStarsAndScore(stars);
-              uploadColorWordSession(playerDocIds[currentPlayer], stars, stars * 2);
-              String gameName = "color_word_game";
-              int currentHighScore = fetchHighScore(playerDocIds[currentPlayer], gameName);
-              if (stars * 20 > currentHighScore) {
-                updateHighScore(playerDocIds[currentPlayer], gameName, stars);
-              }
-              delay(2000);
-              showMenu();
-              currentState = MENU;
-              colorWordWrongTries = 0;
-              colorWordCurrentStep = 0;
-              break;
-            } else {
-              showColorWordChallengeStep(colorWordCurrentStep);
-            }
-          }
-          lastButtonState[i] = reading;
-        }
-        break;
-      }
+  loopProfiler.pass(stateMachine.state(), "commit");
+  stallWatchdog.feed(stateMachine.state());
+  if (stallWatchdog.recovering())
+    recoverFromStall();
+  power.pass(stateMachine.idle() && !timeline.busy());  // Full clock before a game's first tick
+  uint32_t batch = screens.commit();  // Draw what the last pass posted
+  leds.commit();                      // Whatever the last pass did to the rings, as one frame
+  loopProfiler.phase("diagnostics");
+  recordTouchLatency(batch);
+  finishLatencyProbe(batch);
+  renderStats.setState(stateMachine.state());
+  handleSerialCommand();
+
+  loopProfiler.phase("input");
+  // One event per pass: a key (keypad or touch) or a game button press.
+  // Releases and holds aren't used yet.
+  InputEvent input;
+  bool got = inputBus.read(input);
+  bool pressed = got && input.action == INPUT_PRESS;
+  if (got) {
+    power.input();
+    stallWatchdog.event(input, stateMachine.state());
+    if (!pressed)
+      watchProfileChord(input);
+  }
 
-    case LED_REACTION:
-      {
-        static unsigned long ledStepStartTime = 0;
-
-        if (key == '*') {
-          turnOffAllRings();
-          showMenu();
-          currentState = MENU;
-          ledReactionActive = false;
-          ledReactionWaiting = false;
-          break;
-        }
-        if (key == '#') {
-          playerDisplayOffset = 0;  // <-- Reset the offset!
-          turnOffAllRings();
-          showModeSelect();
-          currentState = MODE_SELECT;
-          ledReactionActive = false;
-          ledReactionWaiting = false;
-          break;
-        }
-
-        if (!ledReactionActive)
-          break;
-
-        unsigned long now = millis();
-
-        // ----- Handle the white screen delay -----
-        if (ledReactionWaiting) {
-          if (now - ledReactionDelayStart >= ledReactionDelayDuration) {
-            // End of white screen, show next color
-            display.fillScreen(WHITE);  // Optional: clear before next color
-            showNextLedReactionColor();
-            ledStepStartTime = now;
-            ledReactionWaiting = false;
-          }
-          break;  // Don't process button/color logic during white screen
-        }
-
-        // ----- Start step timer and show new color if needed -----
-        if (ledStepStartTime == 0) {
-          showNextLedReactionColor();
-          ledStepStartTime = now;
-        }
-
-        // ----- Check for button press -----
-        int buttonPins[3] = { RED_BUTTON_PIN, BLUE_BUTTON_PIN, GREEN_BUTTON_PIN };
-        for (int i = 0; i < 3; i++) {
-          int reading = digitalRead(buttonPins[i]);
-          if (lastButtonState[i] == HIGH && reading == LOW && (now - lastDebounceTime[i]) > debounceDelay) {
-            lastDebounceTime[i] = now;
-            if (i == ledReactionCurrentColor) {
-              ledReactionCorrect++;  // Correct button
-            }
-            // Move to white screen before next color
-            turnOffAllRings();
-            display.fillScreen(WHITE);
-            ledReactionWaiting = true;
-            ledReactionDelayStart = millis();
-            ledStepStartTime = 0;  // Reset for next round
-            break;
-          }
-          lastButtonState[i] = reading;
-        }
-
-        // ----- Timeout: move to white screen if time exceeded -----
-        if (!ledReactionWaiting && (now - ledStepStartTime >= ledReactionStepDuration)) {
-          turnOffAllRings();
-          display.fillScreen(WHITE);
-          ledReactionWaiting = true;
-          ledReactionDelayStart = millis();
-          ledStepStartTime = 0;  // Reset for next round
-        }
-
-        // ----- End game after 20 seconds -----
-        if (now - ledReactionStartTime >= ledReactionGameDuration) {
-          ledReactionActive = false;
-          turnOffAllRings();
-          showLedReactionScore(ledReactionCorrect);  // Show score
-          uploadLedReactionSession(playerDocIds[currentPlayer], ledReactionCorrect, ledReactionCorrect * 2);
-          String gameName = "LED_reaction_game";
-          int currentHighScore = fetchHighScore(playerDocIds[currentPlayer], gameName);
-          if (ledReactionCorrect * 2 > currentHighScore) {
-            updateHighScore(playerDocIds[currentPlayer], gameName, ledReactionCorrect * 2);
-          }
-          showMenu();
-          currentState = MENU;
-          ledReactionWaiting = false;
-        }
-        break;
-      }
+  // While a timed sequence plays only '*' and '#' are live, and they cut it short
+  loopProfiler.phase("timeline");
+  timeline.tick(millis());
+  leds.service(millis());
+  if (timeline.busy()) {
+    uint8_t to = pressed && input.source != INPUT_BUTTON ? stateMachine.target(input.key) : STATE_NONE;
+    if (to != STATE_NONE) {
+      timeline.cancel();
+      stateMachine.go(to);
+    }
+    return;
+  }
 
-    case CODE_BREAKER_DIFFICULTY_SELECT:
-      {
-        if (key) {
-          if (key == '*') {
-            display.fillRect(0, 220, SCREEN_WIDTH, 30, WHITE);
-            showMenu();
-            currentState = MENU;
-            codeBreakerWrongTries = 0;
-            visualMemoryWrongTries = 0;
-            break;
-          }
-          if (key == '#') {
-            playerDisplayOffset = 0;  // <-- Reset the offset!
-            showModeSelect();
-            currentState = MODE_SELECT;
-            codeBreakerWrongTries = 0;
-            visualMemoryWrongTries = 0;
-            break;
-          }
-          switch (key) {
-            case '1':  // Easy
-              codeBreakerWrongTries = 0;
-              // Set max tries for easy
-              maxWrongTries = 12;
-              currentState = CODE_BREAKER;
-              showCodeBreakerTitle();  // Show the title screen
-              generateNewRandomNumber();
-              break;
-            case '2':  // Medium
-              codeBreakerWrongTries = 0;
-              // Set max tries for medium
-              maxWrongTries = 8;
-              currentState = CODE_BREAKER;
-              showCodeBreakerTitle();  // Show the title screen
-              generateNewRandomNumber();
-              break;
-            case '3':  // Hard
-              codeBreakerWrongTries = 0;
-              // Set max tries for hard
-              maxWrongTries = 5;
-              currentState = CODE_BREAKER;
-              showCodeBreakerTitle();  // Show the title screen
-              generateNewRandomNumber();
-              break;
-            default:
-              // Ignore other keys
-              break;
-          }
-        }
-        break;
-      }
+  loopProfiler.phase("onEvent");
+  if (pressed)
+    stateMachine.dispatch(input);
+  loopProfiler.phase("onTick");
+  if (!timeline.busy())
+    stateMachine.tick();
 
-    case CODE_BREAKER:
-      {
-        if (key) {
-          if (key == '*') {
-            showMenu();
-            currentState = MENU;
-            codeBreakerWrongTries = 0;
-            visualMemoryWrongTries = 0;
-            inputIndex = 0;
-            int y = 190;
-            display.fillRect(0, y, SCREEN_WIDTH, 30, WHITE);
-            break;
-          }
-          if (key == '#') {
-            playerDisplayOffset = 0;  // <-- Reset the offset!
-            showModeSelect();
-            currentState = MODE_SELECT;
-            codeBreakerWrongTries = 0;
-            visualMemoryWrongTries = 0;
-            break;
-          }
-          if (inputIndex < 3 && key >= '0' && key <= '9') {
-            inputBuffer[inputIndex++] = key;
-            showInputProgress(inputBuffer, inputIndex);
-          }
-          if (inputIndex == 3) {
-            inputBuffer[3] = '\0';
-            if (strcmp(inputBuffer, randomNumberStr) == 0) {
-              int stars = maxWrongTries - codeBreakerWrongTries;
-              showCenteredStarsAndScore(stars);  // Show only stars and score, centered
-              uploadCodeBreakerSession(playerDocIds[currentPlayer], stars, stars * 2);
-              String gameName = "code_breaker_game";
-              int currentHighScore = fetchHighScore(playerDocIds[currentPlayer], gameName);
-              if (stars * 20 >   currentHighScore) {
-                updateHighScore(playerDocIds[currentPlayer], gameName, stars);
-              }
-              delay(2000);  // Show for 2 seconds
-              showMenu();   // Return to games menu
-              currentState = MENU;
-              codeBreakerWrongTries = 0;  // Reset tries
-              inputIndex = 0;
-              break;
-            }
-
-            else {
-              int exact = 0, partial = 0;
-              countMatches(inputBuffer, randomNumberStr, exact, partial);
-
-              showCodeBreakerResult(exact, partial);
-              showLastTry(inputBuffer);
-              showTriesRemaining(maxWrongTries - codeBreakerWrongTries - 1);
-
-              codeBreakerWrongTries++;  // Increment on wrong try
-
-              if (codeBreakerWrongTries >= maxWrongTries) {
-                display.fillScreen(WHITE);
-                display.setTextColor(RED);
-                display.setTextSize(2);
-                display.setCursor(20, 120);
-                display.print("Out of tries!");
-                uploadCodeBreakerSession(playerDocIds[currentPlayer], 0, 0);
-                delay(2000);
-
-                // Clear the input progress line (where "_ _ _" is shown)
-                int y = 190;
-                display.fillRect(0, y, SCREEN_WIDTH, 30, WHITE);
-
-                showMenu();
-                currentState = MENU;
-                codeBreakerWrongTries = 0;  // Reset for next game
-                inputIndex = 0;
-                break;
-              }
-
-              Serial.print("Input: ");
-              Serial.print(inputBuffer);
-              Serial.print(" | Random: ");
-              Serial.print(randomNumberStr);
-              Serial.print(" | Exact: ");
-              Serial.print(exact);
-              Serial.print(" | Partial: ");
-              Serial.println(partial);
-            }
-            inputIndex = 0;
-            showInputProgress(inputBuffer, inputIndex);
-          }
-        }
-        break;
-      }
-  }
+  // On a menu with nothing left in flight, block or sleep until the next press
+  loopProfiler.phase("rest");
+  power.rest(!got && !Serial.available() && screens.idle() && leds.idle() && netWorker.idle());
 }
@@ -0,0 +1,187 @@
+#ifndef NET_WORKER_H_
+#define NET_WORKER_H_
+
+// Networking and logging on the protocol core.
+//
+// loop() and the input, LED and touch tasks run on the app core (1). Wi-Fi
+// already lives on the protocol core (0), and this worker's "net" task
+// joins it there, so an HTTP round trip, a JSON parse or a long
+// Serial.println() no longer holds up a game. The loop task hands work
+// over through two lock-free SpscRings and is never blocked by it:
+//
+//   post()  a Request for the task's handler (a session upload). A full
+//           queue drops the request and counts it.
+//   log()   a printf-formatted line, printed from the task. Formatting
+//           costs a few microseconds; the UART wait happens on core 0.
+//
+// Both are for the loop task only, so each ring keeps one producer. The
+// task also samples how busy each core is, from the FreeRTOS run-time
+// counters of the two idle tasks, when the build has them.
+//
+// Without a background task (host builds) post() runs the handler and
+// log() prints at once.
+
+#include <Arduino.h>
+#include <stdarg.h>
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "spsc_ring.h"
+
+#define NET_CORE 0  // Protocol core, with Wi-Fi
+#define NET_TASK_STACK 8192
+#define NET_TASK_PRIORITY 1
+#define NET_LOG_QUEUE_LEN 32
+#define NET_LOG_LINE_LEN 96     // Longer lines are cut short
+#define NET_CPU_SAMPLE_MS 1000  // Core utilisation window
+#define NET_MAX_TASKS 32        // Tasks uxTaskGetSystemState() can report
+
+#if configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS
+#define NET_CPU_STATS 1
+#else
+#define NET_CPU_STATS 0
+#endif
+
+template <typename Request, uint16_t QUEUE_LEN>
+class NetWorker {
+public:
+  typedef void (*HandlerFn)(const Request &request);
+
+  void begin(HandlerFn handler) {
+    _handler = handler;
+    xTaskCreatePinnedToCore(taskEntry, "net", NET_TASK_STACK, this, NET_TASK_PRIORITY, &_task, NET_CORE);
+  }
+
+  // Queue `request` for the handler. False if the queue was full.
+  bool post(const Request &request) {
+    if (!_task) {
+      run(request);
+      return true;
+    }
+    bool queued = _requests.push(request);
+    xTaskNotifyGive(_task);
+    return queued;
+  }
+
+  void log(const char *format, ...) __attribute__((format(printf, 2, 3))) {
+    Line line;
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line.text, sizeof(line.text), format, args);
+    va_end(args);
+    if (!_task) {
+      Serial.print(line.text);
+      return;
+    }
+    _lines.push(line);
+    xTaskNotifyGive(_task);
+  }
+
+  // Nothing queued and no request running
+  bool idle() const {
+    return !_requests.size() && !_lines.size() && !_running;
+  }
+
+  // Percent of the last NET_CPU_SAMPLE_MS `core` spent outside its idle
+  // task, or -1 if the build has no run-time stats
+  int8_t cpuBusy(uint8_t core) const {
+    return core < 2 ? _busyPct[core] : -1;
+  }
+
+  void dump(Print &out) const {
+    out.println("--- Cores ---");
+    for (uint8_t core = 0; core < 2; core++) {
+      if (_busyPct[core] < 0)
+        out.printf("core %u: busy n/a (no FreeRTOS run-time stats)\n", core);
+      else
+        out.printf("core %u: %d%% busy\n", core, _busyPct[core]);
+    }
+    out.printf("net: %lu requests, %lu us busy, longest %lu us\n", (unsigned long)_handled,
+               (unsigned long)_handlerUs, (unsigned long)_handlerMaxUs);
+    out.printf("net: requests queued %lu, peak %lu of %d, %lu dropped\n", (unsigned long)_requests.size(),
+               (unsigned long)_requests.peak(), QUEUE_LEN, (unsigned long)_requests.overflows());
+    out.printf("log: lines queued %lu, peak %lu of %d, %lu dropped\n", (unsigned long)_lines.size(),
+               (unsigned long)_lines.peak(), NET_LOG_QUEUE_LEN, (unsigned long)_lines.overflows());
+  }
+
+private:
+  struct Line {
+    char text[NET_LOG_LINE_LEN];
+  };
+
+  static void taskEntry(void *arg) {
+    static_cast<NetWorker *>(arg)->task();
+  }
+
+  void task() {
+    for (;;) {
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(NET_CPU_SAMPLE_MS));
+      // Lines logged before a request come out before its own output
+      Request request;
+      for (;;) {
+        Line line;
+        while (_lines.pop(line))
+          Serial.print(line.text);
+        if (!_requests.pop(request))
+          break;
+        run(request);
+      }
+      sampleCpu();
+    }
+  }
+
+  void run(const Request &request) {
+    if (!_handler)
+      return;
+    uint32_t start = (uint32_t)esp_timer_get_time();
+    _running = true;
+    _handler(request);
+    _running = false;
+    uint32_t us = (uint32_t)esp_timer_get_time() - start;
+    _handled++;
+    _handlerUs += us;
+    if (us > _handlerMaxUs)
+      _handlerMaxUs = us;
+  }
+
+  // Busy time per core: elapsed time minus what its idle task ran for
+  void sampleCpu() {
+#if NET_CPU_STATS
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    if (now - _sampleUs < NET_CPU_SAMPLE_MS * 1000UL)
+      return;
+    UBaseType_t count = uxTaskGetSystemState(_tasks, NET_MAX_TASKS, nullptr);
+    for (uint8_t core = 0; core < 2; core++) {
+      TaskHandle_t idle = xTaskGetIdleTaskHandleForCore(core);
+      for (UBaseType_t i = 0; i < count; i++) {
+        if (_tasks[i].xHandle != idle)
+          continue;
+        uint32_t idleUs = _tasks[i].ulRunTimeCounter;
+        if (_sampleUs) {
+          uint32_t elapsed = now - _sampleUs, idled = idleUs - _idleUs[core];
+          _busyPct[core] = idled >= elapsed ? 0 : (int8_t)(100 - idled * 100ULL / elapsed);
+        }
+        _idleUs[core] = idleUs;
+      }
+    }
+    _sampleUs = now;
+#endif
+  }
+
+  HandlerFn _handler = nullptr;
+  TaskHandle_t _task = nullptr;
+  SpscRing<Request, QUEUE_LEN> _requests;
+  SpscRing<Line, NET_LOG_QUEUE_LEN> _lines;
+  uint32_t _handled = 0;
+  uint32_t _handlerUs = 0;
+  uint32_t _handlerMaxUs = 0;
+  volatile bool _running = false;
+  volatile int8_t _busyPct[2] = { -1, -1 };
+#if NET_CPU_STATS
+  TaskStatus_t _tasks[NET_MAX_TASKS];
+  uint32_t _idleUs[2] = {};
+  uint32_t _sampleUs = 0;
+#endif
+};
+
+#endif  // NET_WORKER_H_
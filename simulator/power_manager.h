@@ -0,0 +1,232 @@
+#ifndef POWER_MANAGER_H_
+#define POWER_MANAGER_H_
+
+// CPU clock and light sleep on screens that only wait for a press.
+//
+// A menu has nothing to do between presses, but loop() used to poll it
+// flat out at 240 MHz. Each pass now tells the manager whether the State
+// is idle (a menu or a difficulty screen, marked in the state table) and,
+// at the end, whether the pass left anything pending:
+//
+//   game states      full clock, no waiting: nothing changes for them
+//   idle, busy       POWER_IDLE_MHZ
+//   idle, quiet      the loop task blocks for up to POWER_WAIT_MS, so the
+//                    core spends the gap in its idle task's WAITI
+//   quiet for long   after POWER_SLEEP_AFTER_MS without input, light sleep
+//                    until a wake pin goes low or POWER_SLEEP_MAX_MS passes
+//
+// The clock goes back up at the top of the first pass in a game state,
+// before its first onTick. 80 MHz is as low as it goes: the APB clock the
+// SPI, I2C, UART and RMT timings are derived from stays at 80 MHz down to
+// there, and Wi-Fi needs it.
+//
+// Light sleep stops both cores, Wi-Fi's included, so sleeps are kept short
+// enough for the station to stay associated and are skipped while the
+// network worker has work. The wake pins are active low (the keypad rows
+// with the columns driven low, the game buttons, the touch INT line);
+// the sleep hook parks the input drivers before and gives them their pins
+// back after. A pin that is already low (a key held) cancels the sleep.
+//
+// Every wake is measured. After a timer wake, how late it came back; after
+// a pin wake, the time from waking to the input event reaching loop(),
+// which is what a sleep adds to a press. A wake that takes longer than
+// POWER_WAKE_BUDGET_US turns light sleep off for the rest of the run, so
+// it can never cost responsiveness twice; the clock scaling stays.
+
+#include <Arduino.h>
+#include "driver/gpio.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define POWER_FULL_MHZ 240
+#define POWER_IDLE_MHZ 80
+#define POWER_WAIT_MS 1              // Longest a quiet pass blocks
+#define POWER_SLEEP_AFTER_MS 5000    // Without input before the first light sleep
+#define POWER_SLEEP_MAX_MS 500       // Per sleep; a few missed beacons, not a dropped station
+#define POWER_WAKE_WINDOW_MS 200     // Input this soon after a pin wake is what woke it
+#define POWER_WAKE_BUDGET_US 20000   // Longest acceptable wake to input
+#define POWER_MAX_WAKE_PINS 12
+
+class PowerManager {
+public:
+  // Called with true before a light sleep and false after it
+  typedef void (*SleepHookFn)(bool sleeping);
+
+  // `pins` go low on input once `hook(true)` has run
+  void begin(const int8_t *pins, uint8_t count, SleepHookFn hook) {
+    _pinCount = 0;
+    for (uint8_t i = 0; i < count && _pinCount < POWER_MAX_WAKE_PINS; i++) {
+      if (pins[i] >= 0)
+        _pins[_pinCount++] = pins[i];
+    }
+    _hook = hook;
+    _quietSinceMs = millis();
+    _clockSinceUs = (uint32_t)esp_timer_get_time();
+    _mhz = getCpuFrequencyMhz();
+    _begun = true;
+  }
+
+  // Top of every loop() pass
+  void pass(bool idle) {
+    if (!_begun)
+      return;
+    _idle = idle;
+    if (!idle)
+      _quietSinceMs = millis();
+    setClock(idle ? POWER_IDLE_MHZ : POWER_FULL_MHZ);
+  }
+
+  // An input event reached loop()
+  void input() {
+    _quietSinceMs = millis();
+    if (!_pinWakeUs)
+      return;
+    uint32_t us = (uint32_t)esp_timer_get_time() - _pinWakeUs;
+    _pinWakeUs = 0;
+    if (us >= POWER_WAKE_WINDOW_MS * 1000UL) {
+      _unexplained++;
+      return;
+    }
+    _pinWakes.add(us);
+    if (us > POWER_WAKE_BUDGET_US && _sleepAllowed) {
+      _sleepAllowed = false;
+      _disabledByUs = us;
+    }
+  }
+
+  // End of a pass in an idle State. `quiet`: the pass had no input and
+  // nothing it started (drawing, LED animation, uploads) is still going.
+  void rest(bool quiet) {
+    if (!_begun || !_idle || !quiet)
+      return;
+    if (_pinWakeUs && (uint32_t)esp_timer_get_time() - _pinWakeUs >= POWER_WAKE_WINDOW_MS * 1000UL) {
+      _pinWakeUs = 0;
+      _unexplained++;  // Noise on a pin, or a press too short to see
+    }
+    if (_sleepAllowed && millis() - _quietSinceMs >= POWER_SLEEP_AFTER_MS && lightSleep())
+      return;
+    uint32_t start = (uint32_t)esp_timer_get_time();
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(POWER_WAIT_MS));
+    _waitUs += (uint32_t)esp_timer_get_time() - start;
+  }
+
+  void dump(Print &out) {
+    setClock(_mhz);  // Brings the clock totals up to date
+    out.println("--- Power ---");
+    out.printf("clock: %u MHz now, %lu switches, longest %lu us\n", _mhz, (unsigned long)_switches,
+               (unsigned long)_switchMaxUs);
+    out.printf("clock: %llu ms at %d MHz, %llu ms at %d MHz; %lu ms of it waiting\n",
+               (unsigned long long)(_idleClockUs / 1000), POWER_IDLE_MHZ,
+               (unsigned long long)(_fullClockUs / 1000), POWER_FULL_MHZ, (unsigned long)(_waitUs / 1000));
+    out.printf("sleep: %s, %lu sleeps, %llu ms asleep, %lu refused with a wake pin low\n",
+               _sleepAllowed ? "on" : "off", (unsigned long)_sleeps, (unsigned long long)(_sleptUs / 1000),
+               (unsigned long)_refused);
+    if (!_sleepAllowed)
+      out.printf("sleep: turned off by a %lu us wake (budget %d us)\n", (unsigned long)_disabledByUs,
+                 POWER_WAKE_BUDGET_US);
+    _timerWakes.print(out, "timer wakes, late by");
+    _pinWakes.print(out, "pin wakes, wake to input");
+    out.printf("wake: %lu pin wakes with no input\n", (unsigned long)_unexplained);
+  }
+
+private:
+  struct Latency {
+    uint32_t count = 0;
+    uint64_t sumUs = 0;
+    uint32_t maxUs = 0;
+
+    void add(uint32_t us) {
+      count++;
+      sumUs += us;
+      if (us > maxUs)
+        maxUs = us;
+    }
+
+    void print(Print &out, const char *what) const {
+      out.printf("wake: %lu %s mean %lu us, max %lu us\n", (unsigned long)count, what,
+                 (unsigned long)(count ? sumUs / count : 0), (unsigned long)maxUs);
+    }
+  };
+
+  void setClock(uint16_t mhz) {
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    (_mhz == POWER_IDLE_MHZ ? _idleClockUs : _fullClockUs) += now - _clockSinceUs;
+    _clockSinceUs = now;
+    if (mhz == _mhz)
+      return;
+    setCpuFrequencyMhz(mhz);
+    _mhz = mhz;
+    uint32_t us = (uint32_t)esp_timer_get_time() - now;
+    _switches++;
+    if (us > _switchMaxUs)
+      _switchMaxUs = us;
+  }
+
+  // False if a wake pin was already low
+  bool lightSleep() {
+    if (_hook)
+      _hook(true);
+    for (uint8_t i = 0; i < _pinCount; i++) {
+      if (digitalRead(_pins[i]) == LOW) {
+        if (_hook)
+          _hook(false);
+        _refused++;
+        _quietSinceMs = millis();  // Don't retry every pass while it's held
+        return false;
+      }
+    }
+    Serial.flush();  // The UART stops with the clock
+    for (uint8_t i = 0; i < _pinCount; i++)
+      gpio_wakeup_enable((gpio_num_t)_pins[i], GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+    esp_sleep_enable_timer_wakeup((uint64_t)POWER_SLEEP_MAX_MS * 1000);
+
+    uint32_t start = (uint32_t)esp_timer_get_time();
+    esp_light_sleep_start();
+    uint32_t wake = (uint32_t)esp_timer_get_time();
+
+    esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+    for (uint8_t i = 0; i < _pinCount; i++)
+      gpio_wakeup_disable((gpio_num_t)_pins[i]);
+    if (_hook)
+      _hook(false);
+
+    _sleeps++;
+    _sleptUs += wake - start;
+    if (cause == ESP_SLEEP_WAKEUP_GPIO) {
+      _pinWakeUs = wake ? wake : 1;
+    } else {
+      uint32_t dueUs = start + POWER_SLEEP_MAX_MS * 1000UL;
+      _timerWakes.add((int32_t)(wake - dueUs) > 0 ? wake - dueUs : 0);
+    }
+    return true;
+  }
+
+  int8_t _pins[POWER_MAX_WAKE_PINS];
+  uint8_t _pinCount = 0;
+  SleepHookFn _hook = nullptr;
+  bool _begun = false;
+  bool _idle = false;
+  bool _sleepAllowed = true;
+  uint16_t _mhz = POWER_FULL_MHZ;
+  uint32_t _quietSinceMs = 0;
+  uint32_t _clockSinceUs = 0;
+  uint64_t _idleClockUs = 0;
+  uint64_t _fullClockUs = 0;
+  uint64_t _waitUs = 0;
+  uint32_t _switches = 0;
+  uint32_t _switchMaxUs = 0;
+  uint32_t _sleeps = 0;
+  uint32_t _refused = 0;
+  uint64_t _sleptUs = 0;
+  uint32_t _pinWakeUs = 0;  // esp_timer time of the last pin wake, until its input arrives
+  uint32_t _unexplained = 0;
+  uint32_t _disabledByUs = 0;
+  Latency _timerWakes;
+  Latency _pinWakes;
+};
+
+#endif  // POWER_MANAGER_H_
@@ -0,0 +1,178 @@
+#ifndef REACTION_STATS_H_
+#define REACTION_STATS_H_
+
+// Running summary of reaction times in constant memory.
+//
+// Count, mean and variance use Welford's update, which stays accurate
+// without keeping the samples. The median and 90th percentile are P²
+// estimates (Jain & Chlamtac, 1985): five markers per quantile that track
+// the sample minimum, the target quantile, the quantiles halfway to it
+// on either side, and the maximum. Each new sample moves the markers'
+// positions. Any marker that drifts a whole position from where it
+// should be is adjusted along a parabola through its neighbours. Up to
+// five samples the quantiles are exact.
+//
+// Everything lives in a fixed-size object. However long a session runs,
+// add() costs a few dozen floating-point operations and no allocation.
+// The class has no hardware dependencies; host/reaction_stats_test.cpp
+// checks it against exact results.
+
+#include <math.h>
+#include <stdint.h>
+
+class P2Quantile {
+public:
+  explicit P2Quantile(double p) : _p(p) {}
+
+  void reset() {
+    _count = 0;
+  }
+
+  void add(double x) {
+    if (_count < 5) {
+      // Insertion sort into the first markers
+      int i = _count++;
+      while (i > 0 && _q[i - 1] > x) {
+        _q[i] = _q[i - 1];
+        i--;
+      }
+      _q[i] = x;
+      if (_count == 5) {
+        for (int k = 0; k < 5; k++)
+          _n[k] = k + 1;
+        _want[0] = 1;
+        _want[1] = 1 + 2 * _p;
+        _want[2] = 1 + 4 * _p;
+        _want[3] = 3 + 2 * _p;
+        _want[4] = 5;
+      }
+      return;
+    }
+
+    // Cell the sample falls in; the extremes move out to take it
+    int k;
+    if (x < _q[0]) {
+      _q[0] = x;
+      k = 0;
+    } else if (x >= _q[4]) {
+      _q[4] = x;
+      k = 3;
+    } else {
+      k = 0;
+      while (x >= _q[k + 1])
+        k++;
+    }
+    for (int i = k + 1; i < 5; i++)
+      _n[i]++;
+    const double step[5] = { 0, _p / 2, _p, (1 + _p) / 2, 1 };
+    for (int i = 0; i < 5; i++)
+      _want[i] += step[i];
+    _count++;
+
+    for (int i = 1; i <= 3; i++) {
+      double d = _want[i] - _n[i];
+      if ((d >= 1 && _n[i + 1] - _n[i] > 1) || (d <= -1 && _n[i - 1] - _n[i] < -1)) {
+        int s = d > 0 ? 1 : -1;
+        double q = parabolic(i, s);
+        _q[i] = (_q[i - 1] < q && q < _q[i + 1]) ? q : linear(i, s);
+        _n[i] += s;
+      }
+    }
+  }
+
+  // Current estimate; 0 with no samples
+  double value() const {
+    if (_count == 0)
+      return 0;
+    if (_count <= 5)  // The markers are still the sorted samples
+      return _q[(int)(_p * (_count - 1) + 0.5)];
+    return _q[2];
+  }
+
+  uint32_t count() const {
+    return _count;
+  }
+
+private:
+  double parabolic(int i, int s) const {
+    double below = _n[i] - _n[i - 1], above = _n[i + 1] - _n[i];
+    return _q[i] + (double)s / (_n[i + 1] - _n[i - 1])
+                     * ((below + s) * (_q[i + 1] - _q[i]) / above + (above - s) * (_q[i] - _q[i - 1]) / below);
+  }
+
+  double linear(int i, int s) const {
+    return _q[i] + s * (_q[i + s] - _q[i]) / (_n[i + s] - _n[i]);
+  }
+
+  double _p;
+  uint32_t _count = 0;
+  double _q[5] = {};     // Marker heights
+  int32_t _n[5] = {};    // Marker positions, 1-based
+  double _want[5] = {};  // Desired positions
+};
+
+class ReactionStats {
+public:
+  ReactionStats() : _p50(0.5), _p90(0.9) {}
+
+  void reset() {
+    _count = 0;
+    _mean = 0;
+    _m2 = 0;
+    _min = 0;
+    _max = 0;
+    _p50.reset();
+    _p90.reset();
+  }
+
+  void add(uint32_t us) {
+    double x = us;
+    _count++;
+    double delta = x - _mean;
+    _mean += delta / _count;
+    _m2 += delta * (x - _mean);
+    if (_count == 1 || us < _min)
+      _min = us;
+    if (us > _max)
+      _max = us;
+    _p50.add(x);
+    _p90.add(x);
+  }
+
+  uint32_t count() const {
+    return _count;
+  }
+  // All in microseconds
+  double mean() const {
+    return _mean;
+  }
+  double variance() const {  // Sample variance; 0 below two samples
+    return _count > 1 ? _m2 / (_count - 1) : 0;
+  }
+  double stddev() const {
+    return sqrt(variance());
+  }
+  double p50() const {
+    return _p50.value();
+  }
+  double p90() const {
+    return _p90.value();
+  }
+  uint32_t min() const {
+    return _min;
+  }
+  uint32_t max() const {
+    return _max;
+  }
+
+private:
+  uint32_t _count = 0;
+  double _mean = 0;
+  double _m2 = 0;  // Sum of squared differences from the mean
+  uint32_t _min = 0;
+  uint32_t _max = 0;
+  P2Quantile _p50;
+  P2Quantile _p90;
+};
+
+#endif  // REACTION_STATS_H_
@@ -0,0 +1,170 @@
+#ifndef RENDER_STATS_H_
+#define RENDER_STATS_H_
+
+// Render instrumentation for the TFT.
+//
+// InstrumentedBus wraps the SPI bus the display draws through and counts
+// transactions, pixels and microseconds spent inside each transaction.
+// Screen functions open a RENDER_SCOPE(); everything drawn until the scope
+// closes is charged to that function and to the State the current loop()
+// pass started in. Scopes nest, but only the outermost one counts, so
+// helpers like showBottomHints() fold into the screen that called them.
+// Drawing outside any scope is charged to "(loop)".
+//
+// Everything here belongs to the display task, which does all the drawing;
+// the loop reaches reset() and dump() through DisplayServer::call(). The
+// one exception is setState(), which the loop sets for the task to read.
+
+#include <Arduino_GFX_Library.h>
+#include <atomic>
+#include <utility>
+
+#define RENDER_STATS_MAX_ENTRIES 48
+
+struct RenderStatEntry {
+  const char *screen;
+  uint8_t state;
+  uint32_t calls;
+  uint32_t transactions;
+  uint64_t pixels;
+  uint64_t busMicros;
+};
+
+class RenderStats {
+public:
+  // State the current loop() pass started in; used for attribution.
+  void setState(uint8_t state) {
+    _state.store(state, std::memory_order_relaxed);
+  }
+
+  // Returns false if a scope is already open (nested call).
+  bool openScope(const char *screen) {
+    if (_current)
+      return false;
+    _current = find(screen, _state.load(std::memory_order_relaxed));
+    _current->calls++;
+    return true;
+  }
+  void closeScope() {
+    _current = nullptr;
+  }
+
+  void beginTransaction() {
+    if (_depth++ == 0) {
+      active()->transactions++;
+      _txStart = micros();
+    }
+  }
+  void endTransaction() {
+    if (_depth > 0 && --_depth == 0) {
+      active()->busMicros += micros() - _txStart;
+    }
+  }
+
+  void addPixels(uint32_t n) {
+    active()->pixels += n;
+  }
+
+  uint8_t count() const {
+    return _count;
+  }
+  const RenderStatEntry &entry(uint8_t i) const {
+    return _entries[i];
+  }
+  void reset() {
+    _count = 0;
+    _current = nullptr;
+  }
+
+  void dump(Print &out, const char *(*stateName)(uint8_t)) const {
+    uint64_t totalPixels = 0, totalMicros = 0;
+    out.println("--- Render stats ---");
+    out.printf("%-32s %-32s %6s %8s %10s %10s\n", "screen", "state", "calls", "txns", "pixels", "us");
+    for (uint8_t i = 0; i < _count; i++) {
+      const RenderStatEntry &e = _entries[i];
+      out.printf("%-32s %-32s %6lu %8lu %10llu %10llu\n", e.screen, stateName(e.state),
+                 (unsigned long)e.calls, (unsigned long)e.transactions,
+                 (unsigned long long)e.pixels, (unsigned long long)e.busMicros);
+      totalPixels += e.pixels;
+      totalMicros += e.busMicros;
+    }
+    out.printf("total: %llu pixels, %llu us on the bus\n", (unsigned long long)totalPixels,
+               (unsigned long long)totalMicros);
+  }
+
+private:
+  RenderStatEntry *active() {
+    return _current ? _current : find("(loop)", _state.load(std::memory_order_relaxed));
+  }
+
+  RenderStatEntry *find(const char *screen, uint8_t state) {
+    for (uint8_t i = 0; i < _count; i++) {
+      if (_entries[i].screen == screen && _entries[i].state == state)
+        return &_entries[i];
+    }
+    if (_count == RENDER_STATS_MAX_ENTRIES) {
+      // Table full: charge the last slot, relabelled as overflow.
+      RenderStatEntry &last = _entries[RENDER_STATS_MAX_ENTRIES - 1];
+      last.screen = "(other)";
+      return &last;
+    }
+    RenderStatEntry &e = _entries[_count++];
+    e = RenderStatEntry{ screen, state, 0, 0, 0, 0 };
+    return &e;
+  }
+
+  RenderStatEntry _entries[RENDER_STATS_MAX_ENTRIES];
+  uint8_t _count = 0;
+  std::atomic<uint8_t> _state{ 0 };
+  uint8_t _depth = 0;
+  RenderStatEntry *_current = nullptr;
+  unsigned long _txStart = 0;
+};
+
+inline RenderStats renderStats;
+
+class RenderScope {
+public:
+  explicit RenderScope(const char *screen) : _owner(renderStats.openScope(screen)) {}
+  ~RenderScope() {
+    if (_owner)
+      renderStats.closeScope();
+  }
+
+private:
+  bool _owner;
+};
+
+#define RENDER_SCOPE() RenderScope renderScope_(__func__)
+
+// Drop-in replacement for an Arduino_DataBus implementation, e.g.
+// InstrumentedBus<Arduino_ESP32SPI> bus(TFT_DC, TFT_CS, ...);
+template <class Bus>
+class InstrumentedBus : public Bus {
+public:
+  template <typename... Args>
+  explicit InstrumentedBus(Args &&...args) : Bus(std::forward<Args>(args)...) {}
+
+  void beginWrite() override {
+    renderStats.beginTransaction();
+    Bus::beginWrite();
+  }
+  void endWrite() override {
+    Bus::endWrite();
+    renderStats.endTransaction();
+  }
+  void write16(uint16_t d) override {
+    renderStats.addPixels(1);
+    Bus::write16(d);
+  }
+  void writeRepeat(uint16_t p, uint32_t len) override {
+    renderStats.addPixels(len);
+    Bus::writeRepeat(p, len);
+  }
+  void writePixels(uint16_t *data, uint32_t len) override {
+    renderStats.addPixels(len);
+    Bus::writePixels(data, len);
+  }
+};
+
+#endif  // RENDER_STATS_H_
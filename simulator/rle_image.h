@@ -0,0 +1,162 @@
+#ifndef RLE_IMAGE_H_
+#define RLE_IMAGE_H_
+
+// Palette + run-length compressed images kept in flash.
+//
+// Pixels are stored row-major as runs of a palette index (up to 16
+// colours). Each run is one token byte:
+//
+//   bits 7..4  palette index
+//   bits 3..0  run length - 1, or 15 meaning "16 + LEB128 count follows"
+//
+// so a run of up to 15 pixels costs one byte and a full-width run of a
+// 240-pixel row costs three. Runs continue across row ends.
+//
+// drawRleImage() streams the runs straight into the panel's address
+// window; nothing larger than a 64-pixel line buffer is held in RAM. The
+// converter puts the top-left colour first in the palette, so index 0 is
+// the background and can be skipped when the screen is already that colour.
+//
+// Assets are generated from PNGs by host/rle_convert.cpp into assets/.
+
+#include <Arduino_GFX_Library.h>
+#include <algorithm>
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+#define RLE_MAX_PALETTE 16
+#define RLE_CHUNK_PIXELS 64
+#define RLE_REPEAT_MIN 16  // Shorter runs are batched rather than sent alone
+#define RLE_SKIP_MIN 12    // Background runs worth two address windows to skip
+
+struct RleImage {
+  uint16_t width;
+  uint16_t height;
+  uint8_t paletteSize;
+  const uint16_t *palette;
+  const uint8_t *data;
+  uint32_t size;
+};
+
+// Calls emit(index, count) for every run in the image.
+template <typename Emit>
+void decodeRleImage(const RleImage &img, Emit emit) {
+  const uint8_t *p = img.data;
+  const uint8_t *end = img.data + img.size;
+  while (p < end) {
+    uint8_t token = *p++;
+    uint32_t count = (token & 0x0F) + 1;
+    if ((token & 0x0F) == 0x0F) {
+      uint32_t extra = 0;
+      uint8_t shift = 0, b;
+      do {
+        b = *p++;
+        extra |= (uint32_t)(b & 0x7F) << shift;
+        shift += 7;
+      } while ((b & 0x80) && p < end);
+      count = 16 + extra;
+    }
+    emit(token >> 4, count);
+  }
+}
+
+// Streams decoded runs into the panel's address window. Long runs go out as
+// writeRepeat(), short ones are batched in a small buffer for writePixels().
+// With background == false, long runs of palette index 0 are not sent at
+// all: the stream closes and reopens the window past them, for images drawn
+// onto a screen already filled with their background colour.
+template <typename Display>
+class RleStream {
+public:
+  RleStream(Display &gfx, Arduino_DataBus &dataBus, int16_t x, int16_t y, const RleImage &img, bool background)
+    : _gfx(gfx), _bus(dataBus), _x(x), _y(y), _img(img), _background(background) {}
+
+  void run(uint8_t index, uint32_t count) {
+    if (!_background && index == 0 && count >= RLE_SKIP_MIN) {
+      flush();
+      advance(count);
+      _windowOpen = false;
+      return;
+    }
+    uint16_t color = _img.palette[index];
+    while (count) {
+      if (!_windowOpen)
+        openWindow();
+      // A window opened mid-row only covers the rest of that row.
+      uint32_t n = _rowOnly ? std::min<uint32_t>(count, _img.width - _cx) : count;
+      send(color, n);
+      advance(n);
+      count -= n;
+      if (_rowOnly && _cx == 0) {
+        flush();
+        _windowOpen = false;
+      }
+    }
+  }
+
+  void flush() {
+    if (_used) {
+      _bus.writePixels(_chunk, _used);
+      _used = 0;
+    }
+  }
+
+private:
+  void openWindow() {
+    _rowOnly = _cx != 0;
+    if (_rowOnly)
+      _gfx.writeAddrWindow(_x + _cx, _y + _cy, _img.width - _cx, 1);
+    else
+      _gfx.writeAddrWindow(_x, _y + _cy, _img.width, _img.height - _cy);
+    _windowOpen = true;
+  }
+
+  void send(uint16_t color, uint32_t count) {
+    if (count >= RLE_REPEAT_MIN) {
+      flush();
+      _bus.writeRepeat(color, count);
+      return;
+    }
+    while (count--) {
+      _chunk[_used++] = color;
+      if (_used == RLE_CHUNK_PIXELS)
+        flush();
+    }
+  }
+
+  void advance(uint32_t count) {
+    count += _cx;
+    _cy += count / _img.width;
+    _cx = count % _img.width;
+  }
+
+  Display &_gfx;
+  Arduino_DataBus &_bus;
+  int16_t _x, _y;
+  const RleImage &_img;
+  bool _background;
+  uint16_t _cx = 0, _cy = 0;
+  bool _windowOpen = false;
+  bool _rowOnly = false;
+  uint16_t _chunk[RLE_CHUNK_PIXELS];
+  uint8_t _used = 0;
+};
+
+// Draws img with its top-left corner at (x, y). The image must lie fully on
+// screen; anything else is skipped rather than clipped.
+template <typename Display>
+void drawRleImage(Display &gfx, Arduino_DataBus &dataBus, int16_t x, int16_t y, const RleImage &img,
+                  bool background = true) {
+  if (x < 0 || y < 0 || x + img.width > gfx.width() || y + img.height > gfx.height())
+    return;
+
+  RleStream<Display> stream(gfx, dataBus, x, y, img, background);
+  gfx.startWrite();
+  decodeRleImage(img, [&](uint8_t index, uint32_t count) { stream.run(index, count); });
+  stream.flush();
+  gfx.endWrite();
+}
+
+#endif  // RLE_IMAGE_H_
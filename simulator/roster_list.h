@@ -0,0 +1,174 @@
+#ifndef ROSTER_LIST_H_
+#define ROSTER_LIST_H_
+
+// Virtual scrolling list for the player pickers.
+//
+// Only the visible rows exist on screen; items are fetched by index through
+// a label callback, so the list costs the same with five players or five
+// thousand. Rows read "1) name" where the digit is the key that picks that
+// row. A thin scrollbar on the right shows where the window is.
+//
+// The list is split between the two tasks that use it:
+//
+//   RosterWindow  which items are on screen: begin(), scroll() a row at a
+//                 time, itemAtRow() for the key pressed. Three numbers,
+//                 owned by the game logic and handed to the renderers by
+//                 value.
+//   RosterList    draws a window. show() redraws by character: each row
+//                 remembers what it shows, and only the span of characters
+//                 that changed is cleared and printed again.
+//
+// Row text is formatted into fixed buffers; nothing is allocated.
+
+#include <Arduino_GFX_Library.h>
+#include <algorithm>
+#include <stdint.h>
+#include <string.h>
+
+#define ROSTER_ROWS 4
+#define ROSTER_TOP 100
+#define ROSTER_LEFT 20
+#define ROSTER_ROW_HEIGHT 30
+#define ROSTER_TEXT_SIZE 2
+#define ROSTER_CHAR_W (6 * ROSTER_TEXT_SIZE)
+#define ROSTER_CHAR_H (8 * ROSTER_TEXT_SIZE)
+#define ROSTER_ROW_CHARS 17  // Fits between ROSTER_LEFT and the scrollbar
+#define ROSTER_BAR_X 234
+#define ROSTER_BAR_W 4
+
+struct RosterWindow {
+  int16_t count = 0;     // Rows in the list, `exclude` left out
+  int16_t exclude = -1;  // Item index left out, or -1
+  int16_t top = 0;       // Row at the top of the screen
+
+  // `items` items scrolled to the top. `exclude` is an item index left out
+  // of the list (e.g. the player already picked), or -1.
+  void begin(int items, int exclude = -1) {
+    items = std::min(items, (int)INT16_MAX);
+    this->exclude = (exclude >= 0 && exclude < items) ? exclude : -1;
+    count = this->exclude >= 0 ? items - 1 : items;
+    top = 0;
+  }
+
+  // Move by `delta` rows. Returns false if already at that end of the list.
+  bool scroll(int delta) {
+    int to = std::max(0, std::min(top + delta, count - ROSTER_ROWS));
+    if (to == top)
+      return false;
+    top = to;
+    return true;
+  }
+
+  // Item index on visible row `row` (0-based), or -1 if that row is empty.
+  int itemAtRow(int row) const {
+    if (row < 0 || row >= ROSTER_ROWS || top + row >= count)
+      return -1;
+    int item = top + row;
+    return (exclude >= 0 && item >= exclude) ? item + 1 : item;
+  }
+};
+
+class RosterList {
+public:
+  typedef const char *(*LabelFn)(int item);
+
+  RosterList(Arduino_GFX &gfx, LabelFn label, uint16_t fg, uint16_t bg, uint16_t barFg, uint16_t barBg)
+    : _gfx(gfx), _label(label), _fg(fg), _bg(bg), _barFg(barFg), _barBg(barBg) {}
+
+  // Draw every row of `window` on a screen already cleared to the
+  // background colour.
+  void draw(const RosterWindow &window) {
+    _window = window;
+    for (uint8_t r = 0; r < ROSTER_ROWS; r++)
+      _shown[r][0] = '\0';
+    _thumbY = _thumbH = 0;
+    for (uint8_t r = 0; r < ROSTER_ROWS; r++)
+      drawRow(r);
+    if (_window.count > ROSTER_ROWS)
+      _gfx.fillRect(ROSTER_BAR_X, ROSTER_TOP, ROSTER_BAR_W, trackHeight(), _barBg);
+    drawThumb();
+  }
+
+  // Move what draw() put up to `window`, redrawing only what changed
+  void show(const RosterWindow &window) {
+    _window = window;
+    for (uint8_t r = 0; r < ROSTER_ROWS; r++)
+      drawRow(r);
+    drawThumb();
+  }
+
+private:
+  void format(uint8_t row, char *out) const {
+    int item = _window.itemAtRow(row);
+    if (item < 0) {
+      out[0] = '\0';
+      return;
+    }
+    uint8_t n = 0;
+    out[n++] = '1' + row;
+    out[n++] = ')';
+    out[n++] = ' ';
+    for (const char *s = _label(item); *s && n < ROSTER_ROW_CHARS; s++)
+      out[n++] = *s;
+    out[n] = '\0';
+  }
+
+  // Clear and reprint only the characters that differ from what is shown.
+  void drawRow(uint8_t row) {
+    char text[ROSTER_ROW_CHARS + 1];
+    format(row, text);
+    char *shown = _shown[row];
+    uint8_t first = 0;
+    while (text[first] && text[first] == shown[first])
+      first++;
+    uint8_t newLen = strlen(text), oldLen = strlen(shown);
+    if (first == newLen && first == oldLen)
+      return;
+    uint8_t last = std::max(newLen, oldLen);
+    while (last > first && last <= newLen && last <= oldLen && text[last - 1] == shown[last - 1])
+      last--;
+
+    int16_t y = ROSTER_TOP + row * ROSTER_ROW_HEIGHT;
+    _gfx.fillRect(ROSTER_LEFT + first * ROSTER_CHAR_W, y, (last - first) * ROSTER_CHAR_W, ROSTER_CHAR_H, _bg);
+    memcpy(shown, text, newLen + 1);
+    if (first < newLen) {
+      text[std::min(last, newLen)] = '\0';
+      _gfx.setTextSize(ROSTER_TEXT_SIZE);
+      _gfx.setTextColor(_fg);
+      _gfx.setCursor(ROSTER_LEFT + first * ROSTER_CHAR_W, y);
+      _gfx.print(text + first);
+    }
+  }
+
+  int16_t trackHeight() const {
+    return ROSTER_ROWS * ROSTER_ROW_HEIGHT - (ROSTER_ROW_HEIGHT - ROSTER_CHAR_H);
+  }
+
+  // Clear the part of the track the thumb moved off, then draw it in place.
+  void drawThumb() {
+    if (_window.count <= ROSTER_ROWS)
+      return;
+    int16_t track = trackHeight();
+    int16_t h = std::max<int16_t>(6, (int32_t)track * ROSTER_ROWS / _window.count);
+    int16_t y = ROSTER_TOP + (int32_t)(track - h) * _window.top / (_window.count - ROSTER_ROWS);
+    if (_thumbH) {
+      if (y > _thumbY)
+        _gfx.fillRect(ROSTER_BAR_X, _thumbY, ROSTER_BAR_W, std::min<int16_t>(y - _thumbY, _thumbH), _barBg);
+      else if (y < _thumbY)
+        _gfx.fillRect(ROSTER_BAR_X, std::max<int16_t>(y + h, _thumbY), ROSTER_BAR_W,
+                      _thumbY + _thumbH - std::max<int16_t>(y + h, _thumbY), _barBg);
+    }
+    _gfx.fillRect(ROSTER_BAR_X, y, ROSTER_BAR_W, h, _barFg);
+    _thumbY = y;
+    _thumbH = h;
+  }
+
+  Arduino_GFX &_gfx;
+  LabelFn _label;
+  uint16_t _fg, _bg, _barFg, _barBg;
+  RosterWindow _window;  // As drawn
+  char _shown[ROSTER_ROWS][ROSTER_ROW_CHARS + 1] = {};
+  int16_t _thumbY = 0, _thumbH = 0;
+};
+
+#endif  // ROSTER_LIST_H_
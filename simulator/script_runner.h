@@ -0,0 +1,318 @@
+#ifndef SCRIPT_RUNNER_H_
+#define SCRIPT_RUNNER_H_
+
+// Game flows as C++20 coroutines.
+//
+// A sequenced flow (play a colour, wait, hide it, wait for three digits,
+// show the feedback) is written as one function returning Script:
+//
+//   Script visualMemoryPlayback() {
+//     for (uint8_t i = 0; i < colorSequenceLength; i++) {
+//       showColor(colorSequence[i]);
+//       co_await scripts.sleep(2000);
+//       ...
+//     }
+//     stateMachine.go(VISUAL_MEMORY_INPUT);
+//   }
+//
+// instead of flags and timestamps spread over a state's handlers. The
+// coroutines are stackless: co_await suspends the script and returns to
+// whoever resumed it, so loop() never blocks. A script waits for one thing
+// at a time:
+//
+//   sleep(ms)  at least ms, measured from when it suspends, like the
+//              Timeline's minimum hold times
+//   button()   the next game button press; returns its InputEvent
+//   key()      the next keypad or touch key that reaches the state's
+//              onEvent (the state table takes '*' and '#' first)
+//
+// One script runs at a time, owned by the state that start()ed it. The
+// state's handlers drive it: onEvent passes presses to feed(), onTick
+// calls tick(), and onExit cancel()s it, which destroys the frame wherever
+// it is suspended. Because the script only ever runs inside a state
+// handler, stateMachine.go() from a script is deferred to the end of the
+// handler like any other; a script leaves its state that way and must not
+// cancel itself.
+//
+// Frames don't come from the heap: they are carved from SCRIPT_SLOTS
+// fixed slots of SCRIPT_FRAME_BYTES, two so that the next state's script
+// can be created before the last one is cancelled. A frame that doesn't
+// fit fails to start and is counted. dump() lists each script's frame
+// size as the compiler laid it out.
+
+#include <Arduino.h>
+#include <coroutine>
+#include <utility>
+#include "input_bus.h"
+
+#define SCRIPT_SLOTS 2
+#define SCRIPT_FRAME_BYTES 256
+#define SCRIPT_STATS_MAX 8  // Distinct script names kept for dump()
+
+// Fixed-slot allocator for coroutine frames
+class ScriptArena {
+public:
+  void *allocate(size_t size) {
+    if (size > SCRIPT_FRAME_BYTES) {
+      _tooBig++;
+      if (size > _largestRejected)
+        _largestRejected = size;
+      return nullptr;
+    }
+    for (uint8_t i = 0; i < SCRIPT_SLOTS; i++) {
+      if (!_size[i]) {
+        _size[i] = size;
+        return _slots[i];
+      }
+    }
+    _full++;
+    return nullptr;
+  }
+
+  void release(void *frame) {
+    for (uint8_t i = 0; i < SCRIPT_SLOTS; i++) {
+      if (frame == _slots[i])
+        _size[i] = 0;
+    }
+  }
+
+  // Bytes the compiler asked for, for a frame handed out by allocate()
+  size_t sizeOf(const void *frame) const {
+    for (uint8_t i = 0; i < SCRIPT_SLOTS; i++) {
+      if (frame == _slots[i])
+        return _size[i];
+    }
+    return 0;
+  }
+
+  uint32_t failures() const {
+    return _tooBig + _full;
+  }
+
+  void dump(Print &out) const {
+    out.printf("frames: %d slots of %d bytes, %lu too big (largest %lu bytes), %lu with no free slot\n",
+               SCRIPT_SLOTS, SCRIPT_FRAME_BYTES, (unsigned long)_tooBig, (unsigned long)_largestRejected,
+               (unsigned long)_full);
+  }
+
+private:
+  alignas(max_align_t) uint8_t _slots[SCRIPT_SLOTS][SCRIPT_FRAME_BYTES];
+  size_t _size[SCRIPT_SLOTS] = {};
+  uint32_t _tooBig = 0;
+  uint32_t _full = 0;
+  size_t _largestRejected = 0;
+};
+
+inline ScriptArena scriptArena;
+
+// Owning handle to a suspended script. It starts suspended; the runner
+// resumes it.
+class Script {
+public:
+  struct promise_type {
+    Script get_return_object() {
+      return Script(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    // No frame: an empty Script, which the runner refuses to start
+    static Script get_return_object_on_allocation_failure() {
+      return Script();
+    }
+    std::suspend_always initial_suspend() noexcept {
+      return {};
+    }
+    std::suspend_always final_suspend() noexcept {
+      return {};
+    }
+    void return_void() {}
+    void unhandled_exception() {
+      abort();
+    }
+    static void *operator new(size_t size) noexcept {
+      return scriptArena.allocate(size);
+    }
+    static void operator delete(void *frame) noexcept {
+      scriptArena.release(frame);
+    }
+  };
+
+  Script() = default;
+  Script(Script &&other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+  Script &operator=(Script &&other) noexcept {
+    if (this != &other) {
+      reset();
+      _handle = std::exchange(other._handle, nullptr);
+    }
+    return *this;
+  }
+  Script(const Script &) = delete;
+  Script &operator=(const Script &) = delete;
+  ~Script() {
+    reset();
+  }
+
+  explicit operator bool() const {
+    return (bool)_handle;
+  }
+
+  bool done() const {
+    return !_handle || _handle.done();
+  }
+
+  void resume() {
+    _handle.resume();
+  }
+
+  size_t frameBytes() const {
+    return _handle ? scriptArena.sizeOf(_handle.address()) : 0;
+  }
+
+  void reset() {
+    if (_handle)
+      _handle.destroy();
+    _handle = nullptr;
+  }
+
+private:
+  explicit Script(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+  std::coroutine_handle<promise_type> _handle;
+};
+
+class ScriptRunner {
+  enum Wait : uint8_t {
+    WAIT_NONE,
+    WAIT_SLEEP,
+    WAIT_BUTTON,
+    WAIT_KEY
+  };
+
+public:
+  class SleepAwaiter {
+  public:
+    SleepAwaiter(ScriptRunner &runner, uint32_t ms) : _runner(runner), _ms(ms) {}
+    bool await_ready() const {
+      return false;
+    }
+    void await_suspend(std::coroutine_handle<>) {
+      _runner._wait = WAIT_SLEEP;
+      _runner._wakeMs = millis() + _ms;
+    }
+    void await_resume() const {}
+
+  private:
+    ScriptRunner &_runner;
+    uint32_t _ms;
+  };
+
+  class InputAwaiter {
+  public:
+    InputAwaiter(ScriptRunner &runner, Wait wait) : _runner(runner), _wait(wait) {}
+    bool await_ready() const {
+      return false;
+    }
+    void await_suspend(std::coroutine_handle<>) {
+      _runner._wait = _wait;
+    }
+    InputEvent await_resume() const {
+      return _runner._event;
+    }
+
+  private:
+    ScriptRunner &_runner;
+    Wait _wait;
+  };
+
+  // Run `script` up to its first co_await, replacing any script running
+  void start(const char *name, Script script) {
+    cancel();
+    if (!script) {
+      Serial.printf("script %s: no frame (see 'c')\n", name);
+      return;
+    }
+    _script = std::move(script);
+    record(name, _script.frameBytes());
+    resume();
+  }
+
+  void cancel() {
+    _script.reset();
+    _wait = WAIT_NONE;
+  }
+
+  bool running() const {
+    return (bool)_script;
+  }
+
+  // Resume a sleeping script whose time has come
+  void tick(uint32_t nowMs) {
+    if (_wait == WAIT_SLEEP && (int32_t)(nowMs - _wakeMs) >= 0)
+      resume();
+  }
+
+  // Resume a script waiting for this kind of press. False if it wasn't.
+  bool feed(const InputEvent &event) {
+    bool wanted = event.source == INPUT_BUTTON ? _wait == WAIT_BUTTON : _wait == WAIT_KEY && event.key;
+    if (!wanted)
+      return false;
+    _event = event;
+    resume();
+    return true;
+  }
+
+  SleepAwaiter sleep(uint32_t ms) {
+    return SleepAwaiter(*this, ms);
+  }
+
+  InputAwaiter button() {
+    return InputAwaiter(*this, WAIT_BUTTON);
+  }
+
+  InputAwaiter key() {
+    return InputAwaiter(*this, WAIT_KEY);
+  }
+
+  void dump(Print &out) const {
+    out.println("--- Scripts ---");
+    scriptArena.dump(out);
+    out.printf("resumes: %lu\n", (unsigned long)_resumes);
+    for (uint8_t i = 0; i < _statCount; i++)
+      out.printf("%-28s %4lu bytes, %lu starts\n", _stats[i].name, (unsigned long)_stats[i].frameBytes,
+                 (unsigned long)_stats[i].starts);
+  }
+
+private:
+  struct Stat {
+    const char *name;
+    size_t frameBytes;
+    uint32_t starts;
+  };
+
+  void resume() {
+    _wait = WAIT_NONE;
+    _resumes++;
+    _script.resume();
+    if (_script.done())
+      _script.reset();
+  }
+
+  void record(const char *name, size_t frameBytes) {
+    for (uint8_t i = 0; i < _statCount; i++) {
+      if (_stats[i].name == name || !strcmp(_stats[i].name, name)) {
+        _stats[i].starts++;
+        return;
+      }
+    }
+    if (_statCount < SCRIPT_STATS_MAX)
+      _stats[_statCount++] = Stat{ name, frameBytes, 1 };
+  }
+
+  Script _script;
+  Wait _wait = WAIT_NONE;
+  uint32_t _wakeMs = 0;
+  InputEvent _event{};
+  uint32_t _resumes = 0;
+  Stat _stats[SCRIPT_STATS_MAX];
+  uint8_t _statCount = 0;
+};
+
+#endif  // SCRIPT_RUNNER_H_
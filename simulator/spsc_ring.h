@@ -0,0 +1,75 @@
+#ifndef SPSC_RING_H_
+#define SPSC_RING_H_
+
+// Lock-free single-producer, single-consumer ring buffer.
+//
+// One side only ever push()es (an ISR or a task), the other only pop()s.
+// Head and tail are free-running counters, each written by one side only,
+// so no lock or critical section is needed: the release store of the head
+// publishes the item written before it, and the release store of the tail
+// hands the slot back. N must be a power of two.
+//
+// A full ring rejects the new item and counts an overflow rather than
+// overwriting the oldest one.
+
+#include <Arduino.h>
+#include <atomic>
+
+template <typename T, uint16_t N>
+class SpscRing {
+  static_assert(N && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+public:
+  // Producer side. Safe to call from an ISR.
+  bool IRAM_ATTR push(const T &item) {
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    uint32_t used = head - _tail.load(std::memory_order_acquire);
+    if (used == N) {
+      _overflows.store(_overflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return false;
+    }
+    _items[head & (N - 1)] = item;
+    _head.store(head + 1, std::memory_order_release);
+    if (used + 1 > _peak.load(std::memory_order_relaxed))
+      _peak.store(used + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Consumer side.
+  bool pop(T &item) {
+    uint32_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail == _head.load(std::memory_order_acquire))
+      return false;
+    item = _items[tail & (N - 1)];
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side: drop everything queued so far.
+  void clear() {
+    _tail.store(_head.load(std::memory_order_acquire), std::memory_order_release);
+  }
+
+  uint32_t size() const {
+    return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+  }
+
+  // Deepest the ring has been, and items rejected because it was full
+  uint32_t peak() const {
+    return _peak.load(std::memory_order_relaxed);
+  }
+  uint32_t overflows() const {
+    return _overflows.load(std::memory_order_relaxed);
+  }
+
+private:
+  T _items[N];
+  std::atomic<uint32_t> _head{ 0 };
+  std::atomic<uint32_t> _tail{ 0 };
+  // Written by the producer only, so a plain load and store is the whole
+  // increment; atomic so the other side reads them whole
+  std::atomic<uint32_t> _peak{ 0 };
+  std::atomic<uint32_t> _overflows{ 0 };
+};
+
+#endif  // SPSC_RING_H_
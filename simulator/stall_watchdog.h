@@ -0,0 +1,232 @@
+#ifndef STALL_WATCHDOG_H_
+#define STALL_WATCHDOG_H_
+
+// Supervisor for the loop task.
+//
+// loop() calls feed() every pass. The "stallwd" task wakes every
+// STALL_CHECK_MS, and once the loop hasn't fed it for STALL_RECOVER_MS it
+// writes a StallRecord: how long the loop has been stuck, the State it
+// was in, the last STALL_EVENTS input events and a backtrace of the loop
+// task as it sits. The record lives in RTC memory that a software reset
+// leaves alone. Then:
+//
+//   the loop comes back   it finds recovering() set, prints the record
+//                         and leaves the game for the menu
+//   it doesn't            after STALL_REBOOT_MS the task restarts the
+//                         chip, and the next boot prints the record
+//
+// The task runs on the loop's core above everything else there, so when
+// it looks, the loop task is switched out and its registers are saved at
+// the top of its stack. The backtrace starts from that frame and walks
+// the stack with esp_backtrace_get_next_frame(); the PC:SP pairs are
+// printed in the "Backtrace:" format the ESP exception decoder reads.
+// Xtensa only; elsewhere the record has no backtrace.
+//
+// Only stalls after begin() count: setup()'s own waits for Wi-Fi and
+// Firestore are not watched.
+
+#include <Arduino.h>
+#include <stddef.h>
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "input_bus.h"
+#if defined(__XTENSA__)
+#include "esp_debug_helpers.h"
+#endif
+
+#define STALL_CHECK_MS 100
+#define STALL_RECOVER_MS 2000
+#define STALL_REBOOT_MS 8000
+#define STALL_EVENTS 8
+#define STALL_BACKTRACE 16
+#define STALL_MAGIC 0x53544c31  // "STL1"
+#define STALL_TASK_STACK 3072
+#define STALL_TASK_PRIORITY 5  // Above every other task on the app core
+#define STALL_TASK_CORE 1      // App core, with loop()
+
+struct StallEvent {
+  uint32_t ms;
+  uint8_t state;
+  InputSource source;
+  char key;
+  uint8_t button;
+};
+
+struct StallRecord {
+  uint32_t magic;
+  uint32_t atMs;       // Uptime when captured
+  uint32_t stalledMs;  // How long the loop had gone without feeding
+  uint8_t state;
+  bool rebooted;
+  uint8_t eventCount;
+  uint8_t depth;
+  StallEvent events[STALL_EVENTS];  // Oldest first
+  uint32_t pc[STALL_BACKTRACE];
+  uint32_t sp[STALL_BACKTRACE];
+  uint32_t checksum;
+};
+
+class StallWatchdog {
+public:
+  // Watch the calling task. `record` should be RTC_NOINIT_ATTR.
+  void begin(StallRecord &record) {
+    _record = &record;
+    _watched = xTaskGetCurrentTaskHandle();
+    _fedMs = millis();
+    xTaskCreatePinnedToCore(taskEntry, "stallwd", STALL_TASK_STACK, this, STALL_TASK_PRIORITY, &_task,
+                            STALL_TASK_CORE);
+  }
+
+  void feed(uint8_t state) {
+    _fedMs = millis();
+    _state = state;
+  }
+
+  // An input event, kept for the record
+  void event(const InputEvent &e, uint8_t state) {
+    _events[_eventCount++ % STALL_EVENTS] = StallEvent{ (uint32_t)millis(), state, e.source, e.key, e.button };
+  }
+
+  // The loop is back from a stall the task caught; clears the flag
+  bool recovering() {
+    if (!_recovering)
+      return false;
+    _recovering = false;
+    return true;
+  }
+
+  // Print the record left by a stall, this run or before the last reset,
+  // and clear it. False if there was none.
+  bool report(Print &out, const char *(*stateName)(uint8_t)) {
+    if (!_record || !valid(*_record))
+      return false;
+    const StallRecord &r = *_record;
+    out.println("--- Stall record ---");
+    out.printf("loop stalled %lu ms in %s, %lu ms after boot%s\n", (unsigned long)r.stalledMs, stateName(r.state),
+               (unsigned long)r.atMs, r.rebooted ? "; restarted" : "");
+    if (r.depth) {
+      out.print("Backtrace:");
+      for (uint8_t i = 0; i < r.depth; i++)
+        out.printf(" 0x%08lx:0x%08lx", (unsigned long)r.pc[i], (unsigned long)r.sp[i]);
+      out.println();
+    } else {
+      out.println("no backtrace on this target");
+    }
+    for (uint8_t i = 0; i < r.eventCount; i++) {
+      const StallEvent &e = r.events[i];
+      out.printf("  -%lu ms %s ", (unsigned long)(r.atMs - e.ms), inputSourceName(e.source));
+      if (e.source == INPUT_BUTTON)
+        out.printf("%u", e.button);
+      else
+        out.printf("'%c'", e.key);
+      out.printf(" in %s\n", stateName(e.state));
+    }
+    _record->magic = 0;
+    return true;
+  }
+
+private:
+  static void taskEntry(void *arg) {
+    static_cast<StallWatchdog *>(arg)->task();
+  }
+
+  void task() {
+    bool captured = false;
+    for (;;) {
+      vTaskDelay(pdMS_TO_TICKS(STALL_CHECK_MS));
+      uint32_t stalledMs = millis() - _fedMs;
+      if (stalledMs < STALL_RECOVER_MS) {
+        captured = false;
+        continue;
+      }
+      if (!captured) {
+        capture(stalledMs);
+        captured = true;
+        _recovering = true;
+      }
+      if (stalledMs >= STALL_REBOOT_MS) {
+        _record->magic = STALL_MAGIC;  // Even if the loop printed it in between
+        _record->stalledMs = stalledMs;
+        _record->rebooted = true;
+        _record->checksum = checksum(*_record);
+        esp_restart();
+      }
+    }
+  }
+
+  void capture(uint32_t stalledMs) {
+    StallRecord &r = *_record;
+    r.magic = STALL_MAGIC;
+    r.atMs = millis();
+    r.stalledMs = stalledMs;
+    r.state = _state;
+    r.rebooted = false;
+    uint32_t count = _eventCount;
+    r.eventCount = count < STALL_EVENTS ? count : STALL_EVENTS;
+    for (uint8_t i = 0; i < r.eventCount; i++)
+      r.events[i] = _events[(count - r.eventCount + i) % STALL_EVENTS];
+    r.depth = backtrace(r.pc, r.sp);
+    r.checksum = checksum(r);
+  }
+
+  // The watched task's call stack, from the registers the scheduler saved
+  // when it switched the task out
+  uint8_t backtrace(uint32_t *pc, uint32_t *sp) const {
+#if defined(__XTENSA__)
+    // A TCB starts with pxTopOfStack, which points at the saved frame: an
+    // interrupt frame (exit, pc, ps, a0, a1, ...) or, for a task that
+    // blocked, a solicited one (exit = 0, pc, ps, next, a0, a1, ...)
+    const uint32_t *saved = *(const uint32_t *const *)_watched;
+    bool solicited = saved[0] == 0;
+    esp_backtrace_frame_t frame = {};
+    frame.pc = saved[1];
+    frame.next_pc = solicited ? saved[4] : saved[3];
+    frame.sp = solicited ? saved[5] : saved[4];
+    uint8_t n = 0;
+    pc[n] = stackPc(frame.pc);
+    sp[n++] = frame.sp;
+    while (n < STALL_BACKTRACE && frame.next_pc && esp_backtrace_get_next_frame(&frame)) {
+      pc[n] = stackPc(frame.pc);
+      sp[n++] = frame.sp;
+    }
+    return n;
+#else
+    (void)pc;
+    (void)sp;
+    return 0;
+#endif
+  }
+
+  // Return addresses carry the caller's window size in their top two bits;
+  // point back at the call instruction in the instruction bus range
+  static uint32_t stackPc(uint32_t pc) {
+    if (pc & 0x80000000)
+      pc = (pc & 0x3fffffff) | 0x40000000;
+    return pc - 3;
+  }
+
+  static uint32_t checksum(const StallRecord &r) {
+    const uint8_t *bytes = (const uint8_t *)&r;
+    uint32_t h = 2166136261u;  // FNV-1a over everything before the checksum
+    for (size_t i = 0; i < offsetof(StallRecord, checksum); i++)
+      h = (h ^ bytes[i]) * 16777619u;
+    return h;
+  }
+
+  static bool valid(const StallRecord &r) {
+    return r.magic == STALL_MAGIC && r.eventCount <= STALL_EVENTS && r.depth <= STALL_BACKTRACE
+           && r.checksum == checksum(r);
+  }
+
+  StallRecord *_record = nullptr;
+  TaskHandle_t _watched = nullptr;
+  TaskHandle_t _task = nullptr;
+  volatile uint32_t _fedMs = 0;
+  volatile uint8_t _state = 0;
+  volatile bool _recovering = false;
+  StallEvent _events[STALL_EVENTS];
+  uint32_t _eventCount = 0;
+};
+
+#endif  // STALL_WATCHDOG_H_
@@ -0,0 +1,148 @@
+#ifndef STATE_MACHINE_H_
+#define STATE_MACHINE_H_
+
+// Table-driven state machine for the console's screens and games.
+//
+// Each state is one row of a constant table: its name, up to four handlers
+// and where '*' and '#' take it. The table is indexed by state, so
+// dispatch is an array lookup, and stateTableValid() lets a static_assert
+// check at compile time that every row sits at its own index and every
+// '*'/'#' target exists.
+//
+//   onEnter  draw the screen and reset whatever the state owns
+//   onEvent  an input press; '*' and '#' only reach it if the row has no
+//            target for them
+//   onTick   every loop() pass
+//   onExit   switch off what the state left running (stimuli, rings)
+//
+// A row marked idle (a menu) only waits for a press, so loop() may slow the
+// CPU down and sleep while it is current.
+//
+// Any handler may be null. go() called from inside a handler takes effect
+// when that handler returns, so a handler never runs in a state it has
+// already left. Called from anywhere else (a timeline step), it moves at
+// once.
+//
+// Handlers are plain functions and events plain structs, with no hardware
+// dependencies, so a table can be driven on a host.
+
+#include <stddef.h>
+#include <stdint.h>
+#include "input_bus.h"
+
+#define STATE_NONE 0xFF  // No transition
+
+struct StateDef {
+  uint8_t id;  // Must equal the row's index
+  const char *name;
+  void (*onEnter)();
+  void (*onEvent)(const InputEvent &event);
+  void (*onTick)();
+  void (*onExit)();
+  uint8_t onStar;     // Where '*' goes, or STATE_NONE
+  uint8_t onHash;     // Where '#' goes, or STATE_NONE
+  bool idle = false;  // Nothing timed runs here
+};
+
+template <size_t N>
+constexpr bool stateTableValid(const StateDef (&table)[N]) {
+  if (N >= STATE_NONE)
+    return false;
+  for (size_t i = 0; i < N; i++) {
+    if (table[i].id != i || !table[i].name)
+      return false;
+    if ((table[i].onStar != STATE_NONE && table[i].onStar >= N)
+        || (table[i].onHash != STATE_NONE && table[i].onHash >= N))
+      return false;
+  }
+  return true;
+}
+
+class StateMachine {
+public:
+  constexpr StateMachine(const StateDef *table, uint8_t count, uint8_t initial)
+    : _table(table), _count(count), _state(initial) {}
+
+  uint8_t state() const {
+    return _state;
+  }
+
+  bool idle() const {
+    return _table[_state].idle;
+  }
+
+  const char *name(uint8_t state) const {
+    return state < _count ? _table[state].name : "?";
+  }
+
+  // Where navigation key `key` leads from the current state, or STATE_NONE
+  uint8_t target(char key) const {
+    if (key == '*')
+      return _table[_state].onStar;
+    if (key == '#')
+      return _table[_state].onHash;
+    return STATE_NONE;
+  }
+
+  // Leave the current state for `next`, running both handlers. Re-entering
+  // the current state runs them too.
+  void go(uint8_t next) {
+    if (next >= _count)
+      return;
+    _next = next;
+    if (!_inHandler)
+      settle();
+  }
+
+  // A press: '*' and '#' follow the table, everything else goes to onEvent
+  void dispatch(const InputEvent &event) {
+    uint8_t to = event.source == INPUT_BUTTON ? STATE_NONE : target(event.key);
+    if (to != STATE_NONE) {
+      go(to);
+      return;
+    }
+    if (_table[_state].onEvent) {
+      _inHandler = true;
+      _table[_state].onEvent(event);
+      settle();
+    }
+  }
+
+  void tick() {
+    if (_table[_state].onTick) {
+      _inHandler = true;
+      _table[_state].onTick();
+      settle();
+    }
+  }
+
+  uint32_t transitions() const {
+    return _transitions;
+  }
+
+private:
+  // Apply the pending transition, and any that its handlers ask for
+  void settle() {
+    _inHandler = true;
+    while (_next != STATE_NONE) {
+      uint8_t next = _next;
+      _next = STATE_NONE;
+      if (_table[_state].onExit)
+        _table[_state].onExit();
+      _state = next;
+      _transitions++;
+      if (_table[_state].onEnter)
+        _table[_state].onEnter();
+    }
+    _inHandler = false;
+  }
+
+  const StateDef *_table;
+  uint8_t _count;
+  uint8_t _state;
+  uint8_t _next = STATE_NONE;
+  bool _inHandler = false;
+  uint32_t _transitions = 0;
+};
+
+#endif  // STATE_MACHINE_H_
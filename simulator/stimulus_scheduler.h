@@ -0,0 +1,256 @@
+#ifndef STIMULUS_SCHEDULER_H_
+#define STIMULUS_SCHEDULER_H_
+
+// Stimulus timing from esp_timer instead of loop().
+//
+// Comparing millis() in loop() switches a stimulus on or off whenever the
+// pass that notices gets there, which can be a whole screen fill late. Here
+// each stimulus's onset and offset are one-shot esp_timer deadlines. The
+// show/hide functions passed to schedule() run from the esp_timer task at
+// those moments, so they must be short: post to the LED engine and return.
+// Each transition is also pushed to a ring for loop(), which does the
+// slower work that follows (drawing the TFT, moving the game on) and reads
+// the real timestamps from it.
+//
+// The offset is timed from the planned onset, not the actual one, so
+// timer latency doesn't stretch a stimulus. Every stimulus gets a record of
+// planned and actual onset and offset, and the differences are kept as
+// jitter statistics. Reaction times should be measured from onsetUs().
+//
+// One stimulus at a time. A stimulus has an id; scheduling a new one or
+// end()ing the current one makes transitions of earlier ones stale, and
+// read() skips them. A mutex keeps the timer callbacks, schedule() and
+// end() from interleaving, so a stimulus that end() switched off can't
+// come back on. It also serialises the two places that push edges (an
+// immediate onset in schedule(), and the timer task), so the ring still
+// has one producer at a time.
+//
+// A timer firing can still be waiting on the mutex while schedule() re-arms
+// that timer for the next stimulus, and then finds the new one's phase.
+// The callbacks act only once the current stimulus's own deadline has
+// come, so such a stale firing does nothing and the re-armed timer fires
+// in its place.
+
+#include <Arduino.h>
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "spsc_ring.h"
+
+#define STIMULUS_EDGE_QUEUE_LEN 8
+#define STIMULUS_LOG_LEN 16  // Records kept for dump()
+
+typedef void (*StimulusFn)(uint8_t value);
+
+struct StimulusEdge {
+  uint32_t id;
+  uint8_t value;
+  bool on;
+  uint32_t tUs;        // When it happened
+  uint32_t plannedUs;  // When it was due
+};
+
+struct StimulusRecord {
+  uint32_t id;
+  uint8_t value;
+  bool ended;  // Cut short by end() rather than timing out
+  uint32_t plannedOnUs, onUs;
+  uint32_t plannedOffUs, offUs;
+};
+
+struct StimulusJitter {
+  uint32_t count;
+  int32_t minUs;
+  int32_t maxUs;
+  int64_t sumUs;
+
+  void add(int32_t us) {
+    if (count == 0 || us < minUs)
+      minUs = us;
+    if (count == 0 || us > maxUs)
+      maxUs = us;
+    count++;
+    sumUs += us;
+  }
+};
+
+class StimulusScheduler {
+public:
+  bool begin() {
+    _lock = xSemaphoreCreateMutex();
+    esp_timer_create_args_t args = {};
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.arg = this;
+    args.callback = onsetEntry;
+    args.name = "stim on";
+    if (esp_timer_create(&args, &_onTimer) != ESP_OK)
+      return false;
+    args.callback = offsetEntry;
+    args.name = "stim off";
+    return esp_timer_create(&args, &_offTimer) == ESP_OK;
+  }
+
+  // Show stimulus `value` at `onUs` (esp_timer time; now or in the past
+  // means immediately, from this call) for `durationUs`. Either function
+  // may be null. Ends the current stimulus first.
+  void schedule(uint8_t value, uint32_t onUs, uint32_t durationUs, StimulusFn show, StimulusFn hide) {
+    if (!_lock)
+      return;
+    end();
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _cur = StimulusRecord{ ++_nextId, value, false, onUs, 0, onUs + durationUs, 0 };
+    _liveId = _cur.id;
+    _shown = false;
+    _show = show;
+    _hide = hide;
+    _phase = WAITING;
+    int32_t wait = (int32_t)(onUs - (uint32_t)esp_timer_get_time());
+    if (wait > 0)
+      esp_timer_start_once(_onTimer, wait);
+    else
+      onset();
+    xSemaphoreGive(_lock);
+  }
+
+  // Switch the current stimulus off now (answered or abandoned). Nothing
+  // happens if it already went off.
+  void end() {
+    if (!_lock)
+      return;
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _liveId = 0;
+    if (_phase != IDLE) {
+      esp_timer_stop(_onTimer);
+      esp_timer_stop(_offTimer);
+      if (_phase == ON) {
+        _cur.offUs = (uint32_t)esp_timer_get_time();
+        _cur.ended = true;
+        if (_hide)
+          _hide(_cur.value);
+        log();
+      }
+      _phase = IDLE;
+    }
+    xSemaphoreGive(_lock);
+  }
+
+  // Next transition of the current stimulus.
+  bool read(StimulusEdge &edge) {
+    while (_edges.pop(edge)) {
+      if (edge.id == _liveId)
+        return true;
+    }
+    return false;
+  }
+
+  bool isOn() const {
+    return _phase == ON;
+  }
+  // The current stimulus has come on (and may have gone off again)
+  bool shown() const {
+    return _shown;
+  }
+  // Its actual onset
+  uint32_t onsetUs() const {
+    return _cur.onUs;
+  }
+  // Actual minus planned time, over timer-driven transitions only
+  const StimulusJitter &onsetJitter() const {
+    return _onJitter;
+  }
+  const StimulusJitter &offsetJitter() const {
+    return _offJitter;
+  }
+
+  void dump(Print &out) const {
+    out.println("--- Stimuli ---");
+    printJitter(out, "onset", _onJitter);
+    printJitter(out, "offset", _offJitter);
+    out.printf("%6s %5s %12s %8s %12s %8s %s\n", "id", "value", "on us", "late us", "off us", "late us", "");
+    uint32_t n = _logged < STIMULUS_LOG_LEN ? _logged : STIMULUS_LOG_LEN;
+    for (uint32_t i = _logged - n; i < _logged; i++) {
+      const StimulusRecord &r = _log[i % STIMULUS_LOG_LEN];
+      out.printf("%6lu %5u %12lu %8ld %12lu %8ld %s\n", (unsigned long)r.id, r.value, (unsigned long)r.onUs,
+                 (long)(int32_t)(r.onUs - r.plannedOnUs), (unsigned long)r.offUs,
+                 r.ended ? 0L : (long)(int32_t)(r.offUs - r.plannedOffUs), r.ended ? "ended" : "timed out");
+    }
+  }
+
+private:
+  enum Phase : uint8_t {
+    IDLE,
+    WAITING,  // Onset timer armed
+    ON        // Offset timer armed
+  };
+
+  static void onsetEntry(void *arg) {
+    StimulusScheduler *self = (StimulusScheduler *)arg;
+    xSemaphoreTake(self->_lock, portMAX_DELAY);
+    if (self->_phase == WAITING && due(self->_cur.plannedOnUs)) {
+      self->onset();
+      self->_onJitter.add((int32_t)(self->_cur.onUs - self->_cur.plannedOnUs));
+    }
+    xSemaphoreGive(self->_lock);
+  }
+
+  static void offsetEntry(void *arg) {
+    StimulusScheduler *self = (StimulusScheduler *)arg;
+    xSemaphoreTake(self->_lock, portMAX_DELAY);
+    if (self->_phase == ON && due(self->_cur.plannedOffUs))
+      self->offset();
+    xSemaphoreGive(self->_lock);
+  }
+
+  static bool due(uint32_t atUs) {
+    return (int32_t)((uint32_t)esp_timer_get_time() - atUs) >= 0;
+  }
+
+  // Both called with the lock held
+  void onset() {
+    if (_show)
+      _show(_cur.value);
+    _cur.onUs = (uint32_t)esp_timer_get_time();
+    _phase = ON;
+    _shown = true;
+    _edges.push(StimulusEdge{ _cur.id, _cur.value, true, _cur.onUs, _cur.plannedOnUs });
+    int32_t left = (int32_t)(_cur.plannedOffUs - _cur.onUs);
+    esp_timer_start_once(_offTimer, left > 0 ? left : 0);
+  }
+
+  void offset() {
+    if (_hide)
+      _hide(_cur.value);
+    _cur.offUs = (uint32_t)esp_timer_get_time();
+    _phase = IDLE;
+    _offJitter.add((int32_t)(_cur.offUs - _cur.plannedOffUs));
+    _edges.push(StimulusEdge{ _cur.id, _cur.value, false, _cur.offUs, _cur.plannedOffUs });
+    log();
+  }
+
+  void log() {
+    _log[_logged++ % STIMULUS_LOG_LEN] = _cur;
+  }
+
+  static void printJitter(Print &out, const char *name, const StimulusJitter &j) {
+    out.printf("%s: %lu timed, late by min %ld us, mean %ld us, max %ld us\n", name, (unsigned long)j.count,
+               (long)j.minUs, (long)(j.count ? j.sumUs / (int64_t)j.count : 0), (long)j.maxUs);
+  }
+
+  SemaphoreHandle_t _lock = nullptr;
+  esp_timer_handle_t _onTimer = nullptr;
+  esp_timer_handle_t _offTimer = nullptr;
+  volatile Phase _phase = IDLE;
+  volatile bool _shown = false;
+  StimulusRecord _cur = {};
+  StimulusFn _show = nullptr;
+  StimulusFn _hide = nullptr;
+  uint32_t _nextId = 0;
+  volatile uint32_t _liveId = 0;  // Edges of any other stimulus are stale
+  SpscRing<StimulusEdge, STIMULUS_EDGE_QUEUE_LEN> _edges;
+  StimulusJitter _onJitter = {};
+  StimulusJitter _offJitter = {};
+  StimulusRecord _log[STIMULUS_LOG_LEN] = {};
+  uint32_t _logged = 0;
+};
+
+#endif  // STIMULUS_SCHEDULER_H_
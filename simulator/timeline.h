@@ -0,0 +1,75 @@
+#ifndef TIMELINE_H_
+#define TIMELINE_H_
+
+// Non-blocking sequencer for timed screen and LED steps.
+//
+// Instead of draw(); delay(2000); draw();, queue the steps:
+//
+//   showCenteredStarsAndScore(stars);
+//   timeline.after(2000, stepEnter, MENU);
+//
+// tick() runs every step whose time has come and returns immediately, so
+// loop() keeps polling input while a sequence plays. Delays are minimum
+// hold times measured from when the previous step actually ran, so a slow
+// loop pass stretches a step rather than skipping the next one. cancel()
+// drops everything still queued.
+
+#include <Arduino.h>
+
+#define TIMELINE_MAX_STEPS 32
+
+class Timeline {
+public:
+  typedef void (*StepFn)(uint8_t arg);
+
+  // Queue fn(arg) to run delayMs after the previous step. A null fn just
+  // holds the timeline busy for delayMs. Returns false if the queue is full.
+  bool after(uint32_t delayMs, StepFn fn = nullptr, uint8_t arg = 0) {
+    if (_count == TIMELINE_MAX_STEPS)
+      return false;
+    if (_count == 0)
+      _lastRun = millis();
+    Step &step = _steps[(_head + _count) % TIMELINE_MAX_STEPS];
+    step.delayMs = delayMs;
+    step.fn = fn;
+    step.arg = arg;
+    _count++;
+    return true;
+  }
+
+  void tick(uint32_t now) {
+    while (_count > 0) {
+      Step step = _steps[_head];
+      if (now - _lastRun < step.delayMs)
+        return;
+      _head = (_head + 1) % TIMELINE_MAX_STEPS;
+      _count--;
+      _lastRun = now;
+      // The step may queue more steps or cancel the rest.
+      if (step.fn)
+        step.fn(step.arg);
+    }
+  }
+
+  void cancel() {
+    _count = 0;
+  }
+
+  bool busy() const {
+    return _count > 0;
+  }
+
+private:
+  struct Step {
+    uint32_t delayMs;
+    StepFn fn;
+    uint8_t arg;
+  };
+
+  Step _steps[TIMELINE_MAX_STEPS];
+  uint8_t _head = 0;
+  uint8_t _count = 0;
+  uint32_t _lastRun = 0;
+};
+
+#endif  // TIMELINE_H_
@@ -0,0 +1,181 @@
+#ifndef TOUCH_FT6206_H_
+#define TOUCH_FT6206_H_
+
+// Driver for the FT6206 capacitive touch controller on the cap-touch
+// ILI9341 panel (I2C address 0x38).
+//
+// The controller pulls INT low while a finger is down. The ISR only stamps
+// the time and wakes a sampling task; the task reads the first touch point
+// over I2C every TOUCH_SAMPLE_MS until the finger lifts and pushes
+// TouchSample records into a FreeRTOS queue. loop() drains the queue with
+// read() and never touches I2C itself. The first sample of a touch carries
+// the INT edge time, so latency can be measured from the moment the finger
+// landed rather than from when the task got around to it.
+//
+// With intPin < 0 (Wokwi's panel has no INT pin) the task polls instead.
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "touch_gesture.h"
+
+#define FT6206_ADDR 0x38
+#define FT6206_REG_TD_STATUS 0x02
+#define FT6206_REG_THRESHOLD 0x80
+#define FT6206_REG_CHIPID 0xA3
+#define FT6206_REG_GMODE 0xA4
+#define FT6206_REG_VENDID 0xA8
+#define FT6206_VENDID 0x11
+
+#define TOUCH_QUEUE_LEN 32
+#define TOUCH_SAMPLE_MS 10  // While a finger is down
+#define TOUCH_POLL_MS 20    // Waiting for a touch without an INT line
+#define TOUCH_THRESHOLD 40
+#define TOUCH_TASK_STACK 3072
+#define TOUCH_TASK_PRIORITY 2
+#define TOUCH_TASK_CORE 1  // App core, with loop()
+
+class Ft6206Touch {
+public:
+  // Returns false if no controller answers; touch then stays disabled.
+  bool begin(int8_t sda, int8_t scl, int8_t intPin, uint16_t width, uint16_t height) {
+    _intPin = intPin;
+    _width = width;
+    _height = height;
+    Wire.begin(sda, scl, 400000);
+    uint8_t vendor = 0;
+    if (!readRegs(FT6206_REG_VENDID, &vendor, 1) || vendor != FT6206_VENDID)
+      return false;
+    writeReg(FT6206_REG_THRESHOLD, TOUCH_THRESHOLD);
+    writeReg(FT6206_REG_GMODE, 0);  // INT held low for as long as the panel is touched
+
+    _queue = xQueueCreate(TOUCH_QUEUE_LEN, sizeof(TouchSample));
+    if (!_queue)
+      return false;
+    xTaskCreatePinnedToCore(taskEntry, "touch", TOUCH_TASK_STACK, this, TOUCH_TASK_PRIORITY, &_task, TOUCH_TASK_CORE);
+    if (_intPin >= 0) {
+      pinMode(_intPin, INPUT);
+      attachInterruptArg(digitalPinToInterrupt(_intPin), onInt, this, FALLING);
+    }
+    return true;
+  }
+
+  // Next queued sample, without blocking.
+  bool read(TouchSample &s) {
+    return _queue && xQueueReceive(_queue, &s, 0) == pdTRUE;
+  }
+
+  // The INT line, if it can wake the chip from light sleep, or -1
+  int8_t wakePin() const {
+    return _task ? _intPin : -1;
+  }
+
+  // Around a light sleep, while the INT line is a wake source. A finger
+  // still down on waking is sampled at once.
+  void sleep() {
+    if (wakePin() >= 0)
+      detachInterrupt(digitalPinToInterrupt(_intPin));
+  }
+  void wake() {
+    if (wakePin() < 0)
+      return;
+    attachInterruptArg(digitalPinToInterrupt(_intPin), onInt, this, FALLING);
+    if (digitalRead(_intPin) == LOW) {
+      _edgeUs = (uint32_t)esp_timer_get_time();
+      xTaskNotifyGive(_task);
+    }
+  }
+
+  // Samples lost because loop() fell behind by more than TOUCH_QUEUE_LEN.
+  uint32_t dropped() const {
+    return _dropped;
+  }
+
+private:
+  static void IRAM_ATTR onInt(void *arg) {
+    Ft6206Touch *self = (Ft6206Touch *)arg;
+    self->_edgeUs = (uint32_t)esp_timer_get_time();
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(self->_task, &woken);
+    portYIELD_FROM_ISR(woken);
+  }
+
+  static void taskEntry(void *arg) {
+    ((Ft6206Touch *)arg)->run();
+  }
+
+  void run() {
+    bool down = false;
+    for (;;) {
+      if (down)
+        vTaskDelay(pdMS_TO_TICKS(TOUCH_SAMPLE_MS));
+      else if (_intPin >= 0)
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      else
+        vTaskDelay(pdMS_TO_TICKS(TOUCH_POLL_MS));
+
+      uint16_t x, y;
+      bool touched;
+      if (!readPoint(x, y, touched))
+        continue;
+      uint32_t now = (uint32_t)esp_timer_get_time();
+      if (touched) {
+        push(TouchSample{ (down || _intPin < 0) ? now : _edgeUs, x, y, true });
+        down = true;
+      } else if (down) {
+        push(TouchSample{ now, 0, 0, false });
+        down = false;
+      }
+    }
+  }
+
+  bool readPoint(uint16_t &x, uint16_t &y, bool &touched) {
+    uint8_t buf[5];  // TD_STATUS, P1_XH, P1_XL, P1_YH, P1_YL
+    if (!readRegs(FT6206_REG_TD_STATUS, buf, sizeof(buf)))
+      return false;
+    uint8_t points = buf[0] & 0x0F;
+    touched = points >= 1 && points <= 2;
+    // The panel's origin is the opposite corner from the display's.
+    uint16_t rawX = ((buf[1] & 0x0F) << 8) | buf[2];
+    uint16_t rawY = ((buf[3] & 0x0F) << 8) | buf[4];
+    x = rawX < _width ? _width - 1 - rawX : 0;
+    y = rawY < _height ? _height - 1 - rawY : 0;
+    return true;
+  }
+
+  void push(const TouchSample &s) {
+    if (xQueueSend(_queue, &s, 0) != pdTRUE)
+      _dropped++;
+  }
+
+  bool readRegs(uint8_t reg, uint8_t *buf, uint8_t len) {
+    Wire.beginTransmission(FT6206_ADDR);
+    Wire.write(reg);
+    if (Wire.endTransmission(false) != 0)
+      return false;
+    if (Wire.requestFrom((uint8_t)FT6206_ADDR, len) != len)
+      return false;
+    for (uint8_t i = 0; i < len; i++)
+      buf[i] = Wire.read();
+    return true;
+  }
+
+  void writeReg(uint8_t reg, uint8_t value) {
+    Wire.beginTransmission(FT6206_ADDR);
+    Wire.write(reg);
+    Wire.write(value);
+    Wire.endTransmission();
+  }
+
+  int8_t _intPin = -1;
+  uint16_t _width = 0, _height = 0;
+  QueueHandle_t _queue = nullptr;
+  TaskHandle_t _task = nullptr;
+  volatile uint32_t _edgeUs = 0;
+  uint32_t _dropped = 0;
+};
+
+#endif  // TOUCH_FT6206_H_
@@ -0,0 +1,195 @@
+#ifndef TOUCH_GESTURE_H_
+#define TOUCH_GESTURE_H_
+
+// Touch gestures and touch-to-key mapping.
+//
+// GestureRecognizer turns a stream of timestamped touch samples into taps,
+// swipes and long presses. It has no hardware dependencies so recorded
+// traces can be replayed on a host (host/touch_replay.cpp).
+//
+//   tap         down and up within TOUCH_TAP_MAX_US, never moving more
+//               than TOUCH_SLOP_PX from where it started
+//   long press  held still for TOUCH_LONG_PRESS_US; fires while still down
+//               (from poll()), and the release then produces nothing
+//   swipe       released at least TOUCH_SWIPE_MIN_PX from the start, within
+//               TOUCH_SWIPE_MAX_US; direction is the dominant axis
+//
+// TouchMap holds the tappable areas of the current screen and the key each
+// one stands for, so a tap is handled exactly like that keypad key. The
+// renderers write it on the display task while the loop reads it, so a
+// sequence number brackets each rewrite (begin() to end()): odd while one
+// is under way, and keyAt() finds nothing then rather than half a map.
+
+#include <atomic>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define TOUCH_SLOP_PX 12
+#define TOUCH_TAP_MAX_US 500000
+#define TOUCH_LONG_PRESS_US 600000
+#define TOUCH_SWIPE_MIN_PX 40
+#define TOUCH_SWIPE_MAX_US 800000
+#define TOUCH_MAP_MAX_TARGETS 12
+
+struct TouchSample {
+  uint32_t tUs;
+  uint16_t x;
+  uint16_t y;
+  bool down;
+};
+
+enum GestureType : uint8_t {
+  GESTURE_NONE,
+  GESTURE_TAP,
+  GESTURE_LONG_PRESS,
+  GESTURE_SWIPE_LEFT,
+  GESTURE_SWIPE_RIGHT,
+  GESTURE_SWIPE_UP,
+  GESTURE_SWIPE_DOWN
+};
+
+inline const char *gestureName(GestureType type) {
+  switch (type) {
+    case GESTURE_TAP: return "tap";
+    case GESTURE_LONG_PRESS: return "long";
+    case GESTURE_SWIPE_LEFT: return "left";
+    case GESTURE_SWIPE_RIGHT: return "right";
+    case GESTURE_SWIPE_UP: return "up";
+    case GESTURE_SWIPE_DOWN: return "down";
+    default: return "none";
+  }
+}
+
+struct Gesture {
+  GestureType type;
+  uint16_t x;       // Where the finger went down
+  uint16_t y;
+  uint32_t downUs;  // Timestamp of the first sample
+  uint32_t atUs;    // Timestamp of the sample (or poll) that completed it
+};
+
+class GestureRecognizer {
+public:
+  // Feed one sample; returns true and fills `out` if it completes a gesture.
+  bool feed(const TouchSample &s, Gesture &out) {
+    if (s.down) {
+      if (!_down) {
+        _down = true;
+        _moved = false;
+        _longFired = false;
+        _x0 = s.x;
+        _y0 = s.y;
+        _t0 = s.tUs;
+      }
+      if (abs((int)s.x - _x0) > TOUCH_SLOP_PX || abs((int)s.y - _y0) > TOUCH_SLOP_PX)
+        _moved = true;
+      _x = s.x;
+      _y = s.y;
+      return poll(s.tUs, out);
+    }
+
+    if (!_down)
+      return false;
+    _down = false;
+    if (_longFired)
+      return false;
+    // The controller reports no position on release; use the last one seen.
+    int dx = (int)_x - _x0, dy = (int)_y - _y0;
+    int dist = abs(dx) > abs(dy) ? abs(dx) : abs(dy);
+    uint32_t held = s.tUs - _t0;
+    if (dist >= TOUCH_SWIPE_MIN_PX && held <= TOUCH_SWIPE_MAX_US) {
+      GestureType type;
+      if (abs(dx) >= abs(dy))
+        type = dx < 0 ? GESTURE_SWIPE_LEFT : GESTURE_SWIPE_RIGHT;
+      else
+        type = dy < 0 ? GESTURE_SWIPE_UP : GESTURE_SWIPE_DOWN;
+      return emit(type, s.tUs, out);
+    }
+    if (!_moved && held <= TOUCH_TAP_MAX_US)
+      return emit(GESTURE_TAP, s.tUs, out);
+    return false;
+  }
+
+  // Call regularly while no samples arrive; reports a long press once the
+  // finger has been still for long enough.
+  bool poll(uint32_t nowUs, Gesture &out) {
+    if (_down && !_moved && !_longFired && nowUs - _t0 >= TOUCH_LONG_PRESS_US) {
+      _longFired = true;
+      return emit(GESTURE_LONG_PRESS, nowUs, out);
+    }
+    return false;
+  }
+
+  bool touching() const {
+    return _down;
+  }
+
+private:
+  bool emit(GestureType type, uint32_t atUs, Gesture &out) {
+    out = Gesture{ type, _x0, _y0, _t0, atUs };
+    return true;
+  }
+
+  bool _down = false;
+  bool _moved = false;
+  bool _longFired = false;
+  uint16_t _x0 = 0, _y0 = 0, _x = 0, _y = 0;
+  uint32_t _t0 = 0;
+};
+
+class TouchMap {
+public:
+  // Start the target list for a screen. Targets only answer while the game
+  // is in `owner`, so a screen that registers none can't inherit stale ones.
+  void begin(uint8_t owner) {
+    _seq.store(_seq.load(std::memory_order_relaxed) | 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _owner = owner;
+    _count = 0;
+  }
+
+  // The targets added since begin() are the map
+  void end() {
+    _seq.store((_seq.load(std::memory_order_relaxed) | 1) + 1, std::memory_order_release);
+  }
+
+  void add(int16_t x, int16_t y, int16_t w, int16_t h, char key) {
+    if (_count < TOUCH_MAP_MAX_TARGETS)
+      _targets[_count++] = Target{ x, y, w, h, key };
+  }
+
+  // Key for a tap at (x, y) while in `state`, or 0 if nothing is there.
+  char keyAt(uint8_t state, int16_t x, int16_t y) const {
+    for (;;) {
+      uint32_t seq = _seq.load(std::memory_order_acquire);
+      if (seq & 1)
+        return 0;  // Being rewritten for the next screen
+      char key = 0;
+      if (state == _owner) {
+        for (uint8_t i = 0; i < _count && i < TOUCH_MAP_MAX_TARGETS; i++) {
+          const Target &t = _targets[i];
+          if (x >= t.x && x < t.x + t.w && y >= t.y && y < t.y + t.h) {
+            key = t.key;
+            break;
+          }
+        }
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (_seq.load(std::memory_order_relaxed) == seq)
+        return key;
+    }
+  }
+
+private:
+  struct Target {
+    int16_t x, y, w, h;
+    char key;
+  };
+
+  Target _targets[TOUCH_MAP_MAX_TARGETS];
+  uint8_t _count = 0;
+  uint8_t _owner = 0xFF;
+  std::atomic<uint32_t> _seq{ 0 };
+};
+
+#endif  // TOUCH_GESTURE_H_